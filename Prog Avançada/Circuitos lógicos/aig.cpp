@@ -0,0 +1,404 @@
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include "aig.h"
+
+using namespace std;
+
+/// ***********************
+/// Inicializacao
+/// ***********************
+
+Aig::Aig(): Nin(0), f0(), f1(), nivel(), saida(), tabela(16, 0) {}
+
+void Aig::clear(unsigned NI)
+{
+  Nin = NI;
+  f0.clear();
+  f1.clear();
+  nivel.assign(NI, 0);
+  saida.clear();
+  tabela.assign(16, 0);
+}
+
+bool Aig::converter(const Netlist& N)
+{
+  clear();
+  if (!N.getRealim().empty()) return false;
+  clear(N.getNumInputs());
+
+  // lit[s]: o literal que corresponde ao sinal s da netlist
+  vector<uint32_t> lit(N.getNumSinais());
+  for (unsigned i=0; i<Nin; i++) lit[i] = literal(i, false);
+  vector<uint32_t> in, prox;
+  // Sem realimentacao, cada componente tem uma unica porta, em ordem topologica
+  for (unsigned c=0; c<N.getNumComponentes(); c++)
+  {
+    unsigned p = N.getPortasComponente(c)[0];
+    tipoPorta T = N.getTipo(p);
+    in.clear();
+    for (unsigned j=0; j<N.getNumFanin(p); j++) in.push_back(lit[N.getFanin(p)[j]]);
+    // As entradas sao combinadas duas a duas (arvore balanceada)
+    while (in.size() > 1)
+    {
+      prox.clear();
+      for (unsigned j=0; j+1<in.size(); j+=2)
+      {
+        switch (T)
+        {
+        case tipoPorta::AN: case tipoPorta::NA: prox.push_back(e(in[j], in[j+1])); break;
+        case tipoPorta::OR: case tipoPorta::NO: prox.push_back(ou(in[j], in[j+1])); break;
+        default: prox.push_back(xou(in[j], in[j+1])); break;
+        }
+      }
+      if (in.size()%2 == 1) prox.push_back(in.back());
+      in.swap(prox);
+    }
+    bool negada = (T==tipoPorta::NT || T==tipoPorta::NA || T==tipoPorta::NO || T==tipoPorta::NX);
+    lit[N.getNumInputs()+p] = (negada ? negar(in[0]) : in[0]);
+  }
+  for (unsigned j=0; j<N.getNumOutputs(); j++) adicionarSaida(lit[N.getSaida(j)]);
+  // As portas que nao alcancam nenhuma saida nao sao necessarias
+  compactar();
+  return true;
+}
+
+/// ***********************
+/// Construcao
+/// ***********************
+
+// Espalhamento das duas entradas de um no AND
+static inline size_t espalharAnd(uint32_t A, uint32_t B)
+{
+  uint64_t h = (uint64_t(A) << 32 | B) * 0x9E3779B97F4A7C15ull;
+  return size_t(h ^ (h >> 29));
+}
+
+void Aig::refazerTabela(size_t Tam)
+{
+  tabela.assign(Tam, 0);
+  const size_t mascara = tabela.size()-1;
+  for (unsigned k=0; k<f0.size(); k++)
+  {
+    size_t pos = espalharAnd(f0[k], f1[k]) & mascara;
+    while (tabela[pos] != 0) pos = (pos+1) & mascara;
+    tabela[pos] = k+1;
+  }
+}
+
+void Aig::compactar()
+{
+  const unsigned NN = getNumNos();
+  // Como os nos estao em ordem topologica, basta um percurso de tras para frente
+  vector<uint8_t> usado(NN, 0);
+  for (unsigned j=0; j<saida.size(); j++) usado[no(saida[j])] = 1;
+  for (unsigned n=NN; n-- > Nin; )
+  {
+    if (usado[n]) usado[no(f0[n-Nin])] = usado[no(f1[n-Nin])] = 1;
+  }
+  // Os nos usados mantem a ordem relativa: as entradas continuam com f0 < f1
+  vector<uint32_t> novoNo(NN);
+  for (unsigned i=0; i<Nin; i++) novoNo[i] = i;
+  unsigned K = 0;
+  for (unsigned n=Nin; n<NN; n++)
+  {
+    if (!usado[n]) continue;
+    const unsigned k = n-Nin;
+    novoNo[n] = Nin+K;
+    f0[K] = literal(novoNo[no(f0[k])], negado(f0[k]));
+    f1[K] = literal(novoNo[no(f1[k])], negado(f1[k]));
+    nivel[Nin+K] = nivel[n];
+    K++;
+  }
+  f0.resize(K);
+  f1.resize(K);
+  nivel.resize(Nin+K);
+  for (unsigned j=0; j<saida.size(); j++) saida[j] = literal(novoNo[no(saida[j])], negado(saida[j]));
+  size_t Tam = 16;
+  while (Tam < 2*size_t(K+1)) Tam *= 2;
+  refazerTabela(Tam);
+}
+
+uint32_t Aig::novoAnd(uint32_t A, uint32_t B)
+{
+  f0.push_back(A);
+  f1.push_back(B);
+  nivel.push_back(1 + max(nivel[no(A)], nivel[no(B)]));
+  return literal(Nin+f0.size()-1, false);
+}
+
+uint32_t Aig::e(uint32_t A, uint32_t B)
+{
+  if (A > B) swap(A, B);
+  // Idempotencia: a.a = a
+  if (A == B) return A;
+  // a.~a NAO eh FALSE se a for UNDEF: eh criado um no normalmente
+
+  // Absorcao (um nivel): x.(x.z) = x.z e x.~(~x.z) = x
+  const uint32_t X[2] = {A, B}, Y[2] = {B, A};
+  for (unsigned k=0; k<2; k++)
+  {
+    uint32_t x = X[k], y = Y[k];
+    if (no(y) < Nin) continue;
+    unsigned m = no(y)-Nin;
+    if (!negado(y) && (f0[m]==x || f1[m]==x)) return y;
+    if (negado(y) && (f0[m]==negar(x) || f1[m]==negar(x))) return x;
+  }
+
+  // Hash estrutural
+  if (2*(f0.size()+1) > tabela.size()) refazerTabela(2*tabela.size());
+  const size_t mascara = tabela.size()-1;
+  size_t pos = espalharAnd(A, B) & mascara;
+  while (tabela[pos] != 0)
+  {
+    unsigned m = tabela[pos]-1;
+    if (f0[m]==A && f1[m]==B) return literal(Nin+m, false);
+    pos = (pos+1) & mascara;
+  }
+  uint32_t L = novoAnd(A, B);
+  tabela[pos] = f0.size();
+  return L;
+}
+
+uint32_t Aig::xou(uint32_t A, uint32_t B)
+{
+  // a^b = a.~b + ~a.b, valido tambem com UNDEF: se a ou b for UNDEF, as duas
+  // parcelas sao UNDEF ou FALSE, e ao menos uma eh UNDEF
+  return ou(e(A, negar(B)), e(negar(A), B));
+}
+
+/// ***********************
+/// Reescrita
+/// ***********************
+
+void Aig::reescrever(unsigned MaxPassadas)
+{
+  compactar();
+  for (unsigned passada=0; passada<MaxPassadas; passada++)
+  {
+    const unsigned NN = getNumNos();
+
+    ///NOS INTERNOS DAS SUPERPORTAS
+    // Um no AND eh interno se tem um unico uso e esse uso eh uma entrada nao
+    // negada de outro no AND; os demais sao raizes de superportas
+    // (depois de compactar, todos os nos alcancam alguma saida)
+    vector<uint32_t> usos(NN, 0), usosPositivos(NN, 0);
+    for (unsigned j=0; j<saida.size(); j++) usos[no(saida[j])]++;
+    for (unsigned n=Nin; n<NN; n++)
+    {
+      const uint32_t L[2] = {f0[n-Nin], f1[n-Nin]};
+      for (unsigned k=0; k<2; k++)
+      {
+        usos[no(L[k])]++;
+        if (!negado(L[k])) usosPositivos[no(L[k])]++;
+      }
+    }
+
+    ///RECONSTRUCAO BALANCEADA
+    Aig novo;
+    novo.clear(Nin);
+    vector<uint32_t> mapa(NN);
+    for (unsigned i=0; i<Nin; i++) mapa[i] = literal(i, false);
+    vector<uint32_t> pilha, folhas;
+    // Fila de prioridade pelo nivel (o menor nivel primeiro)
+    typedef pair<uint32_t,uint32_t> NivelLiteral;
+    priority_queue< NivelLiteral, vector<NivelLiteral>, greater<NivelLiteral> > fila;
+    for (unsigned n=Nin; n<NN; n++)
+    {
+      if (usos[n]==1 && usosPositivos[n]==1) continue;
+
+      // As folhas da superporta de raiz n (jah reconstruidas: vem antes de n)
+      folhas.clear();
+      pilha.assign(1, literal(n, false));
+      while (!pilha.empty())
+      {
+        uint32_t L = pilha.back();
+        pilha.pop_back();
+        unsigned m = no(L);
+        if (m>=Nin && !negado(L) && (m==n || (usos[m]==1 && usosPositivos[m]==1)))
+        {
+          pilha.push_back(f0[m-Nin]);
+          pilha.push_back(f1[m-Nin]);
+        }
+        else folhas.push_back(mapa[m] ^ (L&1));
+      }
+      // Idempotencia: folhas repetidas
+      sort(folhas.begin(), folhas.end());
+      folhas.erase(unique(folhas.begin(), folhas.end()), folhas.end());
+      for (unsigned k=0; k<folhas.size(); k++) fila.push(NivelLiteral(novo.nivel[no(folhas[k])], folhas[k]));
+      while (fila.size() > 1)
+      {
+        uint32_t A = fila.top().second;
+        fila.pop();
+        uint32_t B = fila.top().second;
+        fila.pop();
+        uint32_t L = novo.e(A, B);
+        fila.push(NivelLiteral(novo.nivel[no(L)], L));
+      }
+      mapa[n] = fila.top().second;
+      fila.pop();
+    }
+    for (unsigned j=0; j<saida.size(); j++) novo.adicionarSaida(mapa[no(saida[j])] ^ (saida[j]&1));
+
+    // A absorcao pode deixar sem uso nos criados antes na reconstrucao
+    novo.compactar();
+
+    ///ACEITA A PASSADA SE MELHOROU
+    unsigned prof = getProfundidade(), novaProf = novo.getProfundidade();
+    bool melhor = novo.getNumAnds() <= getNumAnds() && novaProf <= prof &&
+                  (novo.getNumAnds() < getNumAnds() || novaProf < prof);
+    if (!melhor) break;
+    *this = std::move(novo);
+  }
+}
+
+unsigned Aig::getProfundidade() const
+{
+  unsigned P = 0;
+  for (unsigned j=0; j<saida.size(); j++) P = max(P, nivel[no(saida[j])]);
+  return P;
+}
+
+/// ***********************
+/// Conversao para netlist
+/// ***********************
+
+void Aig::gerarNetlist(std::vector<uint8_t>& Tipos, std::vector<uint32_t>& FaninIni,
+                       std::vector<uint32_t>& Fanin, std::vector<uint32_t>& Saidas) const
+{
+  const unsigned NN = getNumNos();
+  Tipos.clear();
+  FaninIni.assign(1, 0);
+  Fanin.clear();
+  Saidas.clear();
+
+  ///POLARIDADES NECESSARIAS DE CADA NO
+  // Bit 0: o valor do no; bit 1: o valor negado do no
+  // Um no AND com as duas entradas de mesma polaridade gera qualquer uma das suas
+  // polaridades com uma unica porta (AN, NA, NO ou OR); com as entradas de
+  // polaridades diferentes, precisa da entrada negada como sinal
+  vector<uint8_t> precisa(NN, 0);
+  for (unsigned j=0; j<saida.size(); j++) precisa[no(saida[j])] |= (negado(saida[j]) ? 2 : 1);
+  for (unsigned n=NN; n-- > Nin; )
+  {
+    if (!precisa[n]) continue;
+    uint32_t A = f0[n-Nin], B = f1[n-Nin];
+    if (negado(A) == negado(B))
+    {
+      precisa[no(A)] |= 1;
+      precisa[no(B)] |= 1;
+    }
+    else
+    {
+      precisa[no(A)] |= (negado(A) ? 2 : 1);
+      precisa[no(B)] |= (negado(B) ? 2 : 1);
+    }
+  }
+
+  ///PORTAS
+  // sinal[2*n+C]: o sinal da netlist com o valor do literal 2*n+C
+  vector<uint32_t> sinal(2*NN, 0);
+  auto novaPorta = [&](tipoPorta T, uint32_t S0, uint32_t S1, unsigned NumIn) {
+    Tipos.push_back(uint8_t(T));
+    Fanin.push_back(S0);
+    if (NumIn == 2) Fanin.push_back(S1);
+    FaninIni.push_back(Fanin.size());
+    return uint32_t(Nin + Tipos.size()-1);
+  };
+  for (unsigned i=0; i<Nin; i++)
+  {
+    sinal[literal(i, false)] = i;
+    if (precisa[i] & 2) sinal[literal(i, true)] = novaPorta(tipoPorta::NT, i, 0, 1);
+  }
+  for (unsigned n=Nin; n<NN; n++)
+  {
+    uint32_t A = f0[n-Nin], B = f1[n-Nin];
+    // Entradas de mesma polaridade: as portas usam os nos sem negacao
+    bool mesma = (negado(A) == negado(B));
+    uint32_t SA = sinal[mesma ? (A&~1u) : A], SB = sinal[mesma ? (B&~1u) : B];
+    bool negadas = mesma && negado(A);
+    if (precisa[n] & 1) sinal[literal(n, false)] = novaPorta(negadas ? tipoPorta::NO : tipoPorta::AN, SA, SB, 2);
+    if (precisa[n] & 2) sinal[literal(n, true)] = novaPorta(negadas ? tipoPorta::OR : tipoPorta::NA, SA, SB, 2);
+  }
+  for (unsigned j=0; j<saida.size(); j++) Saidas.push_back(sinal[saida[j]]);
+
+  // O circuito precisa de ao menos uma porta
+  Netlist::garantirPorta(Nin, Tipos, FaninIni, Fanin, Saidas);
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+void Aig::prepararEstado(EstadoNetlist& E, unsigned W) const
+{
+  E = EstadoNetlist();
+  E.valor.assign(getNumNos(), bool3S::UNDEF);
+  E.W = W;
+  E.val.assign(size_t(getNumNos())*W, 0);
+  E.def.assign(size_t(getNumNos())*W, 0);
+}
+
+// O valor de um literal, a partir dos valores V de todos os nos
+static inline bool3S valorLiteral(const bool3S* V, uint32_t L)
+{
+  bool3S x = V[Aig::no(L)];
+  return Aig::negado(L) ? ~x : x;
+}
+
+void Aig::simular(EstadoNetlist& E) const
+{
+  bool3S* V = E.valor.data();
+  for (unsigned k=0; k<f0.size(); k++)
+  {
+    V[Nin+k] = valorLiteral(V, f0[k]) & valorLiteral(V, f1[k]);
+  }
+}
+
+bool3S Aig::getValorSaida(const EstadoNetlist& E, unsigned J) const
+{
+  return valorLiteral(E.valor.data(), saida[J]);
+}
+
+void Aig::simularBloco(EstadoNetlist& E) const
+{
+  const unsigned W = E.W;
+  uint64_t* val = E.val.data();
+  uint64_t* def = E.def.data();
+  for (unsigned k=0; k<f0.size(); k++)
+  {
+    const uint32_t A = f0[k], B = f1[k];
+    // Mascaras de negacao: todos os bits 1 se a aresta for negada
+    const uint64_t nA = -uint64_t(A&1), nB = -uint64_t(B&1);
+    const uint64_t *vA = val+size_t(no(A))*W, *dA = def+size_t(no(A))*W;
+    const uint64_t *vB = val+size_t(no(B))*W, *dB = def+size_t(no(B))*W;
+    uint64_t *vO = val+size_t(Nin+k)*W, *dO = def+size_t(Nin+k)*W;
+    for (unsigned w=0; w<W; w++)
+    {
+      // Os planos TRUE (t) e FALSE (f) de cada entrada, jah com a negacao
+      uint64_t tA = (vA[w]^nA) & dA[w], fA = dA[w] & ~tA;
+      uint64_t tB = (vB[w]^nB) & dB[w], fB = dB[w] & ~tB;
+      uint64_t t = tA & tB;
+      vO[w] = t;
+      dO[w] = t | fA | fB;
+    }
+  }
+}
+
+void Aig::lerSaidasBloco(const EstadoNetlist& E, std::vector<uint64_t>& val_out,
+                         std::vector<uint64_t>& def_out) const
+{
+  const unsigned W = E.W;
+  val_out.resize(size_t(W)*saida.size());
+  def_out.resize(size_t(W)*saida.size());
+  for (unsigned j=0; j<saida.size(); j++)
+  {
+    const uint64_t n = -uint64_t(saida[j]&1);
+    const uint64_t *v = E.val.data()+size_t(no(saida[j]))*W, *d = E.def.data()+size_t(no(saida[j]))*W;
+    for (unsigned w=0; w<W; w++)
+    {
+      val_out[j*W+w] = (v[w]^n) & d[w];
+      def_out[j*W+w] = d[w];
+    }
+  }
+}
@@ -0,0 +1,169 @@
+#ifndef _AIG_H_
+#define _AIG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bool3S.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// AIG (AND-INVERTER GRAPH)
+/// Representacao de um circuito combinacional com um unico tipo de no, o AND de
+/// duas entradas, e inversores nas arestas (arestas complementadas).
+///
+/// Os nos sao numerados de forma contigua: 0 a Nin-1 sao as entradas do circuito
+/// e Nin+k eh o k-esimo no AND. Uma aresta eh um literal: 2*No+C, em que C=1
+/// indica que o valor do no eh negado. Os nos AND sempre vem depois das suas
+/// entradas (ordem topologica). Nao ha no constante: nenhuma regra de reescrita
+/// produz constantes (ver abaixo).
+///
+/// As portas do circuito sao convertidas por De Morgan: NA = ~AN, OR = ~AN(~,~),
+/// NO = AN(~,~), XO(a,b) = ~AN(~AN(a,~b),~AN(~a,b)), NX = ~XO. Todas essas
+/// identidades valem na logica de 3 estados (UNDEF inclusive), de modo que o AIG
+/// tem as mesmas saidas do circuito para qualquer combinacao de entrada.
+///
+/// A reescrita usa somente regras validas na logica de 3 estados, que eh um
+/// reticulado distributivo com De Morgan, mas SEM as leis do complemento
+/// (a.~a eh UNDEF, e nao FALSE, quando a eh UNDEF):
+/// - idempotencia: a.a = a
+/// - absorcao: a.(a.b) = a.b e a.~(~a.b) = a.(a+~b) = a
+/// - associatividade e comutatividade (balanceamento)
+/// - hash estrutural: dois nos com as mesmas entradas sao o mesmo no
+/// ###########################################################################
+
+class Aig {
+private:
+  // Numero de entradas do circuito
+  unsigned Nin;
+  // As entradas (literais) dos nos AND: o no Nin+k eh f0[k] AND f1[k], f0[k] < f1[k]
+  std::vector<uint32_t> f0, f1;
+  // O nivel de cada no (0 para as entradas do circuito)
+  std::vector<uint32_t> nivel;
+  // Os literais das saidas do circuito
+  std::vector<uint32_t> saida;
+  // Tabela de espalhamento (enderecamento aberto) dos nos AND, para o hash
+  // estrutural: guarda k+1 (0: posicao livre)
+  std::vector<uint32_t> tabela;
+
+  // Redimensiona a tabela de espalhamento para Tam posicoes (potencia de 2) e
+  // reinsere todos os nos
+  void refazerTabela(size_t Tam);
+  // Elimina os nos que nao alcancam nenhuma saida, renumerando os demais
+  void compactar();
+  // Cria um no AND com as entradas A e B (A < B), sem aplicar as regras
+  uint32_t novoAnd(uint32_t A, uint32_t B);
+
+public:
+  /// ***********************
+  /// Literais
+  /// ***********************
+
+  static uint32_t literal(unsigned No, bool Negado) {return 2*No + (Negado ? 1 : 0);}
+  static unsigned no(uint32_t L) {return L>>1;}
+  static bool negado(uint32_t L) {return (L&1) != 0;}
+  static uint32_t negar(uint32_t L) {return L^1;}
+
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  // Cria um AIG vazio (sem entradas)
+  Aig();
+  // Limpa o AIG e cria NI entradas, sem nenhum no AND e sem saidas
+  void clear(unsigned NI=0);
+
+  // Converte a netlist N (que deve estar montada) em AIG
+  // As portas de n entradas viram arvores balanceadas de nos de 2 entradas
+  // Retorna false (e deixa o AIG vazio) se N tiver lacos de realimentacao: um
+  // AIG so representa circuitos combinacionais
+  bool converter(const Netlist& N);
+
+  /// ***********************
+  /// Construcao
+  /// ***********************
+
+  // Retorna o literal de A AND B, aplicando a idempotencia, a absorcao e o hash
+  // estrutural; soh cria um novo no se nenhuma regra se aplicar
+  uint32_t e(uint32_t A, uint32_t B);
+  // A OR B = ~(~A AND ~B)
+  uint32_t ou(uint32_t A, uint32_t B) {return negar(e(negar(A), negar(B)));}
+  // A XOR B = ~(~(A AND ~B) AND ~(~A AND B))
+  uint32_t xou(uint32_t A, uint32_t B);
+  // Acrescenta uma saida ao circuito
+  void adicionarSaida(uint32_t L) {saida.push_back(L);}
+
+  /// ***********************
+  /// Reescrita
+  /// ***********************
+
+  // Reconstroi o AIG a partir das saidas, balanceando as cadeias de AND: cada
+  // "superporta" (arvore de nos AND ligados por arestas nao negadas, em que os
+  // nos internos tem uma unica saida) tem as suas folhas repetidas eliminadas e
+  // eh refeita como uma arvore de profundidade minima, juntando primeiro as
+  // folhas de menor nivel. Os nos que nao alcancam nenhuma saida sao eliminados
+  // Eh repetida enquanto o numero de nos AND ou a profundidade diminuirem (no
+  // maximo MaxPassadas vezes)
+  void reescrever(unsigned MaxPassadas=4);
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumAnds() const {return f0.size();}
+  unsigned getNumNos() const {return Nin+f0.size();}
+  unsigned getNumOutputs() const {return saida.size();}
+  // A profundidade (maior nivel de uma saida)
+  unsigned getProfundidade() const;
+
+  // As entradas do no AND No (de Nin a getNumNos()-1)
+  uint32_t getFanin0(unsigned No) const {return f0[No-Nin];}
+  uint32_t getFanin1(unsigned No) const {return f1[No-Nin];}
+  unsigned getNivel(unsigned No) const {return nivel[No];}
+  // O literal da saida J (de 0 a Nout-1)
+  uint32_t getSaida(unsigned J) const {return saida[J];}
+
+  /// ***********************
+  /// Conversao para netlist
+  /// ***********************
+
+  // Gera a netlist plana equivalente (como no formato binario, ver netlistbin.h)
+  // Cada no AND vira uma porta de 2 entradas; as negacoes sao absorvidas no tipo
+  // da porta sempre que possivel: AN(a,b), NA(a,b) = ~(a.b), NO(a,b) = ~a.~b e
+  // OR(a,b) = ~(~a.~b). Soh sao criadas portas NT para entradas do circuito
+  // negadas e para arestas negadas misturadas com nao negadas
+  // Se todas as saidas vierem de entradas, eh criada uma porta AN(x,x), que passa
+  // a ser a origem da primeira saida (o circuito deve ter ao menos uma porta)
+  void gerarNetlist(std::vector<uint8_t>& Tipos, std::vector<uint32_t>& FaninIni,
+                    std::vector<uint32_t>& Fanin, std::vector<uint32_t>& Saidas) const;
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // A simulacao usa o mesmo estado da Netlist (EstadoNetlist), com um sinal por no
+  // Todos os nos sao do mesmo tipo: o laco de simulacao nao tem nenhum desvio por
+  // tipo de porta
+
+  // Dimensiona o estado para a simulacao escalar e para a simulacao em blocos de
+  // W palavras
+  void prepararEstado(EstadoNetlist& E, unsigned W=1) const;
+
+  // Simulacao escalar: os valores das entradas devem estar em E.valor[0] a
+  // E.valor[Nin-1]; calcula os valores de todos os nos
+  void simular(EstadoNetlist& E) const;
+  // O valor da saida J depois de simular
+  bool3S getValorSaida(const EstadoNetlist& E, unsigned J) const;
+
+  // Simulacao em bloco (64*E.W combinacoes de entrada), com a mesma organizacao
+  // dos planos de Netlist::simularBloco: os planos das entradas devem estar nas
+  // primeiras Nin*E.W palavras de E.val e E.def
+  void simularBloco(EstadoNetlist& E) const;
+  // Copia os planos das saidas (W palavras por saida) para val_out e def_out,
+  // que sao redimensionados para W*getNumOutputs() palavras
+  void lerSaidasBloco(const EstadoNetlist& E, std::vector<uint64_t>& val_out,
+                      std::vector<uint64_t>& def_out) const;
+};
+
+#endif // _AIG_H_
@@ -0,0 +1,85 @@
+#include <cstddef>
+#include "arenaportas.h"
+
+using namespace std;
+
+void* ArenaPortas::reservar(size_t Tam)
+{
+  const size_t alinhamento = alignof(std::max_align_t);
+  Tam = (Tam+alinhamento-1)/alinhamento*alinhamento;
+  if (Tam > livre)
+  {
+    char* bloco = static_cast<char*>(::operator new(TAMANHO_BLOCO));
+    blocos.push_back(bloco);
+    pos = bloco;
+    livre = TAMANHO_BLOCO;
+  }
+  void* p = pos;
+  pos += Tam;
+  livre -= Tam;
+  return p;
+}
+
+ptr_Port ArenaPortas::criar(tipoPorta T)
+{
+  switch (T)
+  {
+  case tipoPorta::NT: return criarTipo<Port_NOT>();
+  case tipoPorta::AN: return criarTipo<Port_AND>();
+  case tipoPorta::NA: return criarTipo<Port_NAND>();
+  case tipoPorta::OR: return criarTipo<Port_OR>();
+  case tipoPorta::NO: return criarTipo<Port_NOR>();
+  case tipoPorta::XO: return criarTipo<Port_XOR>();
+  case tipoPorta::NX: return criarTipo<Port_NXOR>();
+  }
+  return nullptr;
+}
+
+ptr_Port ArenaPortas::criar(const string& Tipo)
+{
+  if (Tipo=="NT") return criarTipo<Port_NOT>();
+  if (Tipo=="AN") return criarTipo<Port_AND>();
+  if (Tipo=="NA") return criarTipo<Port_NAND>();
+  if (Tipo=="OR") return criarTipo<Port_OR>();
+  if (Tipo=="NO") return criarTipo<Port_NOR>();
+  if (Tipo=="XO") return criarTipo<Port_XOR>();
+  if (Tipo=="NX") return criarTipo<Port_NXOR>();
+  return nullptr;
+}
+
+ptr_Port ArenaPortas::copiar(const Port& P)
+{
+  // O tipo eh identificado pelo tipo dinamico (sem comparar strings)
+  if (dynamic_cast<const Port_NOT*>(&P)) return copiarTipo<Port_NOT>(P);
+  if (dynamic_cast<const Port_NAND*>(&P)) return copiarTipo<Port_NAND>(P);
+  if (dynamic_cast<const Port_AND*>(&P)) return copiarTipo<Port_AND>(P);
+  if (dynamic_cast<const Port_NOR*>(&P)) return copiarTipo<Port_NOR>(P);
+  if (dynamic_cast<const Port_OR*>(&P)) return copiarTipo<Port_OR>(P);
+  if (dynamic_cast<const Port_NXOR*>(&P)) return copiarTipo<Port_NXOR>(P);
+  if (dynamic_cast<const Port_XOR*>(&P)) return copiarTipo<Port_XOR>(P);
+  return nullptr;
+}
+
+void ArenaPortas::absorver(ArenaPortas& A)
+{
+  if (A.blocos.empty()) return;
+  // O ultimo bloco de A passa a ser o ultimo desta arena (continua a ser usado)
+  if (!blocos.empty())
+  {
+    A.blocos.insert(A.blocos.end()-1, blocos.begin(), blocos.end());
+  }
+  blocos.swap(A.blocos);
+  pos = A.pos;
+  livre = A.livre;
+  A.blocos.clear();
+  A.pos = nullptr;
+  A.livre = 0;
+}
+
+void ArenaPortas::clear()
+{
+  for (size_t k=0; k<blocos.size(); k++) ::operator delete(blocos[k]);
+  blocos.clear();
+  pos = nullptr;
+  livre = 0;
+}
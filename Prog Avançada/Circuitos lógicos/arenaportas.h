@@ -0,0 +1,75 @@
+#ifndef _ARENAPORTAS_H_
+#define _ARENAPORTAS_H_
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+#include "port.h"
+#include "bool3S_lut.h"
+
+/// ###########################################################################
+/// ARENA DE PORTAS
+/// As portas de um circuito sao criadas em blocos grandes de memoria, um apos
+/// o outro, em vez de um new por porta. Nenhuma porta eh liberada sozinha: o
+/// dono das portas chama destruir para cada uma (o que libera o vetor de ids de
+/// entrada da porta) e a memoria de todas eh liberada de uma vez, com a arena.
+/// Uma arena nao pode ser usada por duas threads ao mesmo tempo; a leitura em
+/// paralelo usa uma arena por thread e depois as junta (absorver).
+/// ###########################################################################
+
+class ArenaPortas {
+private:
+  // Tamanho de cada bloco de memoria
+  static const size_t TAMANHO_BLOCO = 64*1024;
+
+  std::vector<char*> blocos;
+  // A proxima posicao livre no ultimo bloco e o numero de bytes livres nele
+  char* pos;
+  size_t livre;
+
+  // Reserva Tam bytes (alinhados para qualquer tipo) no ultimo bloco,
+  // alocando um novo bloco se necessario
+  void* reservar(size_t Tam);
+
+  // Cria uma porta do tipo T na arena
+  template <class T> ptr_Port criarTipo() {return new (reservar(sizeof(T))) T;}
+  // Cria na arena uma copia da porta P, que deve ser do tipo T
+  template <class T> ptr_Port copiarTipo(const Port& P)
+  {
+    return new (reservar(sizeof(T))) T(static_cast<const T&>(P));
+  }
+
+  ArenaPortas(const ArenaPortas&);
+  void operator=(const ArenaPortas&);
+
+public:
+  ArenaPortas(): blocos(), pos(nullptr), livre(0) {}
+  // Libera todos os blocos (as portas jah devem ter sido destruidas)
+  ~ArenaPortas() {clear();}
+
+  // Cria na arena uma porta do tipo Tipo (NT, AN, NA, OR, NO, XO, NX), com o
+  // numero de entradas padrao do construtor
+  // Retorna nullptr se o tipo for invalido
+  ptr_Port criar(const std::string& Tipo);
+  ptr_Port criar(tipoPorta T);
+
+  // Cria na arena uma copia da porta P (mesmo tipo, mesmas entradas)
+  ptr_Port copiar(const Port& P);
+
+  // Destroi uma porta criada em uma arena (chama o destrutor)
+  // A memoria da porta soh eh liberada junto com a arena
+  static void destruir(ptr_Port P) {if (P != nullptr) P->~Port();}
+
+  // Passa a ser dona dos blocos da arena A, que fica vazia
+  // As portas criadas em A continuam validas
+  void absorver(ArenaPortas& A);
+
+  // Libera todos os blocos (as portas jah devem ter sido destruidas)
+  void clear();
+
+  // Memoria total alocada (em bytes)
+  size_t getNumBytes() const {return blocos.size()*TAMANHO_BLOCO;}
+};
+
+#endif // _ARENAPORTAS_H_
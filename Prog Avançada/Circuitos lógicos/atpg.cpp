@@ -0,0 +1,602 @@
+#include <algorithm>
+#include <climits>
+#include <iomanip>
+#include "atpg.h"
+
+using namespace std;
+
+/// ***********************
+/// Resultado
+/// ***********************
+
+void ResultadoAtpg::clear()
+{
+  vetores.clear();
+  gerados = 0;
+  classes = detectadas = redundantes = abandonadas = 0;
+  cobertura = eficiencia = 0.0;
+}
+
+std::ostream& ResultadoAtpg::imprimir(std::ostream& O) const
+{
+  O << "Vetores: " << vetores.size() << " (" << gerados << " gerados)\n"
+    << "Classes de falhas: " << classes << '\n'
+    << "Detectadas: " << detectadas << '\n'
+    << "Redundantes: " << redundantes << '\n'
+    << "Abandonadas: " << abandonadas << '\n'
+    << fixed << setprecision(2)
+    << "Cobertura: " << 100.0*cobertura << "%\n"
+    << "Eficiencia: " << 100.0*eficiencia << "%\n";
+  O.unsetf(ios::floatfield);
+  return O;
+}
+
+std::ostream& ResultadoAtpg::imprimirVetores(std::ostream& O) const
+{
+  for (const vector<bool3S>& V : vetores)
+  {
+    for (bool3S B : V) O << toChar(B);
+    O << '\n';
+  }
+  return O;
+}
+
+/// ***********************
+/// PODEM
+/// ***********************
+
+enum class resultadoPodem {TESTE, REDUNDANTE, ABANDONADA};
+
+// Os circuitos correto e com falha, simulados juntos, e a busca do PODEM
+class Podem {
+private:
+  const Netlist& N;
+  const unsigned NI, NS;
+  // observavel[s] != 0 se o sinal s alcanca alguma saida
+  const vector<uint32_t>& observavel;
+  // A falha alvo
+  FalhaStuckAt F;
+  // Os valores de cada sinal nos circuitos correto e com a falha
+  // Os valores do circuito correto sao mantidos de uma falha para a outra (soh as
+  // entradas que mudam sao simuladas); fora do cone da falha, ruim==bom
+  vector<bool3S> bom, ruim;
+  // As portas do cone de fanout da falha (inclusive a porta da falha)
+  vector<unsigned> cone;
+  vector<uint32_t> marca_cone;
+  uint32_t rodada_cone;
+  // As portas do cone ainda indefinidas (em algum dos circuitos) que alcancam uma
+  // saida indefinida, e a marca de cada sinal
+  vector<unsigned> regiao;
+  vector<uint32_t> marca_x;
+  uint32_t rodada_x;
+  // Simulacao por eventos: componentes agendadas por nivel
+  vector< vector<unsigned> > eventos;
+  vector<uint32_t> agendada;
+  uint32_t rodada;
+  unsigned nivel_min, nivel_max;
+  // Valores anteriores das portas de uma componente ciclica
+  vector<bool3S> antigo_bom, antigo_ruim;
+  // As decisoes (entrada do circuito, valor e se o valor jah foi trocado)
+  struct Decisao {
+    unsigned entrada;
+    bool3S valor;
+    bool trocada;
+  };
+  vector<Decisao> pilha;
+
+  bool3S valorFalha() const {return F.valor ? bool3S::TRUE : bool3S::FALSE;}
+  // O valor da entrada J da porta P no circuito com a falha
+  bool3S entradaRuim(unsigned P, unsigned J) const
+  {
+    if (F.ramo && F.porta==P && F.pino==J) return valorFalha();
+    return ruim[N.getFanin(P)[J]];
+  }
+  // Avalia a porta P nos dois circuitos
+  void avaliar(unsigned P, bool3S& B, bool3S& R) const;
+  // Avalia a componente C; com Agendar, agenda o fanout das portas que mudarem
+  void avaliarComponente(unsigned C, bool Agendar);
+  void agendarFanout(unsigned S);
+  // Inicia uma nova rodada de agendamento
+  void novaRodada();
+  // Simula as componentes agendadas, em ordem de nivel
+  void propagar();
+  // Atribui o valor V aa entrada I do circuito e simula as consequencias
+  void atribuir(unsigned I, bool3S V);
+  // Cria a lista de portas do cone da falha F
+  void criarCone();
+  void visitarFanout(unsigned S);
+  // A busca do PODEM, com os dois circuitos jah simulados
+  resultadoPodem buscar(std::vector<bool3S>& In, unsigned Limite);
+  // true se alguma saida tem valores definidos diferentes nos dois circuitos
+  bool detectada() const;
+  // Escolhe o proximo objetivo (sinal S deve receber o valor V no circuito correto)
+  // Retorna 0 se a falha nao pode mais ser detectada com as atribuicoes atuais;
+  // 1 se escolheu um objetivo; 2 se nao ha objetivo (a busca continua por
+  // qualquer entrada livre)
+  int objetivo(unsigned& S, bool3S& V);
+  // Inclui a porta do sinal S na regiao, se ela estiver no cone e for indefinida
+  void visitarRegiao(unsigned S);
+  // Leva o objetivo (S, V) ateh uma entrada livre do circuito
+  // Retorna false se nao chegar a uma entrada livre
+  bool backtrace(unsigned& S, bool3S& V) const;
+
+public:
+  // Observavel: os sinais que alcancam alguma saida (Netlist::marcarObservaveis)
+  Podem(const Netlist& Net, const std::vector<uint32_t>& Observavel);
+  // Procura um vetor que detecte a falha Falha, partindo das entradas de In (as
+  // entradas UNDEF sao livres; as demais nao sao alteradas)
+  // Se encontrar, In recebe o vetor (com UNDEF nas entradas que nao importam)
+  // REDUNDANTE: nenhum vetor que completa In detecta a falha
+  resultadoPodem gerar(const FalhaStuckAt& Falha, std::vector<bool3S>& In, unsigned Limite);
+};
+
+Podem::Podem(const Netlist& Net, const std::vector<uint32_t>& Observavel):
+  N(Net), NI(Net.getNumInputs()), NS(Net.getNumSinais()), observavel(Observavel), F(),
+  bom(NS, bool3S::UNDEF), ruim(NS, bool3S::UNDEF), cone(), marca_cone(NS, 0), rodada_cone(0),
+  regiao(), marca_x(NS, 0), rodada_x(0),
+  eventos(max(Net.getNumNiveis(), 1u)), agendada(Net.getNumComponentes(), 0), rodada(0),
+  nivel_min(UINT_MAX), nivel_max(0), antigo_bom(), antigo_ruim(), pilha()
+{
+  // Nenhuma falha ativa (sinal inexistente): os dois circuitos sao iguais
+  F.sinal = NS;
+  F.ramo = false;
+  for (unsigned c=0; c<N.getNumComponentes(); c++) avaliarComponente(c, false);
+}
+
+void Podem::avaliar(unsigned P, bool3S& B, bool3S& R) const
+{
+  const unsigned* in = N.getFanin(P);
+  const unsigned n = N.getNumFanin(P);
+  const tipoPorta T = N.getTipo(P);
+  B = bom[in[0]];
+  R = entradaRuim(P, 0);
+  for (unsigned j=1; j<n; j++)
+  {
+    bool3S b = bom[in[j]], r = entradaRuim(P, j);
+    switch (T)
+    {
+    case tipoPorta::AN: case tipoPorta::NA: case tipoPorta::NT: B &= b; R &= r; break;
+    case tipoPorta::OR: case tipoPorta::NO: B |= b; R |= r; break;
+    case tipoPorta::XO: case tipoPorta::NX: B ^= b; R ^= r; break;
+    }
+  }
+  if (T==tipoPorta::NT || T==tipoPorta::NA || T==tipoPorta::NO || T==tipoPorta::NX)
+  {
+    B = ~B;
+    R = ~R;
+  }
+  if (!F.ramo && F.sinal == NI+P) R = valorFalha();
+}
+
+void Podem::agendarFanout(unsigned S)
+{
+  const unsigned* f = N.getFanout(S);
+  for (unsigned k=0; k<N.getNumFanout(S); k++)
+  {
+    unsigned c = N.getComponente(f[k]);
+    if (agendada[c] == rodada) continue;
+    agendada[c] = rodada;
+    unsigned L = N.getNivel(f[k]);
+    eventos[L].push_back(c);
+    nivel_min = min(nivel_min, L);
+    nivel_max = max(nivel_max, L);
+  }
+}
+
+void Podem::avaliarComponente(unsigned C, bool Agendar)
+{
+  const unsigned* portas = N.getPortasComponente(C);
+  const unsigned tam = N.getTamanhoComponente(C);
+  bool3S b, r;
+  if (!N.getCiclica(C))
+  {
+    unsigned s = NI+portas[0];
+    avaliar(portas[0], b, r);
+    if (b != bom[s] || r != ruim[s])
+    {
+      bom[s] = b;
+      ruim[s] = r;
+      if (Agendar) agendarFanout(s);
+    }
+    return;
+  }
+  // Componente ciclica: parte de UNDEF e itera ateh o ponto fixo, como em
+  // Netlist::simularComponente (um valor definido nao muda mais)
+  antigo_bom.resize(tam);
+  antigo_ruim.resize(tam);
+  for (unsigned k=0; k<tam; k++)
+  {
+    unsigned s = NI+portas[k];
+    antigo_bom[k] = bom[s];
+    antigo_ruim[k] = ruim[s];
+    bom[s] = ruim[s] = bool3S::UNDEF;
+  }
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned k=0; k<tam; k++)
+    {
+      unsigned s = NI+portas[k];
+      avaliar(portas[k], b, r);
+      if (bom[s] == bool3S::UNDEF && b != bool3S::UNDEF) {bom[s] = b; mudou = true;}
+      if (ruim[s] == bool3S::UNDEF && r != bool3S::UNDEF) {ruim[s] = r; mudou = true;}
+    }
+  }
+  while (mudou);
+  if (!Agendar) return;
+  for (unsigned k=0; k<tam; k++)
+  {
+    unsigned s = NI+portas[k];
+    if (bom[s] != antigo_bom[k] || ruim[s] != antigo_ruim[k]) agendarFanout(s);
+  }
+}
+
+void Podem::propagar()
+{
+  for (unsigned L=nivel_min; L<=nivel_max && nivel_min!=UINT_MAX; L++)
+  {
+    for (unsigned i=0; i<eventos[L].size(); i++) avaliarComponente(eventos[L][i], true);
+    eventos[L].clear();
+  }
+  nivel_min = UINT_MAX;
+  nivel_max = 0;
+}
+
+void Podem::novaRodada()
+{
+  if (++rodada == 0)
+  {
+    fill(agendada.begin(), agendada.end(), 0);
+    rodada = 1;
+  }
+}
+
+void Podem::atribuir(unsigned I, bool3S V)
+{
+  bom[I] = V;
+  ruim[I] = (!F.ramo && F.sinal == I ? valorFalha() : V);
+  novaRodada();
+  agendarFanout(I);
+  propagar();
+}
+
+bool Podem::detectada() const
+{
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    unsigned o = N.getSaida(j);
+    if (bom[o] != bool3S::UNDEF && ruim[o] != bool3S::UNDEF && bom[o] != ruim[o]) return true;
+  }
+  return false;
+}
+
+void Podem::visitarRegiao(unsigned S)
+{
+  if (S < NI || marca_cone[S] != rodada_cone || marca_x[S] == rodada_x) return;
+  if (bom[S] != bool3S::UNDEF && ruim[S] != bool3S::UNDEF) return;
+  marca_x[S] = rodada_x;
+  regiao.push_back(S-NI);
+}
+
+int Podem::objetivo(unsigned& S, bool3S& V)
+{
+  // Ativacao: o ponto da falha deve ter, no circuito correto, o valor oposto ao fixado
+  bool3S local = bom[F.sinal];
+  if (local == valorFalha()) return 0;
+  if (local == bool3S::UNDEF)
+  {
+    S = F.sinal;
+    V = ~valorFalha();
+    return 1;
+  }
+
+  // Propagacao: o erro soh pode chegar a uma saida por sinais ainda indefinidos
+  // (em algum dos circuitos) do cone da falha. A regiao desses sinais que alcancam
+  // uma saida indefinida eh obtida voltando das saidas pelo fanin
+  if (++rodada_x == 0)
+  {
+    fill(marca_x.begin(), marca_x.end(), 0);
+    rodada_x = 1;
+  }
+  regiao.clear();
+  for (unsigned j=0; j<N.getNumOutputs(); j++) visitarRegiao(N.getSaida(j));
+  for (unsigned k=0; k<regiao.size(); k++)
+  {
+    const unsigned p = regiao[k];
+    const unsigned* in = N.getFanin(p);
+    for (unsigned j=0; j<N.getNumFanin(p); j++) visitarRegiao(in[j]);
+  }
+
+  // A fronteira D: as portas da regiao com alguma entrada com erro
+  // Escolhe a de menor nivel que tenha uma entrada indefinida no circuito correto
+  bool fronteira = false;
+  unsigned melhor = NS;
+  bool3S nc = bool3S::FALSE;
+  for (unsigned p : regiao)
+  {
+    const unsigned* in = N.getFanin(p);
+    const unsigned n = N.getNumFanin(p);
+    bool erro = false, livre = false;
+    for (unsigned j=0; j<n; j++)
+    {
+      if (bom[in[j]] != entradaRuim(p, j)) erro = true;
+      if (bom[in[j]] == bool3S::UNDEF) livre = true;
+    }
+    if (!erro) continue;
+    fronteira = true;
+    if (!livre || (melhor != NS && N.getNivel(p) >= N.getNivel(melhor))) continue;
+    melhor = p;
+  }
+  if (melhor == NS) return (fronteira ? 2 : 0);
+
+  // O valor nao controlador da porta, numa entrada indefinida
+  switch (N.getTipo(melhor))
+  {
+  case tipoPorta::AN: case tipoPorta::NA: nc = bool3S::TRUE; break;
+  default: nc = bool3S::FALSE; break;
+  }
+  const unsigned* in = N.getFanin(melhor);
+  unsigned j = 0;
+  while (bom[in[j]] != bool3S::UNDEF) j++;
+  S = in[j];
+  V = nc;
+  return 1;
+}
+
+bool Podem::backtrace(unsigned& S, bool3S& V) const
+{
+  // Nos lacos, o caminho pode voltar a uma porta jah visitada: o numero de
+  // passos eh limitado
+  for (unsigned passos=0; S >= NI; passos++)
+  {
+    if (passos > NS) return false;
+    const unsigned p = S-NI;
+    const tipoPorta T = N.getTipo(p);
+    if (T==tipoPorta::NT || T==tipoPorta::NA || T==tipoPorta::NO || T==tipoPorta::NX) V = ~V;
+    const unsigned* in = N.getFanin(p);
+    unsigned j = 0;
+    while (j < N.getNumFanin(p) && bom[in[j]] != bool3S::UNDEF) j++;
+    if (j == N.getNumFanin(p)) return false;
+    S = in[j];
+  }
+  return bom[S] == bool3S::UNDEF;
+}
+
+void Podem::visitarFanout(unsigned S)
+{
+  const unsigned* f = N.getFanout(S);
+  for (unsigned k=0; k<N.getNumFanout(S); k++)
+  {
+    unsigned t = NI+f[k];
+    if (marca_cone[t] == rodada_cone) continue;
+    marca_cone[t] = rodada_cone;
+    cone.push_back(f[k]);
+  }
+}
+
+void Podem::criarCone()
+{
+  if (++rodada_cone == 0)
+  {
+    fill(marca_cone.begin(), marca_cone.end(), 0);
+    rodada_cone = 1;
+  }
+  cone.clear();
+  // Busca em largura a partir da porta da falha (no ramo, a porta da entrada; no
+  // tronco, a propria porta): as portas ficam aproximadamente em ordem de nivel
+  const unsigned origem = (F.ramo ? NI+F.porta : F.sinal);
+  marca_cone[origem] = rodada_cone;
+  if (origem >= NI) cone.push_back(origem-NI);
+  else visitarFanout(origem);
+  for (unsigned k=0; k<cone.size(); k++) visitarFanout(NI+cone[k]);
+}
+
+resultadoPodem Podem::gerar(const FalhaStuckAt& Falha, std::vector<bool3S>& In, unsigned Limite)
+{
+  // O circuito correto: simula apenas as entradas que mudaram desde a ultima busca
+  novaRodada();
+  for (unsigned i=0; i<NI; i++)
+  {
+    if (bom[i] == In[i]) continue;
+    bom[i] = ruim[i] = In[i];
+    agendarFanout(i);
+  }
+  propagar();
+
+  // Uma falha que nao alcanca nenhuma saida nao eh detectavel
+  const unsigned origem = (Falha.ramo ? NI+Falha.porta : Falha.sinal);
+  if (!observavel[origem]) return resultadoPodem::REDUNDANTE;
+
+  // O circuito com a falha: simula a partir do ponto da falha
+  F = Falha;
+  criarCone();
+  novaRodada();
+  if (origem < NI)
+  {
+    ruim[origem] = valorFalha();
+    agendarFanout(origem);
+  }
+  else
+  {
+    const unsigned c = N.getComponente(origem-NI);
+    agendada[c] = rodada;
+    eventos[N.getNivel(origem-NI)].push_back(c);
+    nivel_min = nivel_max = N.getNivel(origem-NI);
+  }
+  propagar();
+
+  resultadoPodem res = buscar(In, Limite);
+
+  // Volta ao circuito sem falha (as decisoes da busca ficam no circuito correto,
+  // e sao desfeitas na proxima busca)
+  if (origem < NI) ruim[origem] = bom[origem];
+  for (unsigned p : cone) ruim[NI+p] = bom[NI+p];
+  F.sinal = NS;
+  F.ramo = false;
+  return res;
+}
+
+resultadoPodem Podem::buscar(std::vector<bool3S>& In, unsigned Limite)
+{
+  pilha.clear();
+  unsigned retrocessos = 0;
+  while (true)
+  {
+    if (detectada())
+    {
+      for (unsigned i=0; i<NI; i++) In[i] = bom[i];
+      return resultadoPodem::TESTE;
+    }
+
+    // Proxima decisao
+    unsigned S = 0;
+    bool3S V = bool3S::FALSE;
+    int obj = objetivo(S, V);
+    bool decidiu = (obj == 1 && backtrace(S, V));
+    if (!decidiu && obj != 0)
+    {
+      // Sem objetivo que leve a uma entrada: qualquer entrada livre
+      for (S=0; S<NI && bom[S]!=bool3S::UNDEF; S++);
+      V = bool3S::FALSE;
+      decidiu = (S < NI);
+    }
+    if (decidiu)
+    {
+      pilha.push_back({S, V, false});
+      atribuir(S, V);
+      continue;
+    }
+
+    // Retrocesso: desfaz as decisoes jah trocadas e troca a ultima
+    while (!pilha.empty() && pilha.back().trocada)
+    {
+      atribuir(pilha.back().entrada, bool3S::UNDEF);
+      pilha.pop_back();
+    }
+    if (pilha.empty()) return resultadoPodem::REDUNDANTE;
+    if (++retrocessos > Limite) return resultadoPodem::ABANDONADA;
+    pilha.back().trocada = true;
+    pilha.back().valor = ~pilha.back().valor;
+    atribuir(pilha.back().entrada, pilha.back().valor);
+  }
+}
+
+/// ***********************
+/// Geracao e compactacao
+/// ***********************
+
+// true se os vetores A e B nao tem nenhuma entrada com valores definidos diferentes
+static bool compativeis(const vector<bool3S>& A, const vector<bool3S>& B)
+{
+  for (unsigned i=0; i<A.size(); i++)
+  {
+    if (A[i] != bool3S::UNDEF && B[i] != bool3S::UNDEF && A[i] != B[i]) return false;
+  }
+  return true;
+}
+
+void gerarTestes(const Netlist& N, const OpcoesAtpg& Op, ResultadoAtpg& R)
+{
+  R.clear();
+  const unsigned NI = N.getNumInputs();
+
+  SimuladorFalhas S;
+  S.gerarFalhas(N);
+  R.classes = S.getNumClasses();
+  // O resultado do PODEM para cada representante que nao gerou vetor
+  enum {NENHUM, REDUNDANTE, ABANDONADA};
+  vector<uint8_t> situacao(S.getNumFalhas(), NENHUM);
+
+  Podem P(N, S.getObservaveis());
+  vector< vector<bool3S> > gerados;
+  vector<bool3S> vetor, tentativa;
+  for (unsigned k=0; k<S.getNumClasses(); k++)
+  {
+    if (S.getCobertura() >= Op.coberturaAlvo) break;
+    const unsigned r = S.getRepresentante(k);
+    if (S.getEstado(r) == estadoFalha::DETECTADA || situacao[r] != NENHUM) continue;
+
+    vetor.assign(NI, bool3S::UNDEF);
+    resultadoPodem res = P.gerar(S.getFalha(r), vetor, Op.limiteRetrocessos);
+    if (res != resultadoPodem::TESTE)
+    {
+      situacao[r] = (res == resultadoPodem::REDUNDANTE ? REDUNDANTE : ABANDONADA);
+      continue;
+    }
+
+    // Compactacao dinamica: completa o vetor com testes de outras falhas
+    unsigned tentadas = 0;
+    for (unsigned k2=k+1; k2<S.getNumClasses() && tentadas<Op.maxSecundarias; k2++)
+    {
+      const unsigned r2 = S.getRepresentante(k2);
+      if (S.getEstado(r2) == estadoFalha::DETECTADA || situacao[r2] != NENHUM) continue;
+      tentadas++;
+      tentativa = vetor;
+      if (P.gerar(S.getFalha(r2), tentativa, Op.limiteSecundarias) == resultadoPodem::TESTE)
+      {
+        vetor = tentativa;
+      }
+    }
+
+    // Descarte: todas as falhas detectadas pelo vetor
+    S.simular(vector< vector<bool3S> >(1, vetor));
+    gerados.push_back(vetor);
+  }
+  R.gerados = gerados.size();
+
+  if (Op.compactacaoEstatica)
+  {
+    // Fusao dos vetores compativeis: pela monotonia, o vetor fundido detecta
+    // todas as falhas detectadas pelos dois
+    vector< vector<bool3S> > fundidos;
+    for (const vector<bool3S>& V : gerados)
+    {
+      unsigned j = 0;
+      while (j < fundidos.size() && !compativeis(fundidos[j], V)) j++;
+      if (j == fundidos.size()) fundidos.push_back(V);
+      else
+      {
+        for (unsigned i=0; i<NI; i++) if (V[i] != bool3S::UNDEF) fundidos[j][i] = V[i];
+      }
+    }
+    // Simulacao em ordem inversa: os primeiros vetores gerados costumam ser
+    // redundantes com os ultimos (que detectam as falhas mais dificeis)
+    SimuladorFalhas S2;
+    S2.gerarFalhas(N);
+    vector<uint8_t> manter(fundidos.size(), 0);
+    for (unsigned j=fundidos.size(); j>0; j--)
+    {
+      unsigned antes = S2.getNumClasses(estadoFalha::DETECTADA);
+      S2.simular(vector< vector<bool3S> >(1, fundidos[j-1]));
+      manter[j-1] = (S2.getNumClasses(estadoFalha::DETECTADA) > antes);
+    }
+    for (unsigned j=0; j<fundidos.size(); j++) if (manter[j]) R.vetores.push_back(fundidos[j]);
+  }
+  else R.vetores = gerados;
+
+  if (Op.preencher)
+  {
+    for (vector<bool3S>& V : R.vetores)
+    {
+      for (bool3S& B : V) if (B == bool3S::UNDEF) B = bool3S::FALSE;
+    }
+  }
+
+  // Os numeros finais sao os da simulacao do conjunto final de vetores
+  S.reiniciar();
+  S.simular(R.vetores);
+  R.detectadas = S.getNumClasses(estadoFalha::DETECTADA);
+  for (unsigned k=0; k<S.getNumClasses(); k++)
+  {
+    const unsigned r = S.getRepresentante(k);
+    if (S.getEstado(r) == estadoFalha::DETECTADA) continue;
+    if (situacao[r] == REDUNDANTE) R.redundantes++;
+    else if (situacao[r] == ABANDONADA) R.abandonadas++;
+  }
+  if (R.classes > 0)
+  {
+    R.cobertura = double(R.detectadas)/R.classes;
+    R.eficiencia = double(R.detectadas+R.redundantes)/R.classes;
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef _ATPG_H_
+#define _ATPG_H_
+
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "netlist.h"
+#include "falhas.h"
+
+/// ###########################################################################
+/// GERACAO AUTOMATICA DE VETORES DE TESTE (ATPG)
+/// Gera um conjunto pequeno de vetores de teste que detecta as falhas stuck-at do
+/// circuito (ver falhas.h), pelo algoritmo PODEM:
+/// - o circuito correto e o circuito com a falha sao simulados juntos; as entradas
+///   ainda nao atribuidas valem UNDEF, que faz o papel do valor X do PODEM (pela
+///   monotonia da logica de 3 estados, um vetor com entradas UNDEF que detecta a
+///   falha continua detectando com quaisquer valores nessas entradas);
+/// - a cada passo escolhe-se um objetivo: ativar a falha (levar o ponto da falha
+///   ao valor oposto ao fixado) ou, se ela jah estiver ativada, propagar o erro por
+///   uma porta da fronteira D (porta com uma entrada com erro e saida ainda
+///   indefinida), dando a uma entrada UNDEF o valor nao controlador da porta;
+///   soh contam as portas com um caminho de sinais indefinidos ateh uma saida
+///   indefinida (o erro nao passa por um sinal jah definido nos dois circuitos);
+/// - o objetivo eh levado (backtrace) de porta em porta, pelas entradas UNDEF,
+///   ateh uma entrada do circuito, que recebe um valor; as consequencias sao
+///   simuladas por eventos (inclusive nos lacos de realimentacao);
+/// - se a falha deixar de poder ser ativada ou a fronteira D ficar vazia, a
+///   ultima decisao eh trocada (retrocesso); esgotadas as decisoes, a falha eh
+///   redundante (nao ha vetor que a detecte). Passado o limite de retrocessos, a
+///   falha eh abandonada.
+///
+/// Compactacao:
+/// - dinamica: o vetor gerado para uma falha ainda tem entradas UNDEF; o PODEM eh
+///   aplicado a outras falhas nao detectadas partindo desse vetor (sem alterar as
+///   entradas jah atribuidas), e as que puderem ser detectadas completam o vetor;
+/// - estatica: os vetores compativeis (sem entrada com valores definidos
+///   diferentes) sao fundidos, e em seguida os vetores sao simulados em ordem
+///   inversa (simulacao de falhas com descarte) e os que nao detectam nenhuma
+///   falha nova sao eliminados.
+/// Depois de cada vetor gerado, a simulacao de falhas descarta todas as falhas
+/// que ele detecta, que nao precisam mais de um vetor proprio.
+/// ###########################################################################
+
+// As opcoes da geracao
+struct OpcoesAtpg {
+  // Cobertura desejada (de 0 a 1, sobre as classes de falhas): a geracao para
+  // assim que ela for atingida
+  double coberturaAlvo;
+  // Limite de retrocessos do PODEM para cada falha alvo
+  unsigned limiteRetrocessos;
+  // Compactacao dinamica: numero maximo de falhas adicionais tentadas em cada
+  // vetor (0: sem compactacao dinamica) e limite de retrocessos de cada tentativa
+  unsigned maxSecundarias;
+  unsigned limiteSecundarias;
+  // Compactacao estatica (fusao e simulacao em ordem inversa)
+  bool compactacaoEstatica;
+  // Se true, as entradas que ficarem UNDEF nos vetores finais recebem FALSE
+  bool preencher;
+
+  OpcoesAtpg(): coberturaAlvo(1.0), limiteRetrocessos(1000), maxSecundarias(64),
+    limiteSecundarias(20), compactacaoEstatica(true), preencher(false) {}
+};
+
+// O resultado da geracao
+struct ResultadoAtpg {
+  // Os vetores de teste (um valor por entrada do circuito)
+  std::vector< std::vector<bool3S> > vetores;
+  // Numero de vetores gerados antes da compactacao estatica
+  unsigned gerados;
+  // Numero de classes de falhas (colapsadas): total, detectadas pelos vetores,
+  // provadas redundantes e abandonadas (limite de retrocessos)
+  unsigned classes, detectadas, redundantes, abandonadas;
+  // Cobertura (detectadas/classes) e eficiencia ((detectadas+redundantes)/classes)
+  double cobertura, eficiencia;
+
+  ResultadoAtpg() {clear();}
+  void clear();
+  // Imprime o resumo da geracao
+  std::ostream& imprimir(std::ostream& O) const;
+  // Grava os vetores, um por linha, com um caractere (? F T) por entrada (o mesmo
+  // formato dos arquivos de estimulos, ver sequencial.h)
+  std::ostream& imprimirVetores(std::ostream& O) const;
+};
+
+// Gera os vetores de teste das falhas stuck-at (colapsadas) da netlist N (que
+// deve estar montada), com as opcoes Op
+void gerarTestes(const Netlist& N, const OpcoesAtpg& Op, ResultadoAtpg& R);
+
+#endif // _ATPG_H_
@@ -0,0 +1,60 @@
+#-------------------------------------------------
+#
+# Gerador de tabela verdade em linha de comando (sem Qt)
+# Usa as mesmas classes de simulacao do programa Circuito
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   -= qt app_bundle
+CONFIG   += console c++17 thread
+
+TARGET = circuito_batch
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    ../aig.cpp \
+    ../arenaportas.cpp \
+    ../bdd.cpp \
+    ../sat.cpp \
+    ../equivalencia.cpp \
+    ../cones.cpp \
+    ../montecarlo.cpp \
+    ../falhas.cpp \
+    ../atpg.cpp \
+    ../bool3S.cpp \
+    ../bool3S_vector.cpp \
+    ../circuito.cpp \
+    ../gray3S.cpp \
+    ../kernel3S.cpp \
+    ../leitorcircuito.cpp \
+    ../netlist.cpp \
+    ../netlistbin.cpp \
+    ../otimizacao.cpp \
+    ../port.cpp \
+    ../sequencial.cpp
+
+HEADERS  += ../aig.h \
+    ../arenaportas.h \
+    ../bdd.h \
+    ../sat.h \
+    ../equivalencia.h \
+    ../cones.h \
+    ../montecarlo.h \
+    ../falhas.h \
+    ../atpg.h \
+    ../bool3S.h \
+    ../bool3S_64.h \
+    ../bool3S_lut.h \
+    ../bool3S_vector.h \
+    ../circuito.h \
+    ../gray3S.h \
+    ../kernel3S.h \
+    ../leitorcircuito.h \
+    ../netlist.h \
+    ../netlistbin.h \
+    ../otimizacao.h \
+    ../port.h \
+    ../sequencial.h
@@ -0,0 +1,606 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include "circuito.h"
+
+using namespace std;
+
+/// ###########################################################################
+/// GERADOR DE TABELA VERDADE EM LINHA DE COMANDO
+///
+/// Uso: circuito_batch [opcoes] <circuito.txt> <arquivo de saida>
+///   -f csv|bin   formato de saida (padrao: csv)
+///   -t N         numero de threads (padrao: uma por nucleo)
+///   -b N         numero de linhas simuladas de cada vez (padrao: 1048576)
+///   -s           imprime as estatisticas do circuito (na saida de erro)
+///   -e arquivo   modo sequencial: em vez da tabela verdade, simula um ciclo de
+///                relogio para cada linha do arquivo de estimulos (ver abaixo)
+///   -c txt|bin   conversao: em vez da tabela verdade, grava o circuito no
+///                formato texto (CIRCUITO/PORTAS/SAIDAS) ou binario (netlistbin.h)
+///   -o           otimiza o circuito depois de ler (ver otimizacao.h) e imprime o
+///                resumo da otimizacao (com -s, tambem a lista das portas removidas)
+///   -a           converte o circuito (combinacional) em AIG, reescreve o AIG
+///                (ver aig.h) e volta a um circuito de portas de 2 entradas;
+///                imprime o numero de nos e a profundidade antes e depois
+///   -d           modo simbolico: em vez da tabela verdade, constroi os BDDs das
+///                saidas (ver bdd.h) e grava, para cada saida, o numero de linhas
+///                da tabela em que ela vale TRUE, FALSE e UNDEF (CSV), sem
+///                percorrer a tabela (serve para circuitos com muitas entradas)
+///   -x           deduz a tabela das 2^n linhas sem UNDEF (ver
+///                Circuito::gerarTabelaBooleana): muito mais rapido em circuitos
+///                grandes, mas a tabela inteira fica em memoria e as linhas com
+///                UNDEF seguem a semantica dos completamentos (podem ser mais
+///                definidas que as da simulacao porta a porta)
+///   -q arquivo   modo de equivalencia: em vez da tabela verdade, verifica se o
+///                circuito (depois de -o e -a) eh equivalente ao circuito do
+///                arquivo (ver equivalencia.h) e grava EQUIVALENTES ou DIFERENTES,
+///                com a combinacao de entrada que distingue os dois circuitos
+///   -p           tabelas por saida: em vez da tabela completa, grava uma tabela
+///                para cada saida, apenas sobre as entradas do seu suporte (as
+///                entradas das quais ela depende, ver cones.h), em CSV: um bloco
+///                por saida (cabecalho Ei,...,Ej,Sk e 3^k linhas), separados por
+///                uma linha vazia. Serve para circuitos com muitas entradas em
+///                que cada saida depende de poucas (com -s, imprime o tamanho do
+///                suporte e do cone de cada saida)
+///   -m N         modo Monte Carlo: em vez da tabela verdade, simula N combinacoes
+///                de entrada sorteadas (FALSE, TRUE e UNDEF equiprovaveis) e grava,
+///                para cada entrada, porta e saida, a frequencia de cada valor e a
+///                taxa de troca (CSV, ver montecarlo.h). Serve para circuitos com
+///                entradas demais para a tabela
+///   -r N         semente do sorteio do modo Monte Carlo (padrao: 1); a mesma
+///                semente da sempre as mesmas estatisticas
+///   -T X         tolerancia do modo Monte Carlo: para antes das N combinacoes
+///                assim que o erro padrao de todas as frequencias for no maximo X
+///                (ex.: 0.005)
+///   -F arquivo   simulacao de falhas: em vez da tabela verdade, simula as falhas
+///                stuck-at (colapsadas) do circuito com os vetores de teste do
+///                arquivo (mesmo formato do arquivo de estimulos) e grava a
+///                cobertura de falhas (ver falhas.h); com -s, tambem a lista das
+///                falhas nao detectadas
+///   -A N         geracao de vetores de teste (ATPG): em vez da tabela verdade,
+///                gera vetores de teste para as falhas stuck-at do circuito
+///                (PODEM com compactacao, ver atpg.h) ateh a cobertura de N% das
+///                falhas e grava os vetores, um por linha (formato do arquivo de
+///                estimulos, que pode ser usado com -F); com -s, imprime o resumo
+///                (cobertura, falhas redundantes e abandonadas)
+/// O circuito pode estar em qualquer um dos dois formatos (detectado pelo conteudo).
+/// Se o arquivo de saida (ou o de estimulos) for "-", usa a saida (ou a entrada)
+/// padrao.
+///
+/// A tabela eh gerada e gravada por partes de N linhas, de modo que a memoria
+/// usada nao depende do numero de entradas do circuito.
+///
+/// Formato CSV: uma linha de cabecalho (E1,...,En,S1,...,Sm) e uma linha por
+/// combinacao de entrada, com os caracteres ? F T, na mesma ordem da tabela
+/// verdade do programa Circuito (a ultima entrada varia mais rapido).
+///
+/// Formato binario (todos os inteiros em little-endian):
+///   8 bytes: "TABELA3S"
+///   4 bytes: numero de entradas n
+///   4 bytes: numero de saidas m
+///   8 bytes: numero de linhas (3^n)
+///   em seguida, os valores das saidas, 2 bits por valor (0=UNDEF, 1=FALSE,
+///   2=TRUE), 4 valores por byte: o valor da saida j na linha L eh o de
+///   indice i=L*m+j e ocupa os bits 2*(i%4) e 2*(i%4)+1 do byte i/4.
+///   As entradas nao sao gravadas, pois sao dadas pelo numero da linha.
+///
+/// Modo sequencial: o arquivo de estimulos tem uma linha por ciclo, com um
+/// caractere (? F T) por entrada; linhas vazias ou comecando com # sao ignoradas.
+/// A saida tem uma linha por ciclo, com um caractere por saida. Os lacos de
+/// realimentacao guardam o seu valor de um ciclo para o seguinte (ver
+/// Circuito::simularCiclo); o estado inicial eh todo UNDEF.
+/// ###########################################################################
+
+// Numero padrao de linhas simuladas de cada vez
+static const unsigned long long LINHAS_PADRAO = 1048576;
+
+// Grava um inteiro sem sinal de NBytes bytes em little-endian
+static void gravarInteiro(ostream& O, unsigned long long X, unsigned NBytes)
+{
+  for (unsigned k=0; k<NBytes; k++)
+  {
+    O.put(char(X & 0xFF));
+    X >>= 8;
+  }
+}
+
+// Imprime a forma de uso do programa
+static void uso(const char* Nome)
+{
+  cerr << "Uso: " << Nome << " [-f csv|bin] [-t threads] [-b linhas] [-s] "
+       << "[-e estimulos | -] [-c txt|bin] [-o] [-a] [-d] [-x] [-p] [-m vetores] [-r semente] [-T tolerancia] [-F vetores] [-A cobertura] [-q circuito] <circuito> <arquivo de saida | ->\n";
+}
+
+// Converte um argumento numerico positivo
+// Retorna false se o argumento nao for um numero positivo
+static bool lerNumero(const char* Arg, unsigned long long& N)
+{
+  char* fim;
+  N = strtoull(Arg, &fim, 10);
+  return *Arg != '\0' && *fim == '\0' && N > 0;
+}
+
+int main(int argc, char *argv[])
+{
+  bool binario = false, estatisticas = false, otimizar = false, aig = false;
+  bool simbolico = false, booleana = false, porSaida = false;
+  unsigned long long numThreads = 0, linhasBloco = LINHAS_PADRAO;
+  unsigned long long vetoresAleatorios = 0, coberturaTestes = 0, semente = 1;
+  double tolerancia = 0.0;
+  vector<string> arquivos;
+  string estimulos, conversao, outro, testes;
+
+  ///LE AS OPCOES
+  for (int i=1; i<argc; i++)
+  {
+    string arg = argv[i];
+    if (arg == "-f" && i+1<argc)
+    {
+      string formato = argv[++i];
+      if (formato == "bin") binario = true;
+      else if (formato == "csv") binario = false;
+      else
+      {
+        cerr << "Formato invalido: " << formato << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-t" && i+1<argc)
+    {
+      if (!lerNumero(argv[++i], numThreads))
+      {
+        cerr << "Numero de threads invalido: " << argv[i] << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-b" && i+1<argc)
+    {
+      if (!lerNumero(argv[++i], linhasBloco))
+      {
+        cerr << "Numero de linhas invalido: " << argv[i] << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-s") estatisticas = true;
+    else if (arg == "-o") otimizar = true;
+    else if (arg == "-a") aig = true;
+    else if (arg == "-d") simbolico = true;
+    else if (arg == "-x") booleana = true;
+    else if (arg == "-p") porSaida = true;
+    else if (arg == "-m" && i+1<argc)
+    {
+      if (!lerNumero(argv[++i], vetoresAleatorios))
+      {
+        cerr << "Numero de vetores invalido: " << argv[i] << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-r" && i+1<argc)
+    {
+      if (!lerNumero(argv[++i], semente))
+      {
+        cerr << "Semente invalida: " << argv[i] << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-T" && i+1<argc)
+    {
+      char* fim;
+      const char* valor = argv[++i];
+      tolerancia = strtod(valor, &fim);
+      if (*valor == '\0' || *fim != '\0' || !(tolerancia > 0.0))
+      {
+        cerr << "Tolerancia invalida: " << valor << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-A" && i+1<argc)
+    {
+      if (!lerNumero(argv[++i], coberturaTestes) || coberturaTestes == 0 || coberturaTestes > 100)
+      {
+        cerr << "Cobertura invalida: " << argv[i] << endl;
+        return 1;
+      }
+    }
+    else if (arg == "-e" && i+1<argc) estimulos = argv[++i];
+    else if (arg == "-q" && i+1<argc) outro = argv[++i];
+    else if (arg == "-F" && i+1<argc) testes = argv[++i];
+    else if (arg == "-c" && i+1<argc)
+    {
+      conversao = argv[++i];
+      if (conversao != "txt" && conversao != "bin")
+      {
+        cerr << "Formato de conversao invalido: " << conversao << endl;
+        return 1;
+      }
+    }
+    else if (arg.size()>1 && arg[0]=='-')
+    {
+      uso(argv[0]);
+      return 1;
+    }
+    else arquivos.push_back(arg);
+  }
+  if (arquivos.size() != 2)
+  {
+    uso(argv[0]);
+    return 1;
+  }
+  // No formato binario, cada bloco deve comecar no inicio de um byte
+  if (binario) linhasBloco = (linhasBloco+3)/4*4;
+
+  ///LE O CIRCUITO
+  Circuito C;
+  string erro;
+  if (!C.ler(arquivos[0], erro))
+  {
+    cerr << "Erro na leitura do circuito " << arquivos[0] << ": " << erro << endl;
+    return 2;
+  }
+
+  ///OTIMIZACAO
+  if (otimizar)
+  {
+    RelatorioOtimizacao R;
+    if (!C.otimizar(R))
+    {
+      cerr << "Erro na otimizacao do circuito" << endl;
+      return 2;
+    }
+    R.imprimir(cerr, estatisticas);
+  }
+
+  ///AIG
+  if (aig)
+  {
+    Aig A;
+    if (!C.gerarAig(A))
+    {
+      cerr << "O circuito tem lacos de realimentacao: nao pode ser convertido em AIG" << endl;
+      return 2;
+    }
+    cerr << "AIG: " << A.getNumAnds() << " nos AND, profundidade " << A.getProfundidade();
+    A.reescrever();
+    cerr << " -> " << A.getNumAnds() << " nos AND, profundidade " << A.getProfundidade() << endl;
+    if (!C.lerAig(A))
+    {
+      cerr << "Erro na conversao do AIG" << endl;
+      return 2;
+    }
+  }
+
+  unsigned NI = C.getNumInputs(), NO = C.getNumOutputs();
+  unsigned long long numLinhas = C.getNumLinhasTabela();
+  if (numLinhas == 0 && estimulos.empty() && conversao.empty() && !simbolico &&
+      outro.empty() && !porSaida && vetoresAleatorios == 0 && testes.empty() &&
+      coberturaTestes == 0)
+  {
+    cerr << "Numero de linhas da tabela verdade muito grande" << endl;
+    return 2;
+  }
+  if (linhasBloco > numLinhas) linhasBloco = numLinhas;
+
+  ///ESTATISTICAS
+  if (estatisticas)
+  {
+    vector<unsigned> lacos = C.getTamanhosComponentesCiclicas();
+    cerr << "Entradas: " << NI << "\nSaidas: " << NO
+         << "\nPortas: " << C.getNumPorts()
+         << "\nNiveis: " << C.getNumNiveis()
+         << "\nComponentes fortemente conexas: " << C.getNumComponentes()
+         << "\nComponentes ciclicas: " << lacos.size();
+    if (!lacos.empty())
+    {
+      cerr << " (portas:";
+      for (unsigned k=0; k<lacos.size(); k++) cerr << ' ' << lacos[k];
+      cerr << ')';
+    }
+    cerr << "\nLinhas da tabela: " << numLinhas << endl;
+  }
+
+  ///CONVERSAO
+  if (!conversao.empty())
+  {
+    // O formato binario eh mapeado em memoria: deve ser gravado em um arquivo
+    bool ok;
+    if (conversao == "bin") ok = (arquivos[1] != "-" && C.salvarBinario(arquivos[1]));
+    else if (arquivos[1] == "-") ok = C.imprimir(cout).good();
+    else ok = C.salvar(arquivos[1]);
+    if (!ok)
+    {
+      cerr << "Erro na gravacao do circuito " << arquivos[1] << endl;
+      return 3;
+    }
+    return 0;
+  }
+
+  ///ABRE A SAIDA
+  ofstream arq;
+  if (arquivos[1] != "-")
+  {
+    arq.open(arquivos[1].c_str(), binario ? ios::out|ios::binary : ios::out);
+    if (!arq.is_open())
+    {
+      cerr << "Erro na abertura do arquivo " << arquivos[1] << endl;
+      return 3;
+    }
+  }
+  ostream& O = (arquivos[1] != "-" ? static_cast<ostream&>(arq) : cout);
+
+  ///MODO SEQUENCIAL
+  if (!estimulos.empty())
+  {
+    ifstream arqEst;
+    if (estimulos != "-")
+    {
+      arqEst.open(estimulos.c_str());
+      if (!arqEst.is_open())
+      {
+        cerr << "Erro na abertura do arquivo " << estimulos << endl;
+        return 3;
+      }
+    }
+    FonteEstimulosTexto F(estimulos != "-" ? static_cast<istream&>(arqEst) : cin);
+    DestinoSaidasTexto D(O);
+    unsigned long long ciclos = C.simularSequencia(F, D);
+    if (F.getErro())
+    {
+      cerr << "Erro no arquivo de estimulos, linha " << F.getNumLinha() << endl;
+      return 2;
+    }
+    if (estatisticas) cerr << "Ciclos simulados: " << ciclos << endl;
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///MODO DE EQUIVALENCIA
+  if (!outro.empty())
+  {
+    Circuito C2;
+    if (!C2.ler(outro, erro))
+    {
+      cerr << "Erro na leitura do circuito " << outro << ": " << erro << endl;
+      return 2;
+    }
+    ResultadoEquivalencia R;
+    if (!C.verificarEquivalencia(C2, R))
+    {
+      cerr << "Os circuitos tem numeros diferentes de entradas ou de saidas" << endl;
+      return 2;
+    }
+    R.imprimir(O);
+    if (estatisticas) R.imprimir(cerr, true);
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///MODO SIMBOLICO
+  if (simbolico)
+  {
+    BddCircuito B;
+    if (!C.gerarBdd(B))
+    {
+      cerr << "Os BDDs do circuito passam do limite de nos" << endl;
+      return 4;
+    }
+    if (estatisticas) cerr << "Nos dos BDDs: " << B.getNumNos() << endl;
+    O << "Saida,TRUE,FALSE,UNDEF\n" << fixed << setprecision(0);
+    for (unsigned j=0; j<NO; j++)
+    {
+      O << 'S' << j+1 << ',' << B.contarLinhas(j, bool3S::TRUE)
+        << ',' << B.contarLinhas(j, bool3S::FALSE)
+        << ',' << B.contarLinhas(j, bool3S::UNDEF) << '\n';
+    }
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///SIMULACAO DE FALHAS
+  if (!testes.empty())
+  {
+    ifstream arqTestes(testes.c_str());
+    if (!arqTestes.is_open())
+    {
+      cerr << "Erro na abertura do arquivo " << testes << endl;
+      return 3;
+    }
+    FonteEstimulosTexto F(arqTestes);
+    vector< vector<bool3S> > vetores;
+    vector<bool3S> in(NI);
+    while (F.proximo(in)) vetores.push_back(in);
+    if (F.getErro())
+    {
+      cerr << "Erro no arquivo de vetores de teste, linha " << F.getNumLinha() << endl;
+      return 2;
+    }
+    SimuladorFalhas S;
+    if (!C.gerarFalhas(S))
+    {
+      cerr << "Erro na geracao da lista de falhas" << endl;
+      return 2;
+    }
+    if (!S.simular(vetores))
+    {
+      cerr << "Erro na simulacao de falhas (vetor com numero errado de valores)" << endl;
+      return 2;
+    }
+    S.imprimir(O, estatisticas);
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///GERACAO DE VETORES DE TESTE
+  if (coberturaTestes > 0)
+  {
+    OpcoesAtpg Op;
+    Op.coberturaAlvo = coberturaTestes/100.0;
+    ResultadoAtpg R;
+    if (!C.gerarTestes(R, Op))
+    {
+      cerr << "Erro na geracao dos vetores de teste" << endl;
+      return 2;
+    }
+    R.imprimirVetores(O);
+    if (estatisticas) R.imprimir(cerr);
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///MODO MONTE CARLO
+  if (vetoresAleatorios > 0)
+  {
+    EstatisticaSinais E;
+    if (!C.simularMonteCarlo(E, vetoresAleatorios, semente, vector<ProbabilidadeEntrada>(), tolerancia))
+    {
+      cerr << "Erro na simulacao do circuito" << endl;
+      return 4;
+    }
+    if (estatisticas)
+    {
+      cerr << "Combinacoes simuladas: " << E.getNumAmostras()
+           << "\nErro padrao maximo: " << E.getErroPadrao() << endl;
+    }
+    E.imprimirCsv(O);
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///TABELAS POR SAIDA
+  if (porSaida)
+  {
+    if (binario)
+    {
+      cerr << "As tabelas por saida soh podem ser gravadas em CSV" << endl;
+      return 1;
+    }
+    vector<TabelaSaida> tabelas;
+    if (!C.gerarTabelasSaidas(tabelas, numThreads))
+    {
+      cerr << "Erro na simulacao do circuito (suporte grande demais?)" << endl;
+      return 4;
+    }
+    if (estatisticas)
+    {
+      vector<ConeSaida> cones;
+      C.analisarCones(cones);
+      for (unsigned j=0; j<NO; j++)
+      {
+        cerr << "Saida " << j+1 << ": suporte de " << cones[j].suporte.size()
+             << " entradas, cone de " << cones[j].portas.size() << " portas" << endl;
+      }
+    }
+    string linha;
+    for (unsigned j=0; j<NO; j++)
+    {
+      const vector<unsigned>& suporte = tabelas[j].getSuporte();
+      const bool3S_vector& T = tabelas[j].getTabela();
+      if (j > 0) O << '\n';
+      for (unsigned k=0; k<suporte.size(); k++) O << 'E' << suporte[k]+1 << ',';
+      O << 'S' << j+1 << '\n';
+      // A combinacao de entrada eh avancada como um odometro, como na tabela completa
+      linha.clear();
+      for (unsigned k=0; k<suporte.size(); k++) linha += "?,";
+      for (unsigned long long L=0; L<T.size(); L++)
+      {
+        O << linha << toChar(T[L]) << '\n';
+        for (int k=int(suporte.size())-1; k>=0; k--)
+        {
+          char& c = linha[2*k];
+          c = (c=='?' ? 'F' : (c=='F' ? 'T' : '?'));
+          if (c != '?') break;
+        }
+      }
+    }
+    O.flush();
+    return (O.good() ? 0 : 3);
+  }
+
+  ///CABECALHO
+  if (binario)
+  {
+    O.write("TABELA3S", 8);
+    gravarInteiro(O, NI, 4);
+    gravarInteiro(O, NO, 4);
+    gravarInteiro(O, numLinhas, 8);
+  }
+  else
+  {
+    for (unsigned j=0; j<NI; j++) O << 'E' << j+1 << ',';
+    for (unsigned j=0; j<NO; j++) O << 'S' << j+1 << (j+1<NO ? ',' : '\n');
+  }
+
+  ///GERA E GRAVA A TABELA, UM BLOCO DE LINHAS DE CADA VEZ
+  // Os buffers sao alocados uma unica vez
+  bool3S_vector tabela(booleana ? 0 : linhasBloco*NO);
+  // Com -x, a tabela inteira eh deduzida de uma vez e gravada por partes
+  bool3S_vector completa;
+  if (booleana && !C.gerarTabelaBooleana(completa))
+  {
+    cerr << "Erro na simulacao do circuito" << endl;
+    return 4;
+  }
+  string buffer;
+  buffer.reserve(binario ? (linhasBloco*NO+3)/4 : linhasBloco*2*(NI+NO));
+  // Os caracteres da combinacao de entrada atual, jah no formato CSV ("?,?,...,")
+  // A combinacao eh avancada como um odometro
+  string entradas;
+  for (unsigned j=0; j<NI; j++) entradas += "?,";
+
+  for (unsigned long long ini=0; ini<numLinhas; ini+=linhasBloco)
+  {
+    unsigned long long fim = numLinhas-ini > linhasBloco ? ini+linhasBloco : numLinhas;
+    // As linhas da parte estao em T a partir do valor desloc
+    const bool3S_vector& T = (booleana ? completa : tabela);
+    const unsigned long long desloc = (booleana ? ini*NO : 0);
+    if (!booleana && !C.gerarFaixaTabela(ini, fim, tabela, numThreads))
+    {
+      cerr << "Erro na simulacao do circuito" << endl;
+      return 4;
+    }
+
+    buffer.clear();
+    if (binario)
+    {
+      // A tabela jah estah compactada com a mesma codificacao (32 valores por
+      // palavra): basta gravar os bytes de cada palavra em little-endian
+      // (desloc eh multiplo de 4, pois linhasBloco tambem eh)
+      unsigned long long numBytes = ((fim-ini)*NO+3)/4, b0 = desloc/4;
+      const uint64_t* palavras = T.data();
+      for (unsigned long long b=b0; b<b0+numBytes; b++)
+      {
+        buffer += char((palavras[b/8] >> 8*(b%8)) & 0xFF);
+      }
+    }
+    else
+    {
+      for (unsigned long long L=0; L<fim-ini; L++)
+      {
+        buffer += entradas;
+        for (unsigned j=0; j<NO; j++)
+        {
+          buffer += toChar(T[desloc+L*NO+j]);
+          buffer += (j+1<NO ? ',' : '\n');
+        }
+        // Proxima combinacao de entrada (ordem ? F T, a ultima varia mais rapido)
+        for (int j=NI-1; j>=0; j--)
+        {
+          char& c = entradas[2*j];
+          c = (c=='?' ? 'F' : (c=='F' ? 'T' : '?'));
+          if (c != '?') break;
+        }
+      }
+    }
+    O.write(buffer.data(), buffer.size());
+    if (!O.good())
+    {
+      cerr << "Erro na gravacao da tabela" << endl;
+      return 3;
+    }
+  }
+  O.flush();
+  return (O.good() ? 0 : 3);
+}
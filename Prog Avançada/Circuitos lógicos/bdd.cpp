@@ -0,0 +1,439 @@
+#include <algorithm>
+#include <cmath>
+#include "bdd.h"
+
+using namespace std;
+
+///######### CLASSE GERENCIADORBDD #########///
+
+// Numero maximo de entradas da cache de operacoes
+static const size_t TAMANHO_CACHE = size_t(1) << 20;
+
+// Espalhamento de tres inteiros (tabela de nos unicos e cache)
+static inline size_t espalhar3(uint32_t A, uint32_t B, uint32_t C)
+{
+  uint64_t h = (uint64_t(A) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(B) * 0xC2B2AE3D27D4EB4Full) ^
+               (uint64_t(C) * 0x165667B19E3779F9ull);
+  return size_t(h ^ (h >> 31));
+}
+
+GerenciadorBdd::GerenciadorBdd(unsigned NV, size_t MaxNos): Nvars(0), nos(), unicos(),
+  cache(), maxNos(0), estouro(false)
+{
+  clear(NV, MaxNos);
+}
+
+void GerenciadorBdd::clear(unsigned NV, size_t MaxNos)
+{
+  Nvars = NV;
+  maxNos = MaxNos;
+  estouro = false;
+  // Os terminais: a variavel deles vem depois de todas as outras
+  nos.assign(2, No());
+  nos[FALSO].var = nos[VERDADE].var = NV;
+  nos[FALSO].lo = nos[FALSO].hi = FALSO;
+  nos[VERDADE].lo = nos[VERDADE].hi = VERDADE;
+  unicos.assign(1024, 0);
+  // A cache soh eh alocada na primeira operacao (ver aplicar)
+  cache.clear();
+}
+
+void GerenciadorBdd::refazerUnicos(size_t Tam)
+{
+  unicos.assign(Tam, 0);
+  const size_t mascara = Tam-1;
+  for (uint32_t U=2; U<nos.size(); U++)
+  {
+    size_t pos = espalhar3(nos[U].var, nos[U].lo, nos[U].hi) & mascara;
+    while (unicos[pos] != 0) pos = (pos+1) & mascara;
+    unicos[pos] = U;
+  }
+}
+
+uint32_t GerenciadorBdd::criarNo(uint32_t V, uint32_t Lo, uint32_t Hi)
+{
+  // Reducao: um no com os dois filhos iguais eh desnecessario
+  if (Lo == Hi) return Lo;
+  size_t mascara = unicos.size()-1;
+  size_t pos = espalhar3(V, Lo, Hi) & mascara;
+  while (unicos[pos] != 0)
+  {
+    const No& N = nos[unicos[pos]];
+    if (N.var==V && N.lo==Lo && N.hi==Hi) return unicos[pos];
+    pos = (pos+1) & mascara;
+  }
+  if (nos.size() >= maxNos)
+  {
+    estouro = true;
+    return FALSO;
+  }
+  No N = {V, Lo, Hi};
+  nos.push_back(N);
+  uint32_t U = nos.size()-1;
+  if (2*nos.size() > unicos.size()) refazerUnicos(2*unicos.size());
+  else unicos[pos] = U;
+  return U;
+}
+
+uint32_t GerenciadorBdd::variavel(unsigned V)
+{
+  return criarNo(V, FALSO, VERDADE);
+}
+
+uint32_t GerenciadorBdd::aplicar(uint32_t Op, uint32_t A, uint32_t B)
+{
+  // Casos terminais (AND: Op=0; OR: Op=1)
+  if (Op == 0)
+  {
+    if (A==FALSO || B==FALSO) return FALSO;
+    if (A==VERDADE) return B;
+    if (B==VERDADE || A==B) return A;
+  }
+  else
+  {
+    if (A==VERDADE || B==VERDADE) return VERDADE;
+    if (A==FALSO) return B;
+    if (B==FALSO || A==B) return A;
+  }
+  if (estouro) return FALSO;
+  // As duas operacoes sao comutativas
+  if (A > B) swap(A, B);
+
+  if (cache.empty())
+  {
+    // Uma entrada por no possivel (potencia de 2), ateh TAMANHO_CACHE
+    size_t tam = 1024;
+    while (tam < maxNos && tam < TAMANHO_CACHE) tam *= 2;
+    Calculado vazio = {0, 0, ~0u, 0};
+    cache.assign(tam, vazio);
+  }
+  Calculado& C = cache[espalhar3(Op, A, B) & (cache.size()-1)];
+  if (C.op==Op && C.a==A && C.b==B) return C.r;
+
+  // Decomposicao de Shannon pela menor variavel de A e B
+  const uint32_t V = min(nos[A].var, nos[B].var);
+  const uint32_t A0 = (nos[A].var==V ? nos[A].lo : A), A1 = (nos[A].var==V ? nos[A].hi : A);
+  const uint32_t B0 = (nos[B].var==V ? nos[B].lo : B), B1 = (nos[B].var==V ? nos[B].hi : B);
+  const uint32_t R0 = aplicar(Op, A0, B0);
+  const uint32_t R1 = aplicar(Op, A1, B1);
+  const uint32_t R = criarNo(V, R0, R1);
+
+  // A cache nunca eh redimensionada: C continua valida depois da recursao
+  C.op = Op;
+  C.a = A;
+  C.b = B;
+  C.r = R;
+  return R;
+}
+
+///######### CLASSE BDDCIRCUITO #########///
+
+BddCircuito::BddCircuito(): G(), Nin(0), ordem(), posicao(), saidaT(), saidaF() {}
+
+bool BddCircuito::construir(const Netlist& N, ordemVariaveis H, size_t MaxNos)
+{
+  const unsigned NI = N.getNumInputs();
+
+  ///AS ORDENS DAS ENTRADAS
+  vector< vector<unsigned> > ordens;
+  if (H==ordemVariaveis::NATURAL || H==ordemVariaveis::MELHOR)
+  {
+    vector<unsigned> O(NI);
+    for (unsigned i=0; i<NI; i++) O[i] = i;
+    ordens.push_back(O);
+  }
+  if (H==ordemVariaveis::PROFUNDIDADE || H==ordemVariaveis::MELHOR)
+  {
+    // Busca em profundidade a partir das saidas, na ordem das entradas das portas
+    vector<unsigned> O;
+    vector<uint8_t> visitado(N.getNumSinais(), 0);
+    vector<unsigned> pilha;
+    for (unsigned j=0; j<N.getNumOutputs(); j++)
+    {
+      pilha.push_back(N.getSaida(j));
+      while (!pilha.empty())
+      {
+        unsigned s = pilha.back();
+        pilha.pop_back();
+        if (visitado[s]) continue;
+        visitado[s] = 1;
+        if (s < NI)
+        {
+          O.push_back(s);
+          continue;
+        }
+        // As entradas sao empilhadas de tras para frente: a primeira eh visitada antes
+        const unsigned* in = N.getFanin(s-NI);
+        for (unsigned k=N.getNumFanin(s-NI); k-- > 0; )
+        {
+          if (!visitado[in[k]]) pilha.push_back(in[k]);
+        }
+      }
+    }
+    // As entradas que nao alcancam nenhuma saida vao para o final
+    for (unsigned i=0; i<NI; i++) if (!visitado[i]) O.push_back(i);
+    ordens.push_back(O);
+  }
+  if (H==ordemVariaveis::FANOUT || H==ordemVariaveis::MELHOR)
+  {
+    vector<unsigned> O(NI);
+    for (unsigned i=0; i<NI; i++) O[i] = i;
+    stable_sort(O.begin(), O.end(), [&N](unsigned a, unsigned b) {
+      return N.getNumFanout(a) > N.getNumFanout(b);
+    });
+    ordens.push_back(O);
+  }
+
+  ///CONSTROI COM CADA ORDEM E FICA COM A MENOR
+  // Cada tentativa eh limitada ao tamanho da melhor ateh agora
+  vector<unsigned> melhor;
+  size_t limite = MaxNos;
+  for (unsigned k=0; k<ordens.size(); k++)
+  {
+    if (construirOrdem(N, ordens[k], limite))
+    {
+      melhor = ordens[k];
+      limite = G.getNumNos();
+    }
+  }
+  if (melhor.empty())
+  {
+    G.clear(0, MaxNos);
+    Nin = 0;
+    ordem.clear();
+    posicao.clear();
+    saidaT.clear();
+    saidaF.clear();
+    return false;
+  }
+  if (melhor != ordem) construirOrdem(N, melhor, MaxNos);
+  return true;
+}
+
+bool BddCircuito::construirOrdem(const Netlist& N, const std::vector<unsigned>& Ordem, size_t MaxNos)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais();
+  G.clear(2*NI, MaxNos);
+  Nin = NI;
+  ordem = Ordem;
+  posicao.assign(NI, 0);
+  for (unsigned k=0; k<NI; k++) posicao[ordem[k]] = k;
+  saidaT.clear();
+  saidaF.clear();
+
+  // Os BDDs T e F de cada sinal; as entradas sao as suas variaveis dual-rail
+  vector<uint32_t> T(NS, GerenciadorBdd::FALSO), F(NS, GerenciadorBdd::FALSO);
+  for (unsigned i=0; i<NI; i++)
+  {
+    T[i] = G.variavel(2*posicao[i]);
+    F[i] = G.variavel(2*posicao[i]+1);
+  }
+
+  // Soh as portas que alcancam alguma saida sao construidas
+  vector<uint32_t> util;
+  N.marcarObservaveis(util);
+
+  // Calcula T e F da porta P a partir dos valores atuais das suas entradas
+  // Retorna true se algum dos dois mudou
+  auto avaliarPorta = [&](unsigned P) {
+    const unsigned* in = N.getFanin(P);
+    const unsigned n = N.getNumFanin(P);
+    tipoPorta Tipo = N.getTipo(P);
+    uint32_t t = T[in[0]], f = F[in[0]];
+    for (unsigned k=1; k<n; k++)
+    {
+      const uint32_t tb = T[in[k]], fb = F[in[k]];
+      switch (Tipo)
+      {
+      case tipoPorta::AN: case tipoPorta::NA:
+        t = G.e(t, tb);
+        f = G.ou(f, fb);
+        break;
+      case tipoPorta::OR: case tipoPorta::NO:
+        t = G.ou(t, tb);
+        f = G.e(f, fb);
+        break;
+      default:
+      {
+        uint32_t t2 = G.ou(G.e(t, fb), G.e(f, tb));
+        uint32_t f2 = G.ou(G.e(t, tb), G.e(f, fb));
+        t = t2;
+        f = f2;
+        break;
+      }
+      }
+    }
+    if (Tipo==tipoPorta::NT || Tipo==tipoPorta::NA || Tipo==tipoPorta::NO || Tipo==tipoPorta::NX) swap(t, f);
+    const unsigned s = NI+P;
+    bool mudou = (T[s] != t || F[s] != f);
+    T[s] = t;
+    F[s] = f;
+    return mudou;
+  };
+
+  for (unsigned c=0; c<N.getNumComponentes() && !G.getEstouro(); c++)
+  {
+    const unsigned* portas = N.getPortasComponente(c);
+    const unsigned tam = N.getTamanhoComponente(c);
+    if (!util[NI+portas[0]]) continue;
+    if (!N.getCiclica(c))
+    {
+      avaliarPorta(portas[0]);
+      continue;
+    }
+    // Laco de realimentacao: a partir de todas UNDEF (T = F = FALSO), repete ateh
+    // que nada mude. As funcoes sao monotonas (um valor definido nunca volta a
+    // ser UNDEF), de modo que ha no maximo 2*tam+1 repeticoes
+    bool mudou = true;
+    while (mudou && !G.getEstouro())
+    {
+      mudou = false;
+      for (unsigned k=0; k<tam; k++) mudou = avaliarPorta(portas[k]) || mudou;
+    }
+  }
+  if (G.getEstouro()) return false;
+
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    saidaT.push_back(T[N.getSaida(j)]);
+    saidaF.push_back(F[N.getSaida(j)]);
+  }
+  return true;
+}
+
+/// ***********************
+/// Consultas
+/// ***********************
+
+bool BddCircuito::avaliarBdd(uint32_t U, const std::vector<bool3S>& In) const
+{
+  while (U > GerenciadorBdd::VERDADE)
+  {
+    const uint32_t V = G.getVar(U);
+    const bool3S x = In[ordem[V/2]];
+    // Variavel par: x eh TRUE; impar: x eh FALSE
+    const bool b = (V%2==0 ? x==bool3S::TRUE : x==bool3S::FALSE);
+    U = (b ? G.getHi(U) : G.getLo(U));
+  }
+  return U == GerenciadorBdd::VERDADE;
+}
+
+bool3S BddCircuito::avaliar(unsigned J, const std::vector<bool3S>& In) const
+{
+  if (avaliarBdd(saidaT[J], In)) return bool3S::TRUE;
+  if (avaliarBdd(saidaF[J], In)) return bool3S::FALSE;
+  return bool3S::UNDEF;
+}
+
+void BddCircuito::avaliar(const std::vector<bool3S>& In, std::vector<bool3S>& Out) const
+{
+  Out.resize(getNumOutputs());
+  for (unsigned j=0; j<getNumOutputs(); j++) Out[j] = avaliar(j, In);
+}
+
+double BddCircuito::contar(uint32_t U, unsigned K, std::vector<double>& Memo) const
+{
+  // As entradas puladas (de K ateh a entrada testada em U) podem ter qualquer
+  // um dos 3 valores
+  const unsigned KU = G.getVar(U)/2;
+  const double fator = pow(3.0, double(KU-K));
+  if (U == GerenciadorBdd::FALSO) return 0.0;
+  if (U == GerenciadorBdd::VERDADE) return fator;
+  if (Memo[U] >= 0.0) return fator*Memo[U];
+
+  const uint32_t V = G.getVar(U);
+  double c;
+  if (V%2 == 0)
+  {
+    // x_T = 1: x_F deve ser 0
+    uint32_t hi = G.getHi(U);
+    if (G.getVar(hi) == V+1) hi = G.getLo(hi);
+    c = contar(hi, KU+1, Memo);
+    // x_T = 0: x_F pode ser 0 (UNDEF) ou 1 (FALSE)
+    uint32_t lo = G.getLo(U);
+    if (G.getVar(lo) == V+1) c += contar(G.getLo(lo), KU+1, Memo) + contar(G.getHi(lo), KU+1, Memo);
+    else c += 2.0*contar(lo, KU+1, Memo);
+  }
+  else
+  {
+    // U nao depende de x_T: x_F = 0 com x_T = 0 ou 1 (UNDEF ou TRUE); x_F = 1 (FALSE)
+    c = 2.0*contar(G.getLo(U), KU+1, Memo) + contar(G.getHi(U), KU+1, Memo);
+  }
+  Memo[U] = c;
+  return fator*c;
+}
+
+double BddCircuito::contarLinhas(unsigned J, bool3S V) const
+{
+  vector<double> memo(G.getNumNos(), -1.0);
+  double t = contar(saidaT[J], 0, memo);
+  if (V == bool3S::TRUE) return t;
+  double f = contar(saidaF[J], 0, memo);
+  if (V == bool3S::FALSE) return f;
+  return pow(3.0, double(Nin)) - t - f;
+}
+
+bool BddCircuito::gerarTabela(bool3S_vector& tabela) const
+{
+  const unsigned NO = getNumOutputs();
+  // Numero de linhas (3^Nin) e o peso de cada entrada no numero da linha
+  // (a ultima entrada varia mais rapido)
+  vector<unsigned long long> peso(Nin);
+  unsigned long long numLinhas = 1;
+  for (unsigned i=Nin; i-- > 0; )
+  {
+    peso[i] = numLinhas;
+    if (numLinhas > ~0ull/3) return false;
+    numLinhas *= 3;
+  }
+  if (Nin == 0) return false;
+  tabela.assign(numLinhas*NO, bool3S::UNDEF);
+
+  // Busca em profundidade pelas entradas, na ordem das variaveis: no nivel k,
+  // no[k] guarda os nos de todos os BDDs (T e F de cada saida) restritos aos
+  // valores jah escolhidos das entradas ordem[0] a ordem[k-1]. Cada linha custa
+  // O(numero de saidas), qualquer que seja a ordem das variaveis
+  vector< vector<uint32_t> > no(Nin+1, vector<uint32_t>(2*NO));
+  for (unsigned j=0; j<NO; j++)
+  {
+    no[0][2*j] = saidaT[j];
+    no[0][2*j+1] = saidaF[j];
+  }
+  vector<unsigned> valor(Nin+1, 0);
+  vector<unsigned long long> linha(Nin+1, 0);
+  unsigned k = 0;
+  while (true)
+  {
+    if (k == Nin)
+    {
+      // Uma linha completa
+      const unsigned long long L = linha[k];
+      for (unsigned j=0; j<NO; j++)
+      {
+        bool3S v = bool3S::UNDEF;
+        if (no[k][2*j] == GerenciadorBdd::VERDADE) v = bool3S::TRUE;
+        else if (no[k][2*j+1] == GerenciadorBdd::VERDADE) v = bool3S::FALSE;
+        tabela[L*NO+j] = v;
+      }
+      // Volta ao ultimo nivel que ainda tem valores por tentar
+      while (k > 0 && valor[k-1] == 2) k--;
+      if (k == 0) break;
+      valor[k-1]++;
+      k--;
+    }
+    // Aplica o valor valor[k] (UNDEF, FALSE, TRUE) da entrada ordem[k]
+    const unsigned v = valor[k];
+    const uint32_t VT = 2*k, VF = 2*k+1;
+    for (unsigned m=0; m<2*NO; m++)
+    {
+      uint32_t U = no[k][m];
+      if (G.getVar(U) == VT) U = (v==2 ? G.getHi(U) : G.getLo(U));
+      if (G.getVar(U) == VF) U = (v==1 ? G.getHi(U) : G.getLo(U));
+      no[k+1][m] = U;
+    }
+    linha[k+1] = linha[k] + v*peso[ordem[k]];
+    k++;
+    valor[k] = 0;
+  }
+  return true;
+}
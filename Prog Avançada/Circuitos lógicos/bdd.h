@@ -0,0 +1,162 @@
+#ifndef _BDD_H_
+#define _BDD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_vector.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// BDD (DIAGRAMAS DE DECISAO BINARIA REDUZIDOS E ORDENADOS)
+///
+/// GerenciadorBdd: os nos de todos os BDDs ficam numa unica tabela de nos
+/// unicos (dois nos com a mesma variavel e os mesmos filhos sao o mesmo no), de
+/// modo que duas funcoes sao iguais se e somente se os seus BDDs sao o mesmo
+/// no. As operacoes (AND e OR) usam uma cache de resultados ja calculados.
+/// Nao ha liberacao de nos: o gerenciador eh usado para construir os BDDs de
+/// um circuito e descartado junto com eles.
+///
+/// BddCircuito: avaliacao simbolica de um circuito na logica de 3 estados.
+/// Cada entrada x do circuito eh representada por duas variaveis booleanas
+/// ("dual-rail"): x_T (x eh TRUE) e x_F (x eh FALSE); x eh UNDEF quando as duas
+/// sao 0 (as duas em 1 eh uma combinacao invalida, nunca usada). Cada sinal eh
+/// representado por dois BDDs, T (conjunto das combinacoes de entrada em que o
+/// sinal eh TRUE) e F (em que eh FALSE); nas demais combinacoes ele eh UNDEF:
+///   NOT:  T = F(a)             F = T(a)
+///   AND:  T = T(a).T(b)        F = F(a)+F(b)
+///   OR:   T = T(a)+T(b)        F = F(a).F(b)
+///   XOR:  T = T(a).F(b)+F(a).T(b)    F = T(a).T(b)+F(a).F(b)
+/// Essas regras sao as mesmas de bool3S aplicadas ponto a ponto, de modo que
+/// os BDDs dao exatamente as saidas de Circuito::simular, UNDEF inclusive.
+/// As portas em lacos de realimentacao sao calculadas como na simulacao: a
+/// partir de todas UNDEF (T = F = vazio), repetindo ateh que nada mude.
+///
+/// As duas variaveis de uma entrada ficam sempre juntas na ordem das variaveis
+/// (x_T imediatamente antes de x_F); a ordem das entradas eh escolhida por
+/// heuristica (ordemVariaveis).
+/// ###########################################################################
+
+class GerenciadorBdd {
+private:
+  // Um no: a variavel testada e os filhos (lo: variavel em 0; hi: variavel em 1)
+  struct No {
+    uint32_t var, lo, hi;
+  };
+  // Uma entrada da cache de operacoes
+  struct Calculado {
+    uint32_t a, b, op, r;
+  };
+
+  // Numero de variaveis
+  unsigned Nvars;
+  // Os nos (0: terminal FALSO; 1: terminal VERDADE)
+  std::vector<No> nos;
+  // A tabela de nos unicos (enderecamento aberto): guarda o indice do no (0: livre)
+  std::vector<uint32_t> unicos;
+  // A cache de operacoes (mapeamento direto, com perdas), alocada na primeira operacao
+  std::vector<Calculado> cache;
+  // O numero maximo de nos e se ele foi ultrapassado
+  size_t maxNos;
+  bool estouro;
+
+  // Redimensiona a tabela de nos unicos e reinsere os nos
+  void refazerUnicos(size_t Tam);
+  // Retorna o no (V, Lo, Hi), criando-o se necessario
+  uint32_t criarNo(uint32_t V, uint32_t Lo, uint32_t Hi);
+  // Aplica a operacao Op (0: AND; 1: OR)
+  uint32_t aplicar(uint32_t Op, uint32_t A, uint32_t B);
+
+public:
+  // Os terminais
+  static constexpr uint32_t FALSO = 0;
+  static constexpr uint32_t VERDADE = 1;
+
+  // Cria um gerenciador com NV variaveis, que pode ter no maximo MaxNos nos
+  explicit GerenciadorBdd(unsigned NV=0, size_t MaxNos=10000000);
+  // Descarta todos os nos
+  void clear(unsigned NV, size_t MaxNos);
+
+  // O BDD da variavel V (de 0 a Nvars-1): a ordem das variaveis eh a numerica
+  uint32_t variavel(unsigned V);
+
+  // As operacoes. Se o numero maximo de nos for ultrapassado, o resultado eh
+  // invalido (ver getEstouro)
+  uint32_t e(uint32_t A, uint32_t B) {return aplicar(0, A, B);}
+  uint32_t ou(uint32_t A, uint32_t B) {return aplicar(1, A, B);}
+
+  // true se o numero maximo de nos foi ultrapassado em alguma operacao
+  bool getEstouro() const {return estouro;}
+  unsigned getNumVars() const {return Nvars;}
+  size_t getNumNos() const {return nos.size();}
+
+  // Caracteristicas do no U (para os terminais, a variavel eh Nvars)
+  uint32_t getVar(uint32_t U) const {return nos[U].var;}
+  uint32_t getLo(uint32_t U) const {return nos[U].lo;}
+  uint32_t getHi(uint32_t U) const {return nos[U].hi;}
+};
+
+// As heuristicas de ordem das entradas do circuito
+enum class ordemVariaveis : uint8_t {
+  NATURAL=0,      // a ordem das entradas (-1, -2, ...)
+  PROFUNDIDADE=1, // a ordem em que as entradas sao encontradas numa busca em
+                  // profundidade a partir das saidas (entradas que alimentam a
+                  // mesma parte do circuito ficam proximas)
+  FANOUT=2,       // as entradas que alimentam mais portas primeiro
+  MELHOR=3        // tenta as tres anteriores e fica com a de menos nos
+};
+
+class BddCircuito {
+private:
+  GerenciadorBdd G;
+  // Numero de entradas do circuito
+  unsigned Nin;
+  // ordem[k]: a entrada do circuito cujas variaveis sao 2k (x_T) e 2k+1 (x_F)
+  // posicao[i]: o k da entrada i
+  std::vector<unsigned> ordem, posicao;
+  // Os BDDs T e F de cada saida do circuito
+  std::vector<uint32_t> saidaT, saidaF;
+
+  // Constroi os BDDs com uma ordem dada (usada por construir)
+  bool construirOrdem(const Netlist& N, const std::vector<unsigned>& Ordem, size_t MaxNos);
+  // Avalia o BDD U com os valores das entradas In (percurso da raiz ao terminal)
+  bool avaliarBdd(uint32_t U, const std::vector<bool3S>& In) const;
+  // Numero de combinacoes de entrada (das variaveis 2k em diante) em que U eh
+  // VERDADE, para um no U com variavel >= 2k (usada por contarLinhas)
+  double contar(uint32_t U, unsigned K, std::vector<double>& Memo) const;
+
+public:
+  BddCircuito();
+
+  // Constroi os BDDs das saidas da netlist N (que deve estar montada), com a
+  // ordem das entradas dada pela heuristica H
+  // Retorna false (e deixa os BDDs vazios) se forem necessarios mais de MaxNos nos
+  bool construir(const Netlist& N, ordemVariaveis H=ordemVariaveis::MELHOR,
+                 size_t MaxNos=10000000);
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumOutputs() const {return saidaT.size();}
+  // Numero total de nos (de todas as saidas, compartilhados)
+  size_t getNumNos() const {return G.getNumNos();}
+  // A ordem das entradas usada: ordem[k] eh o indice (de 0 a Nin-1) da k-esima entrada
+  const std::vector<unsigned>& getOrdem() const {return ordem;}
+
+  // O valor da saida J (de 0 a Nout-1) para os valores de entrada In
+  // Percorre no maximo 2*Nin nos, sem simular nenhuma porta
+  bool3S avaliar(unsigned J, const std::vector<bool3S>& In) const;
+  // Os valores de todas as saidas (Out eh redimensionado)
+  void avaliar(const std::vector<bool3S>& In, std::vector<bool3S>& Out) const;
+
+  // Numero de linhas da tabela verdade (das 3^Nin) em que a saida J vale V,
+  // calculado diretamente sobre o BDD (sem percorrer as linhas)
+  // Em ponto flutuante: exato enquanto o resultado couber em 53 bits
+  double contarLinhas(unsigned J, bool3S V) const;
+
+  // Gera a tabela verdade completa a partir dos BDDs (mesmo formato de
+  // Circuito::gerarTabela)
+  // Retorna false se o numero de linhas nao couber em um unsigned long long
+  bool gerarTabela(bool3S_vector& tabela) const;
+};
+
+#endif // _BDD_H_
@@ -127,7 +127,7 @@ char toChar(bool3S B)
 }
 
 // Converte um char (F T ?) para o bool3S correspondente
-bool3S toBool_3S(char C)
+bool3S toBool3S(char C)
 {
   C = toupper(C);
   if (C=='T') return bool3S::TRUE;
@@ -149,6 +149,6 @@ istream& operator>>(istream& I, bool3S& B)
 {
   char prov;
   I >> prov;
-  B = toBool_3S(prov);
+  B = toBool3S(prov);
   return I;
 }
@@ -1,11 +1,13 @@
 #ifndef _BOOL3S_H_
 #define _BOOL3S_H_
 
+#include <cstdint>
 #include <iostream>
 
 // Criando um tipo de dados enumerado (bool3S) para representar um booleano com 3 estados:
 // bool3S::TRUE, bool3S::FALSE e bool3S::UNDEF
-enum class bool3S {
+// Cada valor ocupa um unico byte; para armazenar muitos valores, ver bool3S_vector
+enum class bool3S : uint8_t {
   UNDEF,
   FALSE,
   TRUE
@@ -0,0 +1,103 @@
+#ifndef _BOOL3S_64_H_
+#define _BOOL3S_64_H_
+
+#include <cstdint>
+#include "bool3S.h"
+
+// Um tipo de dados (bool3S_64) que representa 64 valores bool3S independentes,
+// usado para simular 64 combinacoes de entrada de uma so vez (simulacao bit-paralela)
+// Cada valor ocupa um bit em cada um de dois planos de 64 bits:
+// - def: o bit vale 1 se o valor estah definido (FALSE ou TRUE) e 0 se eh UNDEF
+// - val: o bit vale 1 se o valor eh TRUE
+// Os operadores sempre mantem val contido em def (bit de val eh 0 se o valor eh UNDEF),
+// o que permite comparar dois bool3S_64 diretamente pelos planos
+struct bool3S_64 {
+  uint64_t val;
+  uint64_t def;
+
+  // Construtor default: os 64 valores sao UNDEF
+  bool3S_64(): val(0), def(0) {}
+  // Construtor a partir dos planos
+  bool3S_64(uint64_t V, uint64_t D): val(V & D), def(D) {}
+  // Construtor a partir de um bool3S: os 64 valores iguais a B
+  explicit bool3S_64(bool3S B):
+    val(B==bool3S::TRUE ? ~uint64_t(0) : 0),
+    def(B==bool3S::UNDEF ? 0 : ~uint64_t(0)) {}
+
+  // Retorna o K-esimo valor (K de 0 a 63)
+  bool3S get(unsigned K) const
+  {
+    if (!((def>>K) & 1)) return bool3S::UNDEF;
+    return ((val>>K) & 1) ? bool3S::TRUE : bool3S::FALSE;
+  }
+
+  // Fixa o K-esimo valor (K de 0 a 63)
+  void set(unsigned K, bool3S B)
+  {
+    uint64_t mask = uint64_t(1)<<K;
+    val &= ~mask;
+    def &= ~mask;
+    if (B!=bool3S::UNDEF) def |= mask;
+    if (B==bool3S::TRUE) val |= mask;
+  }
+};
+
+// Os operadores logicos para a classe bool3S_64
+// Equivalem aos operadores de bool3S aplicados a cada um dos 64 valores
+// Sao definidos inline porque sao chamados no laco mais interno da simulacao
+
+// NOT 3S
+inline bool3S_64 operator~(bool3S_64 x)
+{
+  return bool3S_64(~x.val, x.def);
+}
+
+// AND 3S: FALSE se alguma entrada eh FALSE; TRUE se as duas sao TRUE
+inline bool3S_64 operator&(bool3S_64 x1, bool3S_64 x2)
+{
+  uint64_t f = (x1.def & ~x1.val) | (x2.def & ~x2.val);
+  uint64_t t = x1.val & x2.val;
+  return bool3S_64(t, t|f);
+}
+
+inline void operator&=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 & x2;
+}
+
+// OR 3S: TRUE se alguma entrada eh TRUE; FALSE se as duas sao FALSE
+inline bool3S_64 operator|(bool3S_64 x1, bool3S_64 x2)
+{
+  uint64_t t = x1.val | x2.val;
+  uint64_t f = (x1.def & ~x1.val) & (x2.def & ~x2.val);
+  return bool3S_64(t, t|f);
+}
+
+inline void operator|=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 | x2;
+}
+
+// XOR 3S: UNDEF se alguma entrada eh UNDEF
+inline bool3S_64 operator^(bool3S_64 x1, bool3S_64 x2)
+{
+  return bool3S_64(x1.val ^ x2.val, x1.def & x2.def);
+}
+
+inline void operator^=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 ^ x2;
+}
+
+// Comparacao (os 64 valores iguais)
+inline bool operator==(bool3S_64 x1, bool3S_64 x2)
+{
+  return x1.val==x2.val && x1.def==x2.def;
+}
+
+inline bool operator!=(bool3S_64 x1, bool3S_64 x2)
+{
+  return !(x1==x2);
+}
+
+#endif // _BOOL3S_64_H_
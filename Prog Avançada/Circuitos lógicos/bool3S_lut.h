@@ -0,0 +1,167 @@
+#ifndef _BOOL3S_LUT_H_
+#define _BOOL3S_LUT_H_
+
+#include <cstdint>
+#include "bool3S.h"
+
+// Avaliacao de portas bool3S por tabelas (lookup tables), sem desvios
+//
+// Cada bool3S eh codificado em 2 bits pelo seu proprio valor no enum
+// (UNDEF=0, FALSE=1, TRUE=2). As operacoes de 2 operandos sao tabelas de 16
+// posicoes indexadas por (a<<2)|b (as posicoes com o codigo 3 nao sao usadas).
+// Tudo eh constexpr e inline, para que o compilador possa expandir as portas
+// pequenas (1 a 4 entradas) sem nenhuma chamada de funcao.
+
+// Os tipos de porta
+enum class tipoPorta : uint8_t {
+  NT, AN, NA, OR, NO, XO, NX
+};
+
+namespace lut3S {
+
+/// ***********************
+/// Codificacao
+/// ***********************
+
+// Converte um bool3S para o seu codigo de 2 bits e vice-versa
+constexpr uint8_t codigo(bool3S B) {return uint8_t(B);}
+constexpr bool3S valor(uint8_t C) {return bool3S(C);}
+
+/// ***********************
+/// Tabelas
+/// ***********************
+
+// Abreviaturas dos codigos, soh para deixar as tabelas legiveis
+constexpr uint8_t U_ = 0, F_ = 1, T_ = 2;
+
+// NOT: indexada pelo codigo
+constexpr uint8_t TAB_NOT[4] = {U_, T_, F_, U_};
+
+// AND, OR e XOR: indexadas por (a<<2)|b
+//                              b=  U   F   T   -
+constexpr uint8_t TAB_AND[16] = {  U_, F_, U_, U_,    // a=U
+                                   F_, F_, F_, U_,    // a=F
+                                   U_, F_, T_, U_,    // a=T
+                                   U_, U_, U_, U_ };
+constexpr uint8_t TAB_OR[16]  = {  U_, U_, T_, U_,
+                                   U_, F_, T_, U_,
+                                   T_, T_, T_, U_,
+                                   U_, U_, U_, U_ };
+constexpr uint8_t TAB_XOR[16] = {  U_, U_, U_, U_,
+                                   U_, F_, T_, U_,
+                                   U_, T_, F_, U_,
+                                   U_, U_, U_, U_ };
+
+// As operacoes sobre codigos
+constexpr uint8_t opNOT(uint8_t A) {return TAB_NOT[A];}
+constexpr uint8_t opAND(uint8_t A, uint8_t B) {return TAB_AND[(A<<2)|B];}
+constexpr uint8_t opOR(uint8_t A, uint8_t B) {return TAB_OR[(A<<2)|B];}
+constexpr uint8_t opXOR(uint8_t A, uint8_t B) {return TAB_XOR[(A<<2)|B];}
+
+// As mesmas operacoes sobre bool3S (equivalentes aos operadores ~ & | ^ de bool3S.h)
+constexpr bool3S NOT(bool3S A) {return valor(opNOT(codigo(A)));}
+constexpr bool3S AND(bool3S A, bool3S B) {return valor(opAND(codigo(A), codigo(B)));}
+constexpr bool3S OR(bool3S A, bool3S B) {return valor(opOR(codigo(A), codigo(B)));}
+constexpr bool3S XOR(bool3S A, bool3S B) {return valor(opXOR(codigo(A), codigo(B)));}
+
+/// ***********************
+/// Caracteristicas de cada tipo de porta
+/// ***********************
+
+// operar: a operacao que combina as entradas
+// inverte: se a saida eh negada no final
+template <tipoPorta T> struct Porta;
+
+template <> struct Porta<tipoPorta::NT> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opAND(A,B);}
+  static constexpr bool inverte = true;
+};
+template <> struct Porta<tipoPorta::AN> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opAND(A,B);}
+  static constexpr bool inverte = false;
+};
+template <> struct Porta<tipoPorta::NA> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opAND(A,B);}
+  static constexpr bool inverte = true;
+};
+template <> struct Porta<tipoPorta::OR> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opOR(A,B);}
+  static constexpr bool inverte = false;
+};
+template <> struct Porta<tipoPorta::NO> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opOR(A,B);}
+  static constexpr bool inverte = true;
+};
+template <> struct Porta<tipoPorta::XO> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opXOR(A,B);}
+  static constexpr bool inverte = false;
+};
+template <> struct Porta<tipoPorta::NX> {
+  static constexpr uint8_t operar(uint8_t A, uint8_t B) {return opXOR(A,B);}
+  static constexpr bool inverte = true;
+};
+
+/// ***********************
+/// Avaliadores de porta
+/// ***********************
+
+// Combina as N primeiras entradas de uma porta do tipo T, cujas entradas sao os
+// sinais In[0] a In[N-1], a partir dos valores V de todos os sinais
+// A recursao eh resolvida em tempo de compilacao: para N fixo, o resultado eh
+// uma sequencia de N-1 consultas a tabela
+template <tipoPorta T, unsigned N> struct Combinar {
+  static inline uint8_t aplicar(const bool3S* V, const unsigned* In) {
+    return Porta<T>::operar(Combinar<T,N-1>::aplicar(V,In), codigo(V[In[N-1]]));
+  }
+};
+template <tipoPorta T> struct Combinar<T,1> {
+  static inline uint8_t aplicar(const bool3S* V, const unsigned* In) {
+    return codigo(V[In[0]]);
+  }
+};
+
+// Saida de uma porta do tipo T com exatamente N entradas
+template <tipoPorta T, unsigned N>
+inline bool3S avaliar(const bool3S* V, const unsigned* In)
+{
+  uint8_t out = Combinar<T,N>::aplicar(V, In);
+  return valor(Porta<T>::inverte ? opNOT(out) : out);
+}
+
+// Saida de uma porta do tipo T com um numero qualquer (N>=1) de entradas
+template <tipoPorta T>
+inline bool3S avaliar(const bool3S* V, const unsigned* In, unsigned N)
+{
+  switch (N)
+  {
+  case 1: return avaliar<T,1>(V, In);
+  case 2: return avaliar<T,2>(V, In);
+  case 3: return avaliar<T,3>(V, In);
+  case 4: return avaliar<T,4>(V, In);
+  default:
+    break;
+  }
+  uint8_t out = Combinar<T,4>::aplicar(V, In);
+  for (unsigned i=4; i<N; i++) out = Porta<T>::operar(out, codigo(V[In[i]]));
+  return valor(Porta<T>::inverte ? opNOT(out) : out);
+}
+
+// Saida de uma porta de tipo T qualquer (escolhido em tempo de execucao)
+inline bool3S avaliar(tipoPorta T, const bool3S* V, const unsigned* In, unsigned N)
+{
+  switch (T)
+  {
+  case tipoPorta::NT: return avaliar<tipoPorta::NT>(V, In, N);
+  case tipoPorta::AN: return avaliar<tipoPorta::AN>(V, In, N);
+  case tipoPorta::NA: return avaliar<tipoPorta::NA>(V, In, N);
+  case tipoPorta::OR: return avaliar<tipoPorta::OR>(V, In, N);
+  case tipoPorta::NO: return avaliar<tipoPorta::NO>(V, In, N);
+  case tipoPorta::XO: return avaliar<tipoPorta::XO>(V, In, N);
+  case tipoPorta::NX: return avaliar<tipoPorta::NX>(V, In, N);
+  }
+  return bool3S::UNDEF;
+}
+
+} // namespace lut3S
+
+#endif // _BOOL3S_LUT_H_
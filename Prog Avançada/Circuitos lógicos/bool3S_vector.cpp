@@ -0,0 +1,67 @@
+#include "bool3S_vector.h"
+#include "kernel3S.h"
+
+void bool3S_vector::limparSobra()
+{
+  unsigned resto = N%POR_PALAVRA;
+  if (resto != 0) palavras.back() &= (uint64_t(1) << 2*resto) - 1;
+}
+
+void bool3S_vector::resize(size_t Num, bool3S B)
+{
+  size_t antigo = N;
+  palavras.resize(numPalavrasPara(Num), padrao(B));
+  N = Num;
+  // A sobra da antiga ultima palavra era 0 (UNDEF); os novos valores devem ser B
+  if (Num > antigo && B != bool3S::UNDEF)
+  {
+    size_t fim = numPalavrasPara(antigo)*POR_PALAVRA;
+    fill(antigo, (Num < fim ? Num : fim), B);
+  }
+  limparSobra();
+}
+
+void bool3S_vector::assign(size_t Num, bool3S B)
+{
+  palavras.assign(numPalavrasPara(Num), padrao(B));
+  N = Num;
+  limparSobra();
+}
+
+void bool3S_vector::fill(bool3S B)
+{
+  for (size_t k=0; k<palavras.size(); k++) palavras[k] = padrao(B);
+  limparSobra();
+}
+
+void bool3S_vector::fill(size_t Ini, size_t Fim, bool3S B)
+{
+  if (Fim > N) Fim = N;
+  uint64_t p = padrao(B);
+  while (Ini < Fim)
+  {
+    unsigned k = Ini%POR_PALAVRA;
+    size_t n = (Fim-Ini < POR_PALAVRA-k ? Fim-Ini : POR_PALAVRA-k);
+    uint64_t mascara = (n==POR_PALAVRA ? ~uint64_t(0) : ((uint64_t(1) << 2*n)-1) << 2*k);
+    uint64_t& w = palavras[Ini/POR_PALAVRA];
+    w = (w & ~mascara) | (p & mascara);
+    Ini += n;
+  }
+}
+
+// Um campo eh igual a B quando o XOR da palavra com o padrao de B zera os 2 bits
+// do campo. Os campos que sobram na ultima palavra sao UNDEF e sao descontados
+size_t bool3S_vector::count(bool3S B) const
+{
+  const uint64_t impares = 0x5555555555555555ULL;
+  uint64_t p = padrao(B);
+  size_t diferentes = 0;
+  for (size_t k=0; k<palavras.size(); k++)
+  {
+    uint64_t x = palavras[k] ^ p;
+    diferentes += contarBits((x | (x>>1)) & impares);
+  }
+  size_t total = palavras.size()*POR_PALAVRA - diferentes;
+  if (B == bool3S::UNDEF) total -= palavras.size()*POR_PALAVRA - N;
+  return total;
+}
@@ -0,0 +1,118 @@
+#ifndef _BOOL3S_VECTOR_H_
+#define _BOOL3S_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "bool3S.h"
+
+// Vetor compactado de bool3S: cada valor ocupa 2 bits (o seu codigo no enum:
+// UNDEF=0, FALSE=1, TRUE=2), 32 valores por palavra de 64 bits.
+// O valor de indice i estah nos bits 2*(i%32) e 2*(i%32)+1 da palavra i/32
+// (numa maquina little-endian, eh o mesmo que 4 valores por byte, o valor i
+// nos bits 2*(i%4) do byte i/4).
+// Os bits que sobram na ultima palavra sao sempre 0 (UNDEF), o que permite
+// comparar e contar palavra por palavra.
+// O acesso individual eh feito atraves de uma referencia "proxy", como em
+// std::vector<bool>.
+class bool3S_vector {
+public:
+  // Numero de valores por palavra
+  static const unsigned POR_PALAVRA = 32;
+
+  // A referencia para um valor do vetor
+  class reference {
+  private:
+    uint64_t* palavra;
+    unsigned desloc;
+    reference(uint64_t* P, unsigned D): palavra(P), desloc(D) {}
+    friend class bool3S_vector;
+  public:
+    operator bool3S() const {return bool3S((*palavra >> desloc) & 3);}
+    reference& operator=(bool3S B)
+    {
+      *palavra = (*palavra & ~(uint64_t(3) << desloc)) | (uint64_t(B) << desloc);
+      return *this;
+    }
+    reference& operator=(const reference& R) {return *this = bool3S(R);}
+  };
+
+private:
+  std::vector<uint64_t> palavras;
+  size_t N;
+
+  static size_t numPalavrasPara(size_t N) {return (N+POR_PALAVRA-1)/POR_PALAVRA;}
+  // Palavra com todos os 32 campos iguais a B
+  static uint64_t padrao(bool3S B) {return uint64_t(B)*0x5555555555555555ULL;}
+  // Zera os campos que sobram na ultima palavra
+  void limparSobra();
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  bool3S_vector(): palavras(), N(0) {}
+  explicit bool3S_vector(size_t Num, bool3S B=bool3S::UNDEF): palavras(), N(0) {assign(Num, B);}
+
+  // Redimensiona para Num valores; os novos valores sao iguais a B
+  void resize(size_t Num, bool3S B=bool3S::UNDEF);
+  // Faz o vetor ter Num valores, todos iguais a B
+  void assign(size_t Num, bool3S B);
+  void reserve(size_t Num) {palavras.reserve(numPalavrasPara(Num));}
+  void clear() {palavras.clear(); N = 0;}
+  void push_back(bool3S B) {resize(N+1, B);}
+
+  /// ***********************
+  /// Acesso
+  /// ***********************
+
+  size_t size() const {return N;}
+  bool empty() const {return N==0;}
+
+  bool3S get(size_t I) const
+  {
+    return bool3S((palavras[I/POR_PALAVRA] >> 2*(I%POR_PALAVRA)) & 3);
+  }
+  void set(size_t I, bool3S B) {(*this)[I] = B;}
+
+  bool3S operator[](size_t I) const {return get(I);}
+  reference operator[](size_t I) {return reference(&palavras[I/POR_PALAVRA], 2*(I%POR_PALAVRA));}
+
+  // Iguais a [], mas testam o indice (lancam std::out_of_range)
+  bool3S at(size_t I) const
+  {
+    if (I>=N) throw std::out_of_range("bool3S_vector::at");
+    return get(I);
+  }
+  reference at(size_t I)
+  {
+    if (I>=N) throw std::out_of_range("bool3S_vector::at");
+    return (*this)[I];
+  }
+
+  // As palavras de 64 bits que armazenam os valores (numPalavras() palavras)
+  size_t numPalavras() const {return palavras.size();}
+  const uint64_t* data() const {return palavras.data();}
+  uint64_t* data() {return palavras.data();}
+
+  /// ***********************
+  /// Operacoes em bloco (uma palavra, 32 valores, de cada vez)
+  /// ***********************
+
+  // Faz todos os valores iguais a B
+  void fill(bool3S B);
+  // Faz os valores de indice Ini a Fim-1 iguais a B
+  void fill(size_t Ini, size_t Fim, bool3S B);
+
+  // Numero de valores iguais a B
+  size_t count(bool3S B) const;
+  // Numero de valores UNDEF
+  size_t countUndef() const {return count(bool3S::UNDEF);}
+
+  bool operator==(const bool3S_vector& V) const {return N==V.N && palavras==V.palavras;}
+  bool operator!=(const bool3S_vector& V) const {return !(*this==V);}
+};
+
+#endif // _BOOL3S_VECTOR_H_
@@ -1,7 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <stdexcept>
+#include <cstdint>
 #include "circuito.h"
+#include "netlistbin.h"
+#include "leitorcircuito.h"
 
 using namespace std;
 
@@ -24,44 +32,58 @@ bool validType(std::string& Tipo)
 }
 
 // Funcao auxiliar que retorna um ponteiro que aponta para uma porta alocada dinamicamente
+// na arena A (nao deve ser liberada com delete, e sim com ArenaPortas::destruir)
 // O tipo da porta alocada depende do parametro string de entrada (AN, OR, etc.)
 // Caso o tipo nao seja nenhum dos validos, retorna nullptr
-// Pode ser utilizada nas funcoes: Circuito::setPort, Circuito::digitar e Circuito::ler
-ptr_Port allocPort(std::string& Tipo)
+// Pode ser utilizada nas funcoes: Circuito::setPort, Circuito::digitar e Circuito::lerBinario
+ptr_Port allocPort(std::string& Tipo, ArenaPortas& A)
 {
   if (!validType(Tipo)) return nullptr;
+  return A.criar(Tipo);
+}
+
+///######### CLASSE CIRCUITO #########///
+
 
-  if (Tipo=="NT") return new Port_NOT;
-  if (Tipo=="AN") return new Port_AND;
-  if (Tipo=="NA") return new Port_NAND;
-  if (Tipo=="OR") return new Port_OR;
-  if (Tipo=="NO") return new Port_NOR;
-  if (Tipo=="XO") return new Port_XOR;
-  if (Tipo=="NX") return new Port_NXOR;
+///DADOS COMPARTILHADOS (COPIA NA ESCRITA)
+Circuito::Dados::Dados(const Dados& D): Nin(D.Nin), id_out(D.id_out), ports(D.ports.size(), nullptr),
+    arena(), netlist(D.netlist), compilado(D.compilado){
+    for(unsigned i=0; i<D.ports.size(); i++){
+        if(D.ports.at(i) != nullptr) ports.at(i) = arena.copiar(*D.ports.at(i));
+    }
+}
 
-  // Nunca deve chegar aqui...
-  return nullptr;
+Circuito::Dados::~Dados(){
+    for(unsigned i=0; i<ports.size(); i++) ArenaPortas::destruir(ports.at(i));
 }
 
-///######### CLASSE CIRCUITO #########///
+const std::shared_ptr<Circuito::Dados>& Circuito::dadosVazios(){
+    static const std::shared_ptr<Dados> vazios = std::make_shared<Dados>();
+    return vazios;
+}
 
+void Circuito::separar(){
+    // Os dados vazios sempre tem pelo menos duas referencias (a estatica e esta)
+    if(dados.use_count() > 1) dados = std::make_shared<Dados>(*dados);
+}
+
+void Circuito::prepararEstado(EstadoNetlist& E) const{
+    if(E.valor.size() != dados->netlist.getNumSinais()) dados->netlist.prepararEstado(E);
+}
 
 ///CONSTRUTOR
-Circuito::Circuito(): Nin(0),id_out(), out_circ(), ports(){}
+Circuito::Circuito(): dados(dadosVazios()), out_circ(), estado(), sequencial(){}
 
 ///CONTRUTOR POR CPIA
-Circuito::Circuito(const Circuito& C){
-    Nin=C.Nin;
-    id_out.resize(C.id_out.size());
-    out_circ.resize(C.out_circ.size());
-
-    for(unsigned i=0; i<C.id_out.size(); i++){
-        id_out.at(i) = C.id_out.at(i);
-        out_circ.at(i) = C.out_circ.at(i);
-    }
-    for(unsigned i=0; i<C.ports.size(); i++){
-        ports.push_back(C.ports.at(i)->clone());
-    }
+Circuito::Circuito(const Circuito& C): dados(C.dados), out_circ(C.out_circ),
+    estado(), sequencial(){}
+
+///CONSTRUTOR POR MOVIMENTO
+Circuito::Circuito(Circuito&& C) noexcept: dados(std::move(C.dados)),
+    out_circ(std::move(C.out_circ)), estado(std::move(C.estado)),
+    sequencial(std::move(C.sequencial)){
+    C.dados = dadosVazios();
+    C.out_circ.clear();
 }
 
 ///DESTRUTOR
@@ -71,37 +93,40 @@ Circuito::~Circuito(){
 
 ///CLEAR
 void Circuito::clear(){
-    Nin = 0;
-    id_out.clear();
+    // Se ninguem mais usa os dados, as portas e a arena sao liberadas aqui
+    dados = dadosVazios();
     out_circ.clear();
-    for(int i = 0; i<ports.size(); i++){
-            delete ports.at(i);
-    }
-    ports.clear();
+    estado = EstadoNetlist();
+    sequencial = EstadoNetlist();
 }
 
 ///OPERRATOR = (ATRIBUIO)
 void Circuito::operator=(const Circuito& C){
-    clear();
-    Nin=C.Nin;
-    id_out.resize(C.id_out.size());
-    out_circ.resize(C.out_circ.size());
+    if(this == &C) return;
+    dados = C.dados;
+    out_circ = C.out_circ;
+    estado = EstadoNetlist();
+    sequencial = EstadoNetlist();
+}
 
-    for(unsigned i=0; i<C.id_out.size(); i++){
-        id_out.at(i) = C.id_out.at(i);
-        out_circ.at(i) = C.out_circ.at(i);
-    }
-    for(unsigned i=0; i<C.ports.size(); i++){
-        ports.push_back(C.ports.at(i)->clone());
-    }
+///OPERRATOR = (MOVIMENTO)
+void Circuito::operator=(Circuito&& C) noexcept{
+    if(this == &C) return;
+    dados = std::move(C.dados);
+    out_circ = std::move(C.out_circ);
+    estado = std::move(C.estado);
+    sequencial = std::move(C.sequencial);
+    C.dados = dadosVazios();
+    C.out_circ.clear();
 }
 
 void Circuito::resize(unsigned NI, unsigned NO, unsigned NP){
     if(NI > 0 && NO > 0 && NP >0){
         clear();
-        Nin = NI;
-        id_out.resize(NO, 0);
-        ports.resize(NP, nullptr);
+        dados = std::make_shared<Dados>();
+        dados->Nin = NI;
+        dados->id_out.resize(NO, 0);
+        dados->ports.resize(NP, nullptr);
         out_circ.resize(NO, bool3S::UNDEF);
     }
 }
@@ -141,7 +166,7 @@ bool Circuito::validIdOrig(int IdOrig) const
 bool Circuito::definedPort(int IdPort) const
 {
   if (!validIdPort(IdPort)) return false;
-  if (ports.at(IdPort-1)==nullptr) return false;
+  if (dados->ports.at(IdPort-1)==nullptr) return false;
   return true;
 }
 
@@ -184,23 +209,23 @@ bool Circuito::valid() const
 
 ///RETORNA O NMERO DE ENTRADADAS DO CIRCUITO
 unsigned Circuito::getNumInputs() const{
-    return Nin;
+    return dados->Nin;
 }
 
 ///RETORNA O NMERO DE SAIDAS DO CIRCUITO
 unsigned Circuito::getNumOutputs() const{
-    return id_out.size();
+    return dados->id_out.size();
 }
 
 ///RETORNA O NMERO DE PORTAS DO CIRCUITO
 unsigned Circuito::getNumPorts() const{
-    return ports.size();
+    return dados->ports.size();
 }
 
 ///RETORNA O ID DE UMA SADA
 int Circuito::getIdOutput(int IdOutput) const{
     if(!validIdOutput(IdOutput)) return 0;
-    return id_out.at(IdOutput-1);
+    return dados->id_out.at(IdOutput-1);
 }
 
 ///RETORNA O RESULTADO DE UMA SADA
@@ -212,46 +237,163 @@ bool3S Circuito::getOutput(int IdOutput) const{
 ///RETORNA O TIPO DA DE UMA PORTA
 std::string Circuito::getNamePort(int IdPort) const{
     if(!definedPort(IdPort)) return "??";
-    return ports.at(IdPort-1)->getName();
+    return dados->ports.at(IdPort-1)->getName();
 }
 
 ///RETORNA O NUMERO DE ENTRADAS DE UMA PORTA
 unsigned Circuito::getNumInputsPort(int IdPort) const{
     if(!definedPort(IdPort)) return 0;
-    return ports.at(IdPort-1)->getNumInputs();
+    return dados->ports.at(IdPort-1)->getNumInputs();
 }
 
 ///RETORNA O ID DE UMA ENTRADA DE UMA PORTA
 int Circuito::getId_inPort(int IdPort, unsigned I) const{
     if(definedPort(IdPort) && validIdOrig(IdPort)){
-        return ports.at(IdPort-1)->getId_in(I);
+        return dados->ports.at(IdPort-1)->getId_in(I);
     }
     return 0;
 }
 
+///RETORNA O NUMERO DE NIVEIS DA ORDEM DE SIMULACAO
+unsigned Circuito::getNumNiveis() const{
+    if(!dados->compilado) return 0;
+    return dados->netlist.getNumNiveis();
+}
+
+///TESTA SE O CIRCUITO POSSUI REALIMENTACAO
+bool Circuito::realimentado() const{
+    return dados->compilado && !dados->netlist.getRealim().empty();
+}
+
+///RETORNA AS IDS DAS PORTAS COM REALIMENTACAO
+std::vector<int> Circuito::getPortsRealimentadas() const{
+    std::vector<int> ids;
+    if(!dados->compilado) return ids;
+    for(unsigned i=0; i<dados->netlist.getRealim().size(); i++){
+        ids.push_back(dados->netlist.getRealim().at(i)+1);
+    }
+    return ids;
+}
+
+///RETORNA O NUMERO DE COMPONENTES FORTEMENTE CONEXAS
+unsigned Circuito::getNumComponentes() const{
+    if(!dados->compilado) return 0;
+    return dados->netlist.getNumComponentes();
+}
+
+///RETORNA O NUMERO DE COMPONENTES CICLICAS
+unsigned Circuito::getNumComponentesCiclicas() const{
+    return getTamanhosComponentesCiclicas().size();
+}
+
+///RETORNA OS TAMANHOS DAS COMPONENTES CICLICAS
+std::vector<unsigned> Circuito::getTamanhosComponentesCiclicas() const{
+    std::vector<unsigned> tamanhos;
+    if(!dados->compilado) return tamanhos;
+    for(unsigned c=0; c<dados->netlist.getNumComponentes(); c++){
+        if(dados->netlist.getCiclica(c)) tamanhos.push_back(dados->netlist.getTamanhoComponente(c));
+    }
+    return tamanhos;
+}
+
 /// ***********************
 /// Funcoes de modificacao
 /// ***********************
 
 ///MUDA A ORIGEM DA SADA
 void Circuito::setIdOutput(int IdOut, int IdOrig){
-    if(validIdOrig(IdOrig) && validIdOutput(IdOut)) id_out.at(IdOut-1)=IdOrig;
+    if(validIdOrig(IdOrig) && validIdOutput(IdOut)){
+        separar();
+        dados->id_out.at(IdOut-1)=IdOrig;
+        compilar();
+    }
 }
 
 ///MUDA TIPO DE PORTA
 void Circuito::setPort(int IdPort, std::string Tipo, unsigned NIn){
     if(validIdPort(IdPort) && validType(Tipo)){
-        delete ports.at(IdPort-1);
-        ports.at(IdPort-1) = allocPort(Tipo);
-        ports.at(IdPort-1)->setNumInputs(NIn);
+        separar();
+        // A memoria da porta antiga soh eh liberada junto com a arena
+        ArenaPortas::destruir(dados->ports.at(IdPort-1));
+        dados->ports.at(IdPort-1) = allocPort(Tipo, dados->arena);
+        dados->ports.at(IdPort-1)->setNumInputs(NIn);
+        compilar();
     }
 }
 
 ///MUDA O ID DA PORTA
-void Circuito::setId_inPort(int IdPort, unsigned I, int IdOrig) const{
-    if(validIdPort(IdPort) && validIdOrig(IdOrig) && ports.at(IdPort-1)->validIndex(I))
-         ports.at(IdPort-1)->setId_in(I,IdOrig);
+void Circuito::setId_inPort(int IdPort, unsigned I, int IdOrig){
+    if(definedPort(IdPort) && validIdOrig(IdOrig) && dados->ports.at(IdPort-1)->validIndex(I)){
+         separar();
+         dados->ports.at(IdPort-1)->setId_in(I,IdOrig);
+         compilar();
+    }
+}
+
+/// ***********************
+/// Otimizacao
+/// ***********************
+
+///OTIMIZA O CIRCUITO (PORTAS MORTAS, SIMPLIFICACOES E HASH ESTRUTURAL)
+bool Circuito::otimizar(RelatorioOtimizacao& R){
+
+    R.clear();
+    if(!dados->compilado) return false;
+
+    vector<uint8_t> tipos;
+    vector<uint32_t> fanin_ini, fanin, saidas;
+    otimizarNetlist(dados->netlist, tipos, fanin_ini, fanin, saidas, R);
+
+    // Os dados antigos continuam com as copias que os compartilham
+    unsigned NI = getNumInputs(), NO = getNumOutputs(), NP = tipos.size();
+    resize(NI, NO, NP);
+    dados->netlist.montar(NI, NP, tipos.data(), fanin_ini.data(), fanin.data(), NO, saidas.data());
+    criarPortsNetlist();
+    dados->compilado = valid();
+    return dados->compilado;
+}
+
+bool Circuito::otimizar(){
+    RelatorioOtimizacao R;
+    return otimizar(R);
+}
 
+///CONVERTE O CIRCUITO EM AIG
+bool Circuito::gerarAig(Aig& A) const{
+    A.clear();
+    if(!dados->compilado) return false;
+    return A.converter(dados->netlist);
+}
+
+///CONSTROI OS BDDS DAS SAIDAS DO CIRCUITO
+bool Circuito::gerarBdd(BddCircuito& B, ordemVariaveis H, size_t MaxNos) const{
+    if(!dados->compilado) return false;
+    return B.construir(dados->netlist, H, MaxNos);
+}
+
+///VERIFICA A EQUIVALENCIA COM OUTRO CIRCUITO
+bool Circuito::verificarEquivalencia(const Circuito& C, ResultadoEquivalencia& R,
+                                     unsigned BlocosAleatorios) const{
+    R.clear();
+    if(!dados->compilado || !C.dados->compilado) return false;
+    return ::verificarEquivalencia(dados->netlist, C.dados->netlist, R, BlocosAleatorios);
+}
+
+///SUBSTITUI O CIRCUITO PELO EQUIVALENTE A UM AIG
+bool Circuito::lerAig(const Aig& A){
+
+    if(A.getNumInputs() == 0 || A.getNumOutputs() == 0) return false;
+
+    vector<uint8_t> tipos;
+    vector<uint32_t> fanin_ini, fanin, saidas;
+    A.gerarNetlist(tipos, fanin_ini, fanin, saidas);
+
+    unsigned NI = A.getNumInputs(), NO = A.getNumOutputs(), NP = tipos.size();
+    resize(NI, NO, NP);
+    dados->netlist.montar(NI, NP, tipos.data(), fanin_ini.data(), fanin.data(), NO, saidas.data());
+    criarPortsNetlist();
+    dados->compilado = valid();
+    return dados->compilado;
 }
 
 /// ***********************
@@ -291,10 +433,10 @@ void Circuito::digitar(){
             cout << "Digite o tipo da porta " << i+1<< ":";
                 cin >> tipo;
         }
-        if(ports.at(i) != nullptr) delete ports.at(i);  ///lembrar de fazer  nos outros
-        ports.at(i) = allocPort(tipo);
+        ArenaPortas::destruir(dados->ports.at(i));
+        dados->ports.at(i) = allocPort(tipo, dados->arena);
         do{
-            ports.at(i)->digitar();
+            dados->ports.at(i)->digitar();
         }while(!validPort(i+1));
 
 
@@ -308,73 +450,100 @@ void Circuito::digitar(){
             cout << "Digite o Id da saida " << i+1 << ":";
                 cin >> idSaida;
         }
-        id_out.at(i) = (idSaida);
+        dados->id_out.at(i) = (idSaida);
     }
 
+    compilar();
 }
 
 ///FUNO PARA LER UM CIRCUITO A PARTIR DE UM ARQUIVO
 bool Circuito::ler(const std::string& arq){
+    string erro;
+    return ler(arq, erro);
+}
 
-     ///ABRE O ARQUIVO
-     ifstream arqv(arq.c_str());
-
-     try{
-        if (!arqv.is_open()) throw 1;
-
-        std::string prov, prov1;
-        unsigned in, out, portas;
-        unsigned idprov;
-        char test;
-
-        arqv >> prov >> in >> out >> portas >> prov1;
-
-        if (!arqv.good() || prov != "CIRCUITO" ||
-                in<=0 || out<=0 || portas<=0 || prov1 != "PORTAS") throw 2;
-        resize(in,out,portas);
-
+bool Circuito::ler(const std::string& arq, std::string& Erro){
+
+     Erro.clear();
+
+     ///FORMATO BINARIO
+     if(ehNetlistBinaria(arq)){
+         if(lerBinario(arq)) return true;
+         Erro = "arquivo binario invalido";
+         return false;
+     }
+
+     ///FORMATO TEXTO (LEITURA RAPIDA, EM PARALELO)
+     LeitorCircuito L;
+     if(!L.lerArquivo(arq)){
+         Erro = L.getErro();
+         clear();
+         return false;
+     }
+     resize(L.getNumInputs(), L.getNumOutputs(), L.getNumPorts());
+     dados->id_out = L.getIdOutputs();
+     dados->ports.clear();
+     L.transferirPorts(dados->ports, dados->arena);
+
+     // A netlist eh montada diretamente a partir da netlist plana do leitor
+     dados->netlist.montar(getNumInputs(), getNumPorts(), L.getTipos(), L.getFaninIni(),
+                    L.getFanin(), getNumOutputs(), L.getSaidas());
+     dados->compilado = valid();
+     if(!dados->compilado){
+         Erro = "circuito invalido";
+         clear();
+         return false;
+     }
+     dados->netlist.prepararEstado(estado);
+     dados->netlist.prepararEstado(sequencial);
+     return true;
+}
 
-        //LENDO AS PORTAS
-        for(unsigned i=0 ; i<portas; i++){
+///FUNO PARA LER UM CIRCUITO DE UM ARQUIVO BINARIO (MAPEADO EM MEMORIA)
+bool Circuito::lerBinario(const std::string& arq){
 
-            string nomePorta;
-            arqv >> idprov >> test;
+    NetlistBinaria B;
+    if(!B.abrir(arq)){
+        clear();
+        return false;
+    }
+    unsigned NI = B.getNumInputs(), NP = B.getNumPorts(), NO = B.getNumOutputs();
+    resize(NI, NO, NP);
 
-            if(idprov != i+1 || test != ')') throw 3;
+    // A netlist eh montada diretamente a partir das secoes do arquivo
+    dados->netlist.montar(NI, NP, B.getTipos(), B.getFaninIni(), B.getFanin(), NO, B.getSaidas());
 
-            //L O TIPO DA PORTA, AN, XO....
-            arqv >> nomePorta;
+    // As portas e as saidas sao criadas a partir da netlist
+    criarPortsNetlist();
 
-            if(!validType(nomePorta)) throw 4; //redundancia pois o alloc ja testa o tipo
-            //Cria uma porta do tipo correspondente
-            ptr_Port portaProv  = allocPort(nomePorta);
-            if(!portaProv->ler(arqv)) throw 5;
-            //Adiciona no Vetor de portas caso esteja tudo certo
-            ports.at(i) = portaProv;
-        }
+    dados->compilado = valid();
+    if(!dados->compilado){
+        clear();
+        return false;
+    }
+    dados->netlist.prepararEstado(estado);
+    dados->netlist.prepararEstado(sequencial);
+    return true;
+}
 
-        arqv >> prov;
-        if(prov != "SAIDAS") throw 6;
-        for(int i=0 ; i<out; i++){
-            int saida;
-            arqv >> idprov >> test;
-            if(idprov != i+1 || test != ')') throw 7;
-            arqv >> saida;
-            id_out.at(i) = saida;
+///CRIA AS PORTAS E AS SAIDAS A PARTIR DA NETLIST
+void Circuito::criarPortsNetlist(){
+
+    // Os sinais sao convertidos para ids (entradas negativas, portas positivas)
+    unsigned NI = getNumInputs();
+    for(unsigned p=0; p<getNumPorts(); p++){
+        string nome = toString(dados->netlist.getTipo(p));
+        dados->ports.at(p) = allocPort(nome, dados->arena);
+        dados->ports.at(p)->setNumInputs(dados->netlist.getNumFanin(p));
+        const unsigned* in = dados->netlist.getFanin(p);
+        for(unsigned j=0; j<dados->netlist.getNumFanin(p); j++){
+            dados->ports.at(p)->setId_in(j, in[j]<NI ? -int(in[j])-1 : int(in[j]-NI)+1);
         }
-
-        bool circ_valid = valid();
-        if(!circ_valid) throw 8;
-
     }
-    catch (int i)
-  {
-    //ERRO DE LEITURA
-    clear();
-    return false;
-  }
-
-  return true;
+    for(unsigned j=0; j<getNumOutputs(); j++){
+        unsigned s = dados->netlist.getSaida(j);
+        dados->id_out.at(j) = (s<NI ? -int(s)-1 : int(s-NI)+1);
+    }
 }
 
 ///FUNO IMPRIMIR
@@ -385,17 +554,17 @@ std::ostream& Circuito::imprimir(std::ostream& O) const{
         exit(0);
     }
 
-    O << "CIRCUITO " << getNumInputs() << " " << id_out.size() << " " <<  ports.size() << endl;
+    O << "CIRCUITO " << getNumInputs() << " " << dados->id_out.size() << " " <<  dados->ports.size() << endl;
     O << "PORTAS" << endl;
 
-    for(unsigned i=0; i<ports.size(); i++){
-        O << i+1 <<") " << *ports.at(i) ;
+    for(unsigned i=0; i<dados->ports.size(); i++){
+        O << i+1 <<") " << *dados->ports.at(i) ;
 
         O << endl;
     }
     O << "SAIDAS" << endl;
-    for(unsigned i=0; i<id_out.size(); i++){
-       O << i+1 <<") " << id_out.at(i) << endl;
+    for(unsigned i=0; i<dados->id_out.size(); i++){
+       O << i+1 <<") " << dados->id_out.at(i) << endl;
     }
 
     return O;
@@ -419,49 +588,610 @@ bool Circuito::salvar(const std::string& arq) const{
     return true;
 }
 
+///FUNO PARA SALVAR EM ARQUIVO BINARIO
+bool Circuito::salvarBinario(const std::string& arq) const{
+
+    if(!dados->compilado) return false;
+
+    ofstream nome_arq(arq.c_str(), ios::out|ios::binary);
+
+    if (!nome_arq.is_open()) return false;
+
+    return salvarNetlistBinaria(dados->netlist, nome_arq);
+}
+
 /// ***********************
 /// SIMULACAO (funcao principal do circuito)
 /// ***********************
 
+///MONTA A NETLIST COMPILADA (TIPOS, ENTRADAS E ORDEM DE SIMULACAO)
+void Circuito::compilar(){
+
+    dados->netlist.clear();
+    dados->compilado = valid();
+    if(!dados->compilado) return;
+
+    // Monta diretamente a netlist plana (tipos, fanin em CSR e saidas, em sinais)
+    unsigned NI = getNumInputs(), NP = getNumPorts();
+    vector<uint8_t> tipos(NP);
+    vector<uint32_t> fanin_ini(NP+1, 0), fanin, saidas(getNumOutputs());
+    for(unsigned i=0; i<NP; i++){
+        const Port& P = *dados->ports.at(i);
+        tipoPorta T;
+        toTipoPorta(P.getName(), T);
+        tipos.at(i) = uint8_t(T);
+        for(unsigned j=0; j<P.getNumInputs(); j++){
+            int id = P.getId_in(j);
+            fanin.push_back(id<0 ? -id-1 : NI+id-1);
+        }
+        fanin_ini.at(i+1) = fanin.size();
+    }
+    for(unsigned j=0; j<getNumOutputs(); j++){
+        int id = dados->id_out.at(j);
+        saidas.at(j) = (id<0 ? -id-1 : NI+id-1);
+    }
+    dados->netlist.montar(NI, NP, tipos.data(), fanin_ini.data(), fanin.data(),
+                          getNumOutputs(), saidas.data());
+    dados->netlist.prepararEstado(estado);
+    dados->netlist.prepararEstado(sequencial);
+}
+
 bool Circuito::simular(const std::vector<bool3S>& in_circ){
 
-    bool tudo_def, alguma_def;
-    int id;
-    vector<bool3S> in_port;
+    if(!dados->compilado || in_circ.size() != getNumInputs()) return false;
+    prepararEstado(estado);
+
+    for(unsigned j=0; j<getNumInputs(); j++) estado.valor[j] = in_circ[j];
+    dados->netlist.simular(estado);
+
+    for(unsigned j = 0; j<getNumOutputs(); j++){
+        out_circ[j] = estado.valor[dados->netlist.getSaida(j)];
+    }
+    return true;
+}
+
+///SIMULACAO POR EVENTOS (INCREMENTAL)
+bool Circuito::simularIncremental(const std::vector<bool3S>& in_circ){
+
+    if(!dados->compilado || in_circ.size() != getNumInputs()) return false;
+    prepararEstado(estado);
+    if(!estado.consistente) return simular(in_circ);
+
+    for(unsigned j=0; j<getNumInputs(); j++) dados->netlist.alterarEntrada(estado, j, in_circ[j]);
+    dados->netlist.propagar(estado);
+
+    for(unsigned j = 0; j<getNumOutputs(); j++){
+        out_circ[j] = estado.valor[dados->netlist.getSaida(j)];
+    }
+    return true;
+}
+
+///SIMULACAO SEQUENCIAL (CICLOS DE RELOGIO)
+void Circuito::reiniciarSequencial(){
+
+    if(!dados->compilado) return;
+    prepararEstado(sequencial);
+    for(unsigned k=0; k<sequencial.valor.size(); k++) sequencial.valor[k] = bool3S::UNDEF;
+}
 
-    for(unsigned i=0; i<getNumPorts(); i++){
-        ports.at(i)->setOutput(bool3S::UNDEF);
+bool Circuito::simularCiclo(const std::vector<bool3S>& in_circ){
+
+    if(!dados->compilado || in_circ.size() != getNumInputs()) return false;
+    prepararEstado(sequencial);
+
+    for(unsigned j=0; j<getNumInputs(); j++) sequencial.valor[j] = in_circ[j];
+    dados->netlist.simularCiclo(sequencial);
+
+    for(unsigned j = 0; j<getNumOutputs(); j++){
+        out_circ[j] = sequencial.valor[dados->netlist.getSaida(j)];
     }
+    return true;
+}
+
+unsigned long long Circuito::simularSequencia(FonteEstimulos& F, DestinoSaidas& D,
+                                              unsigned long long MaxCiclos){
+
+    if(!dados->compilado) return 0;
+    prepararEstado(sequencial);
+
+    // Os vetores de entrada e saida sao alocados uma unica vez
+    vector<bool3S> in(getNumInputs()), out(getNumOutputs());
+    bool3S* V = sequencial.valor.data();
+    unsigned long long ciclo = 0;
+
+    while((MaxCiclos == 0 || ciclo < MaxCiclos) && F.proximo(in)){
+        for(unsigned j=0; j<getNumInputs(); j++) V[j] = in[j];
+        dados->netlist.simularCiclo(sequencial);
+        for(unsigned j=0; j<getNumOutputs(); j++) out[j] = V[dados->netlist.getSaida(j)];
+        ciclo++;
+        if(!D.receber(ciclo-1, out)) break;
+    }
+    for(unsigned j = 0; j<getNumOutputs(); j++) out_circ[j] = out[j];
+    return ciclo;
+}
+
+///RETORNA O NUMERO DE AVALIACOES DE PORTA DA ULTIMA SIMULACAO
+unsigned long Circuito::getNumAvaliacoes() const{
+    return estado.avaliadas;
+}
+
+/// ***********************
+/// SIMULACAO BIT-PARALELA (64 combinacoes de entrada de uma so vez)
+/// ***********************
+
+///RETORNA O NUMERO DE LINHAS DA TABELA VERDADE
+unsigned long long Circuito::getNumLinhasTabela() const{
+    if(getNumInputs() == 0) return 0;
+    unsigned long long linhas = 1;
+    for(unsigned i=0; i<getNumInputs(); i++){
+        if(linhas > ~0ULL/3) return 0;
+        linhas *= 3;
+    }
+    return linhas;
+}
+
+///GERA 64 COMBINACOES DE ENTRADA CONSECUTIVAS DA TABELA VERDADE
+void Circuito::gerarEntradas64(unsigned long long Linha0, std::vector<bool3S_64>& in_circ) const{
+
+    vector<uint64_t> val_in, def_in;
+    gerarEntradasBloco(Linha0, 1, val_in, def_in);
+    in_circ.resize(getNumInputs());
+    for(unsigned j=0; j<getNumInputs(); j++){
+        in_circ[j] = bool3S_64(val_in[j], def_in[j]);
+    }
+}
+
+///SIMULA 64 COMBINACOES DE ENTRADA
+bool Circuito::simular64(const std::vector<bool3S_64>& in_circ,
+                         std::vector<bool3S_64>& out_circ64) const{
+
+    if(!dados->compilado || in_circ.size() != getNumInputs()) return false;
+
+    // Um bloco de uma palavra
+    EstadoNetlist E;
+    dados->netlist.prepararEstado(E, 1);
+    for(unsigned j=0; j<getNumInputs(); j++){
+        E.val[j] = in_circ[j].val;
+        E.def[j] = in_circ[j].def;
+    }
+    dados->netlist.simularBloco(E);
+
+    out_circ64.resize(getNumOutputs());
+    for(unsigned j = 0; j<getNumOutputs(); j++){
+        unsigned s = dados->netlist.getSaida(j);
+        out_circ64[j] = bool3S_64(E.val[s], E.def[s]);
+    }
+    return true;
+}
+
+/// ***********************
+/// SIMULACAO EM BLOCOS (64*W combinacoes de entrada de uma so vez)
+/// ***********************
+
+// Funcao auxiliar que faz iguais a 1 os bits Ini a Fim-1 de um plano de W palavras
+static void setBits(uint64_t* plano, unsigned long long Ini, unsigned long long Fim)
+{
+    while(Ini < Fim){
+        unsigned k = Ini%64;
+        unsigned long long n = Fim-Ini < 64-k ? Fim-Ini : 64-k;
+        plano[Ini/64] |= (n==64 ? ~uint64_t(0) : ((uint64_t(1)<<n)-1) << k);
+        Ini += n;
+    }
+}
+
+///GERA 64*W COMBINACOES DE ENTRADA CONSECUTIVAS DA TABELA VERDADE
+void Circuito::gerarEntradasBloco(unsigned long long Linha0, unsigned W,
+                                  std::vector<uint64_t>& val_in, std::vector<uint64_t>& def_in) const{
+
+    val_in.resize(getNumInputs()*W);
+    def_in.resize(getNumInputs()*W);
+    preencherEntradas(Linha0, W, val_in.data(), def_in.data());
+}
+
+///PREENCHE OS PLANOS DAS ENTRADAS DE UM BLOCO
+void Circuito::preencherEntradas(unsigned long long Linha0, unsigned W,
+                                 uint64_t* val_in, uint64_t* def_in) const{
+
+    unsigned n = getNumInputs();
+    unsigned long long numLinhas = getNumLinhasTabela();
+
+    for(unsigned k=0; k<n*W; k++) val_in[k] = def_in[k] = 0;
+    if(Linha0 >= numLinhas) return;
+
+    // Numero de combinacoes do bloco que pertencem aa tabela
+    unsigned long long tam = numLinhas-Linha0 < 64ULL*W ? numLinhas-Linha0 : 64ULL*W;
+
+    // A entrada j fica constante em sequencias de 3^(n-1-j) linhas consecutivas
+    // (UNDEF, depois FALSE, depois TRUE). Em vez de gerar linha por linha,
+    // preenche os planos uma sequencia de cada vez
+    unsigned long long periodo = 1;
+    for(int j=n-1; j>=0; j--){
+        unsigned long long digito = (Linha0/periodo)%3;
+        // Posicao (no bloco) onde termina a sequencia atual
+        unsigned long long ini = 0, fim = periodo - Linha0%periodo;
+        while(ini < tam){
+            if(fim > tam) fim = tam;
+            if(digito != 0) setBits(&def_in[j*W], ini, fim);
+            if(digito == 2) setBits(&val_in[j*W], ini, fim);
+            digito = (digito+1)%3;
+            ini = fim;
+            fim += periodo;
+        }
+        // O periodo da entrada anterior eh 3 vezes maior
+        periodo *= 3;
+    }
+}
+
+///SIMULA 64*W COMBINACOES DE ENTRADA
+bool Circuito::simularBloco(const std::vector<uint64_t>& val_in, const std::vector<uint64_t>& def_in,
+                            unsigned W,
+                            std::vector<uint64_t>& val_out, std::vector<uint64_t>& def_out) const{
+
+    if(!dados->compilado || W == 0 ||
+       val_in.size() != W*getNumInputs() || def_in.size() != W*getNumInputs()) return false;
+
+    EstadoNetlist E;
+    dados->netlist.prepararEstado(E, W);
+    // As entradas do circuito sao os primeiros sinais da netlist
+    for(unsigned k=0; k<W*getNumInputs(); k++){
+        E.val[k] = val_in[k];
+        E.def[k] = def_in[k];
+    }
+    dados->netlist.simularBloco(E);
+
+    val_out.resize(W*getNumOutputs());
+    def_out.resize(W*getNumOutputs());
+    for(unsigned j = 0; j<getNumOutputs(); j++){
+        unsigned s = dados->netlist.getSaida(j);
+        for(unsigned w=0; w<W; w++){
+            val_out[j*W+w] = E.val[s*W+w];
+            def_out[j*W+w] = E.def[s*W+w];
+        }
+    }
+    return true;
+}
+
+///SIMULA UMA FAIXA DE LINHAS DA TABELA VERDADE
+void Circuito::simularLinhas(EstadoNetlist& E, unsigned long long Ini, unsigned long long Fim,
+                             bool3S_vector& tabela, unsigned long long Pos) const{
+
+    const unsigned W = PALAVRAS_BLOCO;
+    unsigned NO = getNumOutputs();
+
+    for(unsigned long long linha0=Ini; linha0<Fim; linha0+=64*W){
+        preencherEntradas(linha0, W, E.val.data(), E.def.data());
+        dados->netlist.simularBloco(E);
+        // Copia as saidas linha por linha (escrita sequencial na tabela)
+        unsigned long long pos = Pos + (linha0-Ini)*NO;
+        for(unsigned k=0; k<64*W && linha0+k<Fim; k++){
+            for(unsigned j=0; j<NO; j++, pos++){
+                unsigned s = dados->netlist.getSaida(j)*W + k/64;
+                tabela[pos] = bool3S_64(E.val[s], E.def[s]).get(k%64);
+            }
+        }
+    }
+}
+
+///GERA A TABELA VERDADE COMPLETA
+bool Circuito::gerarTabela(bool3S_vector& tabela) const{
+
+    unsigned long long numLinhas = getNumLinhasTabela();
+
+    if(!dados->compilado || numLinhas == 0) return false;
+
+    // O mesmo estado eh usado em todos os blocos: nenhuma alocacao no laco
+    EstadoNetlist E;
+    dados->netlist.prepararEstado(E, PALAVRAS_BLOCO);
+    tabela.resize(numLinhas*getNumOutputs());
+    simularLinhas(E, 0, numLinhas, tabela, 0);
+    return true;
+}
+
+///GERA A TABELA VERDADE EM PARALELO
+bool Circuito::gerarTabelaParalela(bool3S_vector& tabela, unsigned NumThreads) const{
+    return gerarFaixaTabela(0, getNumLinhasTabela(), tabela, NumThreads);
+}
+
+///GERA UMA FAIXA DE LINHAS DA TABELA VERDADE EM PARALELO
+bool Circuito::gerarFaixaTabela(unsigned long long Ini, unsigned long long Fim,
+                                bool3S_vector& tabela, unsigned NumThreads) const{
+
+    unsigned long long numLinhas = getNumLinhasTabela();
+    unsigned NO = getNumOutputs();
+
+    if(!dados->compilado || numLinhas == 0 || Ini >= Fim || Fim > numLinhas) return false;
+
+    tabela.resize((Fim-Ini)*NO);
+
+    unsigned long long numTarefas = (Fim-Ini+LINHAS_TAREFA-1)/LINHAS_TAREFA;
+    if(NumThreads == 0) NumThreads = thread::hardware_concurrency();
+    if(NumThreads == 0) NumThreads = 1;
+    if(NumThreads > numTarefas) NumThreads = numTarefas;
+
+    // A proxima tarefa livre
+    atomic<unsigned long long> proxima(0);
+
+    // Cada thread tem o seu proprio estado; a netlist eh compartilhada (soh leitura)
+    // As faixas de linhas das tarefas ocupam palavras disjuntas da tabela, entao
+    // as escritas nao precisam de sincronizacao
+    auto trabalhador = [&](){
+        EstadoNetlist E;
+        dados->netlist.prepararEstado(E, PALAVRAS_BLOCO);
+        for(unsigned long long t=proxima++; t<numTarefas; t=proxima++){
+            unsigned long long ini = Ini + t*LINHAS_TAREFA;
+            unsigned long long fim = Fim-ini > LINHAS_TAREFA ? ini+LINHAS_TAREFA : Fim;
+            simularLinhas(E, ini, fim, tabela, (ini-Ini)*NO);
+        }
+    };
+
+    // A thread atual tambem trabalha
+    vector<thread> threads;
+    threads.reserve(NumThreads-1);
+    for(unsigned i=1; i<NumThreads; i++) threads.emplace_back(trabalhador);
+    trabalhador();
+    for(unsigned i=0; i<threads.size(); i++) threads[i].join();
+    return true;
+}
+
+///GERA A TABELA VERDADE POR SIMULACAO INCREMENTAL
+bool Circuito::gerarTabelaIncremental(bool3S_vector& tabela) const{
+
+    unsigned long long numLinhas = getNumLinhasTabela();
+    unsigned NO = getNumOutputs();
+
+    if(!dados->compilado || numLinhas == 0) return false;
+
+    EstadoNetlist E;
+    dados->netlist.prepararEstado(E);
+    EnumeradorGray3S G(getNumInputs());
+    tabela.resize(numLinhas*NO);
+
+    // A primeira combinacao (todas as entradas UNDEF) eh simulada por completo
+    for(unsigned j=0; j<getNumInputs(); j++) E.valor[j] = bool3S::UNDEF;
+    dados->netlist.simular(E);
     do{
-        tudo_def=true;
-        alguma_def=false;
-        //cout << "entrei aqui 1" << endl;
-        for(unsigned i=0; i<getNumPorts(); i++){
-            if(ports.at(i)->getOutput()  == bool3S::UNDEF){
-                for(unsigned j = 0; j<ports.at(i)->getNumInputs(); j++){
-                    id = ports.at(i)->getId_in(j);
-                    if(id >0){
-                        //in_port.at(j) = ports.at(id - 1)->getOutput();
-                        in_port.push_back(ports.at(id - 1)->getOutput());
-                    }else{
-                        //in_port.at(j) = in_circ.at(-id-1);
-                        in_port.push_back(in_circ.at(-id-1));
-                    }
-
-                }
-                ports.at(i)->simular(in_port);
-                if (ports.at(i)->getOutput()== bool3S::UNDEF) tudo_def = false;
-                else alguma_def = true;
+        int alterada = G.getEntradaAlterada();
+        if(alterada >= 0){
+            // Um unico evento por linha
+            dados->netlist.alterarEntrada(E, alterada, G.getEntradas()[alterada]);
+            dados->netlist.propagar(E);
+        }
+        unsigned long long pos = G.getLinha()*NO;
+        for(unsigned j=0; j<NO; j++) tabela[pos+j] = E.valor[dados->netlist.getSaida(j)];
+    }while(G.proximo());
+    return true;
+}
+
+///GERA A TABELA VERDADE A PARTIR DAS 2^n LINHAS BOOLEANAS
+bool Circuito::gerarTabelaBooleana(bool3S_vector& tabela) const{
+
+    const unsigned long long numLinhas = getNumLinhasTabela();
+    const unsigned NO = getNumOutputs();
+
+    if(!dados->compilado || numLinhas == 0) return false;
+    // A tabela e o rascunho m tem numLinhas*NO elementos
+    if(NO > 0 && numLinhas > SIZE_MAX/NO) return false;
+    // Sem memoria para a tabela ou para o rascunho: tabela grande demais
+    try{
+        return gerarTabelaBooleanaInterna(tabela);
+    }catch(const bad_alloc&){
+        tabela.clear();
+        return false;
+    }catch(const length_error&){
+        tabela.clear();
+        return false;
+    }
+}
+
+bool Circuito::gerarTabelaBooleanaInterna(bool3S_vector& tabela) const{
+
+    const unsigned long long numLinhas = getNumLinhasTabela();
+    const unsigned NI = getNumInputs(), NO = getNumOutputs(), W = PALAVRAS_BLOCO;
+
+    const Netlist& N = dados->netlist;
+    // Sem lacos, basta o plano val (simulacao booleana pura)
+    const bool semLacos = N.getRealim().empty();
+    const unsigned long long numBool = 1ull << NI;
+
+    // peso[k] = 3^k: o peso, na linha da tabela, da entrada NI-1-k
+    vector<unsigned long long> peso(NI+1, 1);
+    for(unsigned k=1; k<=NI; k++) peso[k] = 3*peso[k-1];
+    // A linha booleana r (bit NI-1-i de r: valor da entrada i) corresponde aa linha
+    // da tabela com o digito 1 (FALSE) ou 2 (TRUE) em cada entrada: todasF mais
+    // o peso de cada entrada TRUE. Os 10 bits mais baixos de r vem de uma tabela;
+    // os demais (altos) sao somados a cada 1024 linhas
+    const unsigned long long todasF = (numLinhas-1)/2;
+    const unsigned bitsBaixos = (NI < 10 ? NI : 10);
+    vector<unsigned long long> baixos(1u << bitsBaixos, 0);
+    for(unsigned x=0; x<baixos.size(); x++){
+        for(unsigned b=0; b<bitsBaixos; b++) if((x>>b) & 1) baixos[x] += peso[b];
+    }
+
+    // m[L*NO+j]: os valores possiveis da saida j na linha L da tabela (bit 0:
+    // FALSE; bit 1: TRUE; UNDEF: os dois), na mesma ordem da tabela
+    vector<uint8_t> m(numLinhas*NO, 0);
+
+    ///1) SIMULA AS 2^n COMBINACOES BOOLEANAS
+    static const uint64_t PADRAO[6] = {
+        0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+    EstadoNetlist E;
+    N.prepararEstado(E, W);
+    unsigned long long altos = todasF;
+    for(unsigned long long r0=0; r0<numBool; r0+=64*W){
+        // Bit K da palavra w: linha booleana r0+64*w+K
+        for(unsigned i=0; i<NI; i++){
+            unsigned desloc = NI-1-i;
+            for(unsigned w=0; w<W; w++){
+                unsigned long long r = r0+64*w;
+                E.val[i*W+w] = (desloc < 6 ? PADRAO[desloc] : (((r>>desloc) & 1) ? ~0ull : 0));
+                E.def[i*W+w] = ~0ull;
             }
-           //cout << "entrei aqui 2" << endl;
         }
-    }while(!tudo_def && alguma_def);
+        if(semLacos) N.simularBlocoBooleano(E);
+        else N.simularBloco(E);
+
+        unsigned long long num = (numBool-r0 < 64*W ? numBool-r0 : 64*W);
+        for(unsigned long long k=0; k<num; k++){
+            unsigned long long r = r0+k;
+            if((r & (baixos.size()-1)) == 0){
+                altos = todasF;
+                for(unsigned b=bitsBaixos; b<NI; b++) if((r>>b) & 1) altos += peso[b];
+            }
+            uint8_t* dest = &m[(altos+baixos[r & (baixos.size()-1)])*NO];
+            for(unsigned j=0; j<NO; j++){
+                unsigned s = N.getSaida(j);
+                bool val = (E.val[s*W+k/64] >> (k%64)) & 1;
+                bool def = semLacos || ((E.def[s*W+k/64] >> (k%64)) & 1);
+                dest[j] = (!def ? 3 : (val ? 2 : 1));
+            }
+        }
+    }
 
-    for(unsigned j = 0; j<getNumOutputs(); j++){
-        id = id_out.at(j);
-        if(id > 0) out_circ.at(j) = ports.at(id-1)->getOutput();
-        else out_circ.at(j) = in_circ.at(-id-1);
+    ///2) DEDUZ AS LINHAS COM ENTRADAS UNDEF
+    // Uma linha com a entrada i UNDEF junta os valores das linhas com a entrada i
+    // FALSE e TRUE. Na passada i sao calculadas as linhas com a entrada i UNDEF;
+    // uma linha fica correta na passada da sua ultima entrada UNDEF, quando as duas
+    // linhas de que ela depende (com UNDEF soh nas entradas anteriores) jah estao
+    // corretas. As linhas com a entrada i UNDEF, FALSE e TRUE formam faixas
+    // consecutivas de s linhas (s*NO bytes), de modo que o laco eh vetorizavel
+    for(unsigned i=0; i<NI; i++){
+        const unsigned long long s = peso[NI-1-i]*NO;
+        for(unsigned long long ini=0; ini<numLinhas*NO; ini+=3*s){
+            uint8_t* u = &m[ini];
+            for(unsigned long long k=0; k<s; k++) u[k] = u[s+k] | u[2*s+k];
+        }
+    }
+
+    ///3) COMPACTA NA TABELA (codigos de bool3S: UNDEF=0, FALSE=1, TRUE=2)
+    tabela.resize(numLinhas*NO);
+    uint64_t* palavras = tabela.data();
+    for(size_t w=0; w<tabela.numPalavras(); w++){
+        uint64_t palavra = 0;
+        size_t ini = w*bool3S_vector::POR_PALAVRA;
+        size_t fim = min(ini+bool3S_vector::POR_PALAVRA, m.size());
+        for(size_t k=ini; k<fim; k++){
+            uint64_t codigo = (m[k]==3 ? 0 : m[k]);
+            palavra |= codigo << 2*(k-ini);
+        }
+        palavras[w] = palavra;
+    }
+    return true;
+}
+
+/// ***********************
+/// CONES DAS SAIDAS
+/// ***********************
+
+///CALCULA O SUPORTE E O CONE DE CADA SAIDA
+bool Circuito::analisarCones(std::vector<ConeSaida>& Cones) const{
+    Cones.clear();
+    if(!dados->compilado) return false;
+    ::analisarCones(dados->netlist, Cones);
+    return true;
+}
+
+///GERA O CIRCUITO FORMADO PELO CONE DE UMA SAIDA
+bool Circuito::extrairCone(int IdOutput, Circuito& C) const{
+    if(!dados->compilado || !validIdOutput(IdOutput)) return false;
+
+    vector<ConeSaida> cones;
+    ::analisarCones(dados->netlist, cones);
+    const vector<unsigned>& suporte = cones[IdOutput-1].suporte;
+
+    vector<uint8_t> tipos;
+    vector<uint32_t> fanin_ini, fanin, saidas;
+    ::extrairCone(dados->netlist, vector<unsigned>(1, IdOutput-1), suporte,
+                  tipos, fanin_ini, fanin, saidas);
+
+    unsigned NI = suporte.size(), NP = tipos.size();
+    C.resize(NI, 1, NP);
+    C.dados->netlist.montar(NI, NP, tipos.data(), fanin_ini.data(), fanin.data(), 1, saidas.data());
+    C.criarPortsNetlist();
+    C.dados->compilado = C.valid();
+    return C.dados->compilado;
+}
+
+///GERA A TABELA VERDADE DE CADA SAIDA SOBRE O SEU SUPORTE
+bool Circuito::gerarTabelasSaidas(std::vector<TabelaSaida>& Tabelas, unsigned NumThreads) const{
+
+    Tabelas.clear();
+    if(!dados->compilado) return false;
+
+    vector<ConeSaida> cones;
+    ::analisarCones(dados->netlist, cones);
+    Tabelas.resize(getNumOutputs());
+
+    // Agrupa as saidas com o mesmo suporte
+    map<vector<unsigned>, vector<unsigned> > grupos;
+    for(unsigned j=0; j<cones.size(); j++) grupos[cones[j].suporte].push_back(j);
+
+    vector<uint8_t> tipos;
+    vector<uint32_t> fanin_ini, fanin, saidas;
+    bool3S_vector tabela, coluna;
+    for(const auto& G : grupos){
+        const vector<unsigned>& suporte = G.first;
+        const vector<unsigned>& ids = G.second;
+
+        ::extrairCone(dados->netlist, ids, suporte, tipos, fanin_ini, fanin, saidas);
+        unsigned NI = suporte.size(), NO = ids.size(), NP = tipos.size();
+        Circuito C;
+        C.resize(NI, NO, NP);
+        C.dados->netlist.montar(NI, NP, tipos.data(), fanin_ini.data(), fanin.data(), NO, saidas.data());
+        C.criarPortsNetlist();
+        C.dados->compilado = C.valid();
+        if(!C.dados->compilado || C.getNumLinhasTabela() == 0) return false;
+        if(!C.gerarTabelaParalela(tabela, NumThreads)) return false;
+
+        if(NO == 1){
+            Tabelas[ids[0]].set(suporte, tabela);
+            continue;
+        }
+        // Separa as colunas das saidas do grupo
+        const unsigned long long numLinhas = C.getNumLinhasTabela();
+        for(unsigned q=0; q<NO; q++){
+            coluna.resize(numLinhas);
+            for(unsigned long long L=0; L<numLinhas; L++) coluna.set(L, tabela[L*NO+q]);
+            Tabelas[ids[q]].set(suporte, coluna);
+        }
     }
+    return true;
+}
+
+/// ***********************
+/// SIMULACAO ALEATORIA
+/// ***********************
+
+///SIMULA COMBINACOES DE ENTRADA SORTEADAS E ACUMULA AS ESTATISTICAS DOS SINAIS
+bool Circuito::simularMonteCarlo(EstatisticaSinais& E, unsigned long long NumVetores,
+                                 uint64_t Semente, const std::vector<ProbabilidadeEntrada>& P,
+                                 double Tolerancia) const{
+    E.clear();
+    if(!dados->compilado) return false;
+    return ::simularMonteCarlo(dados->netlist, P, NumVetores, Semente, E, Tolerancia);
+}
+
+/// ***********************
+/// SIMULACAO DE FALHAS
+/// ***********************
+
+///CRIA A LISTA DE FALHAS STUCK-AT DO CIRCUITO
+bool Circuito::gerarFalhas(SimuladorFalhas& S, bool Colapsar) const{
+    if(!dados->compilado) return false;
+    S.gerarFalhas(dados->netlist, Colapsar);
+    return true;
+}
+
+/// ***********************
+/// GERACAO DE VETORES DE TESTE
+/// ***********************
+
+///GERA OS VETORES DE TESTE DAS FALHAS STUCK-AT (PODEM)
+bool Circuito::gerarTestes(ResultadoAtpg& R, const OpcoesAtpg& Op) const{
+    R.clear();
+    if(!dados->compilado) return false;
+    ::gerarTestes(dados->netlist, Op, R);
+    return true;
 }
 
 ///SOBRECARGA DO OPERADOR <<
@@ -469,6 +1199,6 @@ std::ostream& operator<<(std::ostream& O, const Circuito& C){
     if(!C.valid()){
        cout << "ERROR!! Circuito invlido!!";
     }
-    C.imprimir(O);
+    return C.imprimir(O);
 }
 
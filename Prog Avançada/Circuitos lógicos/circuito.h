@@ -2,10 +2,25 @@
 #define _CIRCUITO_H_
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "bool3S.h"
+#include "bool3S_64.h"
+#include "bool3S_vector.h"
 #include "port.h"
+#include "arenaportas.h"
+#include "netlist.h"
+#include "gray3S.h"
+#include "sequencial.h"
+#include "otimizacao.h"
+#include "aig.h"
+#include "bdd.h"
+#include "equivalencia.h"
+#include "cones.h"
+#include "montecarlo.h"
+#include "falhas.h"
+#include "atpg.h"
 
 /// ###########################################################################
 /// ATENCAO PARA A CONVENCAO DOS NOMES E TIPOS PARA OS PARAMETROS DAS FUNCOES:
@@ -31,23 +46,92 @@ private:
   /// Dados
   /// ***********************
 
-  // Numero de entradas do circuito
-  unsigned Nin;
-
-  // Nao precisa manter variaveis para guardar o numero de saidas e ports.
-  // Essas informacoes estao armazenadas nos tamanhos (size) dos vetores correspondentes:
-  // id_out e ports, respectivamente
-  // Os metodos de consulta getNumInputs, getNumOutputs e getNumPorts dao acesso a essas
-  // informacoes de maneira eficiente
-
-  // As saidas
-  // As ids da origem dos sinais de saida do circuito
-  std::vector<int> id_out;      // vetor a ser alocado com dimensao "Nout"
-  // Os valores logicos das saidas do circuito
-  std::vector<bool3S> out_circ; // vetor a ser alocado com dimensao "Nout"
-
-  // As portas
-  std::vector<ptr_Port> ports;  // vetor a ser alocado com dimensao "Nports"
+  // Os dados que descrevem o circuito (entradas, saidas, portas e netlist)
+  // Sao compartilhados entre as copias de um mesmo circuito (copia na escrita):
+  // copiar um Circuito apenas copia um ponteiro, e os dados soh sao duplicados
+  // quando uma das copias eh alterada (metodo separar)
+  struct Dados {
+    // Numero de entradas do circuito
+    unsigned Nin;
+
+    // Nao precisa manter variaveis para guardar o numero de saidas e ports.
+    // Essas informacoes estao armazenadas nos tamanhos (size) dos vetores correspondentes:
+    // id_out e ports, respectivamente
+    // Os metodos de consulta getNumInputs, getNumOutputs e getNumPorts dao acesso a essas
+    // informacoes de maneira eficiente
+
+    // As saidas
+    // As ids da origem dos sinais de saida do circuito
+    std::vector<int> id_out;      // vetor a ser alocado com dimensao "Nout"
+
+    // As portas
+    std::vector<ptr_Port> ports;  // vetor a ser alocado com dimensao "Nports"
+    // A memoria das portas: todas sao criadas na arena, nenhuma com new
+    ArenaPortas arena;
+
+    // A netlist compilada (tipos de porta, entradas em formato CSR e ordem de
+    // simulacao levelizada), usada em todas as simulacoes
+    // Eh remontada pelo metodo compilar sempre que o circuito eh lido ou alterado
+    Netlist netlist;
+    // true se a netlist corresponde ao circuito atual (circuito valido)
+    bool compilado;
+
+    Dados(): Nin(0), id_out(), ports(), arena(), netlist(), compilado(false) {}
+    // Copia completa: as portas sao copiadas para a arena da copia
+    Dados(const Dados& D);
+    // Destroi as portas (a memoria eh liberada junto com a arena)
+    ~Dados();
+  private:
+    void operator=(const Dados&);
+  };
+  std::shared_ptr<Dados> dados;
+
+  // Os valores logicos das saidas do circuito (2 bits por valor)
+  bool3S_vector out_circ; // vetor a ser alocado com dimensao "Nout"
+
+  // Os estados de simulacao nao sao compartilhados: cada copia tem os seus
+  // Sao dimensionados na primeira simulacao depois de cada copia ou alteracao
+  // O estado (valores de todos os sinais) usado pelo metodo simular
+  EstadoNetlist estado;
+  // O estado usado pela simulacao sequencial (simularCiclo e simularSequencia):
+  // guarda os valores de todos os sinais de um ciclo para o seguinte
+  EstadoNetlist sequencial;
+
+  // Os dados de um circuito vazio (compartilhados por todos os circuitos vazios)
+  static const std::shared_ptr<Dados>& dadosVazios();
+  // Garante que os dados nao sao compartilhados com nenhuma outra copia,
+  // duplicando-os se necessario. Deve ser chamada antes de qualquer alteracao
+  void separar();
+  // Dimensiona o estado E para a netlist atual, se ainda nao estiver dimensionado
+  void prepararEstado(EstadoNetlist& E) const;
+
+  // Monta a netlist a partir das portas e saidas do circuito
+  // Se o circuito nao for valido, apenas faz compilado <- false
+  // Deve ser chamada sempre que o circuito for lido ou alterado
+  void compilar();
+
+  // Cria as portas e as saidas do circuito a partir da netlist jah montada,
+  // convertendo os sinais para ids (usada por lerBinario e otimizar)
+  // O circuito deve ter sido redimensionado (resize) para as dimensoes da netlist
+  void criarPortsNetlist();
+
+  // Preenche os planos das entradas de um bloco de W palavras com as combinacoes
+  // Linha0 a Linha0+64*W-1 da tabela verdade (usada por gerarEntradasBloco)
+  void preencherEntradas(unsigned long long Linha0, unsigned W,
+                         uint64_t* val, uint64_t* def) const;
+
+  // Simula as linhas Ini a Fim-1 da tabela verdade, em blocos de PALAVRAS_BLOCO
+  // palavras, e escreve as saidas da linha Ini+k em tabela[Pos+k*getNumOutputs()]
+  // em diante
+  // E deve ter sido preparado com W=PALAVRAS_BLOCO (usada por gerarTabela e
+  // gerarFaixaTabela)
+  void simularLinhas(EstadoNetlist& E, unsigned long long Ini, unsigned long long Fim,
+                     bool3S_vector& tabela, unsigned long long Pos) const;
+
+  // O corpo de gerarTabelaBooleana, depois dos testes de validade e de tamanho
+  // Lanca bad_alloc (ou length_error) se nao houver memoria para a tabela ou
+  // para o rascunho
+  bool gerarTabelaBooleanaInterna(bool3S_vector& tabela) const;
 
 public:
 
@@ -58,29 +142,32 @@ public:
   // As variaveis do tipo Circuit sao sempre criadas sem nenhum dado
   // A definicao do numero de entradas, saidas e ports eh feita ao ler do teclado ou arquivo
   // ou ao executar o metodo resize
+  // Nao aloca memoria: todos os circuitos vazios compartilham os mesmos dados
   Circuito();
 
   // Construtor por copia
-  // Nin e os vetores id_out e out_circ serao copias dos equivalentes no Circuit C
-  // O vetor ports terah a mesma dimensao do equivalente no Circuit C
-  // Serah necessario utilizar a funcao virtual clone para criar copias das portas
+  // Em tempo constante: os dados do circuito (Nin, id_out, ports e netlist) passam
+  // a ser compartilhados com C e soh sao duplicados quando um dos dois circuitos for
+  // alterado. out_circ eh copiado; os estados de simulacao nao sao copiados (a
+  // copia comeca com o estado sequencial inicial, todo UNDEF)
+  // Duas copias podem ser usadas ao mesmo tempo por threads diferentes
   Circuito(const Circuito& C);
+  // Construtor por movimento: toma os dados e os estados de C, que fica vazio
+  Circuito(Circuito&& C) noexcept;
   // Destrutor: apenas chama a funcao clear()
   ~Circuito();
 
-  // Limpa todo o conteudo do circuito. Faz Nin <- 0 e
-  // utiliza o metodo STL clear para limpar os vetores id_out, out_circ e ports
-  // ATENCAO: antes de dar um clear no vetor ports, tem que liberar (delete) as areas
-  // de memoria para as quais cada ponteiro desse vetor aponta.
+  // Limpa todo o conteudo do circuito. Faz Nin <- 0 e esvazia
+  // os vetores id_out, out_circ e ports
+  // Se os dados nao forem compartilhados com nenhuma copia, as portas sao destruidas
+  // e a arena em que foram criadas eh liberada de uma vez
   void clear();
 
   // Operador de atribuicao
-  // Atribui (faz copia) de Nin e dos vetores id_out e out_circ
-  // ATENCAO: antes de alterar o vetor ports, tem que liberar (delete) as areas
-  // de memoria para as quais cada ponteiro desse vetor aponta.
-  // O vetor ports terah a mesma dimensao do equivalente no Circuit C
-  // Serah necessario utilizar a funcao virtual clone para criar copias das portas
+  // Como o construtor por copia: passa a compartilhar os dados de C
   void operator=(const Circuito& C);
+  // Atribuicao por movimento: toma os dados e os estados de C, que fica vazio
+  void operator=(Circuito&& C) noexcept;
 
   // Redimensiona o circuito para passar a ter NI entradas, NO saidas e NP ports
   // Inicialmente checa os parametros. Caso sejam validos,
@@ -169,6 +256,35 @@ public:
   // ou 0 se parametro invalido
   int getId_inPort(int IdPort, unsigned I) const;
 
+  // Caracteristicas da ordem de simulacao
+
+  // As portas sao agrupadas em componentes fortemente conexas (SCC): portas que
+  // estao num mesmo laco de realimentacao ficam na mesma componente; as portas
+  // fora de lacos formam componentes de uma porta soh. As componentes ciclicas
+  // (com realimentacao) sao as unicas simuladas por iteracao
+
+  // Retorna o numero de niveis da ordem de simulacao (profundidade do circuito,
+  // contando cada componente ciclica como um unico nivel), ou 0 se o circuito
+  // nao for valido
+  unsigned getNumNiveis() const;
+
+  // Retorna true se o circuito eh valido e possui algum laco de realimentacao
+  bool realimentado() const;
+
+  // Retorna as ids das portas que estao em lacos de realimentacao
+  // (vetor vazio se nao ha realimentacao)
+  std::vector<int> getPortsRealimentadas() const;
+
+  // Retorna o numero de componentes fortemente conexas do circuito
+  // (0 se o circuito nao for valido)
+  unsigned getNumComponentes() const;
+
+  // Retorna o numero de componentes ciclicas (lacos de realimentacao independentes)
+  unsigned getNumComponentesCiclicas() const;
+
+  // Retorna o numero de portas de cada componente ciclica, em ordem de simulacao
+  std::vector<unsigned> getTamanhosComponentesCiclicas() const;
+
   /// ***********************
   /// Funcoes de modificacao
   /// ***********************
@@ -184,15 +300,61 @@ public:
 
   // A porta cuja id eh IdPort passa a ser do tipo Tipo (NT, AN, etc.), com NIn entradas
   // Depois de varios testes (Id, tipo, num de entradas), faz:
-  // 1) Libera a antiga area de memoria: delete ports[IdPort-1]
-  // 2) Cria a nova porta: ports[IdPort-1] <- new ... (de acordo com tipo)
+  // 1) Destroi a porta antiga (ArenaPortas::destruir); a memoria dela soh eh
+  //    liberada quando a arena for destruida
+  // 2) Cria a nova porta na arena do circuito: ports[IdPort-1] <- allocPort(...)
+  //    (de acordo com tipo)
   // 3) Fixa o numero de entrada: ports[IdPort-1]->setNumInputs(NIn)
   void setPort(int IdPort, std::string Tipo, unsigned NIn);
 
   // Altera a origem da I-esima entrada da porta cuja id eh IdPort, que passa a ser "IdOrig"
   // Depois de VARIOS testes (definedPort, validIndex, validIdOrig)
   // faz: ports[IdPort-1]->setId_in(I,Idorig)
-  void setId_inPort(int IdPort, unsigned I, int IdOrig) const;
+  void setId_inPort(int IdPort, unsigned I, int IdOrig);
+
+  /// ***********************
+  /// Otimizacao
+  /// ***********************
+
+  // Substitui o circuito por um equivalente com menos portas (ver otimizacao.h):
+  // remove as portas que nao alcancam nenhuma saida, elimina entradas repetidas
+  // e duplas negacoes e funde as portas identicas (hash estrutural)
+  // O numero de entradas e de saidas nao muda; as portas mantidas conservam a
+  // sua ordem, mas sao renumeradas (ver RelatorioOtimizacao::novaId)
+  // As copias do circuito nao sao afetadas; os estados de simulacao sao reiniciados
+  // Em R sao armazenadas as portas removidas e o motivo de cada remocao
+  // Retorna false (e nao altera o circuito) se o circuito nao for valido
+  bool otimizar(RelatorioOtimizacao& R);
+  bool otimizar();
+
+  // Converte o circuito em AIG (And-Inverter Graph, ver aig.h), que pode ser
+  // reescrito (Aig::reescrever) e simulado diretamente
+  // Retorna false se o circuito nao for valido ou se tiver lacos de realimentacao
+  bool gerarAig(Aig& A) const;
+
+  // Substitui o circuito pelo equivalente ao AIG A (ver Aig::gerarNetlist), com
+  // o mesmo numero de entradas e de saidas
+  // Retorna false (e nao altera o circuito) se A nao tiver entradas ou saidas
+  bool lerAig(const Aig& A);
+
+  // Constroi os BDDs das saidas do circuito (avaliacao simbolica, ver bdd.h), com
+  // a ordem das entradas dada pela heuristica H e no maximo MaxNos nos
+  // Com os BDDs, qualquer linha da tabela verdade eh obtida em O(Nin) e o numero
+  // de linhas em que cada saida vale TRUE, FALSE ou UNDEF eh contado sem percorrer
+  // a tabela, mesmo para circuitos com muitas entradas
+  // Retorna false se o circuito nao for valido ou se o limite de nos for ultrapassado
+  bool gerarBdd(BddCircuito& B, ordemVariaveis H=ordemVariaveis::MELHOR,
+                size_t MaxNos=10000000) const;
+
+  // Verifica se o circuito eh equivalente ao circuito C (mesmas saidas para todas
+  // as combinacoes de entrada, ver equivalencia.h), sem percorrer a tabela verdade:
+  // simulacao aleatoria (BlocosAleatorios blocos de 1024 combinacoes) e, se ela nao
+  // distinguir os circuitos, prova por SAT
+  // Em R fica o resultado: equivalentes ou uma combinacao de entrada que os distingue
+  // Retorna false se algum dos circuitos nao for valido ou se os numeros de
+  // entradas ou de saidas forem diferentes
+  bool verificarEquivalencia(const Circuito& C, ResultadoEquivalencia& R,
+                             unsigned BlocosAleatorios=64) const;
 
   /// ***********************
   /// E/S de dados
@@ -212,13 +374,26 @@ public:
   // Entrada dos dados de um circuito via arquivo
   // Leh do arquivo o cabecalho com o numero de entradas, saidas e portas
   // Em seguida, para cada porta leh e confere a id e o tipo (validType)
-  // Apos criada dinamicamente (allocPort) a porta do tipo correto, chama a
-  // funcao ler na porta recem-criada. O retorno da leitura da porta eh conferido
-  // bem como se a porta lida eh valida (validPort) para o circuito.
+  // Apos criada dinamicamente a porta do tipo correto, chama a funcao ler
+  // na porta recem-criada. O retorno da leitura da porta eh conferido
+  // bem como se as ids de origem sao validas para o circuito.
   // Em seguida, leh as ids de todas as saidas, que sao conferidas (validIdOrig)
+  // A leitura eh feita por LeitorCircuito (leitorcircuito.h): o arquivo eh
+  // mapeado em memoria e as linhas das portas sao lidas em paralelo
   // Retorna true se deu tudo OK; false se deu erro.
   // Deve utilizar o metodo ler da classe Port
+  // Se o arquivo estiver no formato binario (ver netlistbin.h), usa lerBinario
   bool ler(const std::string& arq);
+  // Igual a ler, mas em caso de erro armazena em Erro uma mensagem com a linha
+  // e a coluna em que o erro foi encontrado
+  bool ler(const std::string& arq, std::string& Erro);
+
+  // Entrada dos dados de um circuito a partir de um arquivo no formato binario
+  // (netlistbin.h). O arquivo eh mapeado em memoria e conferido; a netlist eh
+  // montada diretamente a partir das secoes do arquivo (sem conversao de texto)
+  // e as portas sao criadas a partir dela
+  // Retorna true se deu tudo OK; false se deu erro.
+  bool lerBinario(const std::string& arq);
 
   // Saida dos dados de um circuito (em tela ou arquivo, a mesma funcao serve para os dois)
   // Imprime os cabecalhos e os dados do circuito, caso o circuito seja valido
@@ -230,6 +405,11 @@ public:
   // Retorna true se deu tudo OK; false se deu erro
   bool salvar(const std::string& arq) const;
 
+  // Salvar circuito em arquivo no formato binario (netlistbin.h), caso o
+  // circuito seja valido
+  // Retorna true se deu tudo OK; false se deu erro
+  bool salvarBinario(const std::string& arq) const;
+
   /// ***********************
   /// SIMULACAO (funcao principal do circuito)
   /// ***********************
@@ -239,11 +419,228 @@ public:
   // validos (caso contrario retorna false)
   // A entrada eh um vetor de bool3S, com dimensao igual ao numero de entradas
   // do circuito.
+  // A simulacao eh feita pela netlist compilada, componente por componente, em
+  // ordem topologica: as portas fora de lacos sao simuladas uma unica vez. Somente
+  // as portas de cada laco (componente ciclica) sao simuladas repetidamente, e
+  // apenas entre si, ateh que nenhuma delas mude de valor.
+  // Os valores armazenados nas portas (Port::getOutput) nao sao alterados
   // Depois de simular todas as portas do circuito, calcula as saidas do
   // circuito (out_circ <- ...)
   // Retorna true se a simulacao foi OK; false caso deh erro
   bool simular(const std::vector<bool3S>& in_circ);
 
+  // Equivalente a simular, mas por eventos (incremental): parte do resultado da
+  // simulacao anterior e reavalia somente as portas alimentadas, direta ou
+  // indiretamente, pelas entradas cujo valor mudou. A propagacao para nas portas
+  // cuja saida nao muda. Se nao houver simulacao anterior (ou se o circuito foi
+  // alterado depois dela), faz uma simulacao completa
+  // Eh vantajosa quando poucas entradas mudam de uma chamada para a seguinte
+  bool simularIncremental(const std::vector<bool3S>& in_circ);
+
+  // Retorna o numero de avaliacoes de porta feitas na ultima chamada a simular
+  // ou simularIncremental
+  unsigned long getNumAvaliacoes() const;
+
+  /// ***********************
+  /// SIMULACAO SEQUENCIAL (ciclos de relogio)
+  /// ***********************
+
+  // Os lacos de realimentacao (latches, flip-flops) guardam o seu valor de um
+  // ciclo para o seguinte: a cada ciclo, os valores das entradas sao aplicados e
+  // o circuito eh simulado a partir do estado deixado pelo ciclo anterior (ver
+  // Netlist::simularCiclo). O estado eh independente do usado por simular e
+  // simularIncremental. Ao ler ou alterar o circuito, o estado volta a ser todo UNDEF
+
+  // Faz todos os sinais do estado sequencial UNDEF (estado inicial desconhecido)
+  void reiniciarSequencial();
+
+  // Simula um ciclo com os valores de entrada in_circ, a partir do estado atual,
+  // e calcula as saidas do circuito (out_circ <- ...)
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool simularCiclo(const std::vector<bool3S>& in_circ);
+
+  // Simula uma sequencia de ciclos: a cada ciclo, obtem as entradas de F, simula
+  // (como simularCiclo) e entrega as saidas a D. Para quando F nao tiver mais
+  // ciclos, quando D retornar false ou depois de MaxCiclos ciclos (0: sem limite)
+  // Nao faz nenhuma alocacao por ciclo. Ao final, out_circ contem as saidas do
+  // ultimo ciclo
+  // Retorna o numero de ciclos simulados (0 se o circuito nao for valido)
+  unsigned long long simularSequencia(FonteEstimulos& F, DestinoSaidas& D,
+                                      unsigned long long MaxCiclos=0);
+
+  /// ***********************
+  /// SIMULACAO BIT-PARALELA (64 combinacoes de entrada de uma so vez)
+  /// ***********************
+
+  // Retorna o numero de linhas da tabela verdade (3^Nin), ou 0 se o circuito nao
+  // tiver entradas ou se o numero de linhas nao couber em um unsigned long long
+  unsigned long long getNumLinhasTabela() const;
+
+  // Gera as 64 combinacoes de entrada que correspondem as linhas Linha0 a Linha0+63
+  // da tabela verdade, na mesma ordem em que sao exibidas: a ultima entrada varia
+  // mais rapido, na sequencia UNDEF, FALSE, TRUE.
+  // O bit K de in_circ[j] eh o valor da entrada j na linha Linha0+K
+  // As posicoes que passam da ultima linha da tabela ficam com todas as entradas UNDEF
+  void gerarEntradas64(unsigned long long Linha0, std::vector<bool3S_64>& in_circ) const;
+
+  // Equivalente a simular, mas para 64 combinacoes de entrada de uma so vez
+  // A entrada eh um vetor de bool3S_64, com dimensao igual ao numero de entradas
+  // do circuito. O resultado (valores das saidas do circuito) eh armazenado
+  // em out_circ64, que eh redimensionado para o numero de saidas.
+  // Nao altera os valores armazenados nas portas nem em out_circ
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool simular64(const std::vector<bool3S_64>& in_circ,
+                 std::vector<bool3S_64>& out_circ64) const;
+
+  /// ***********************
+  /// SIMULACAO EM BLOCOS (64*W combinacoes de entrada de uma so vez)
+  /// ***********************
+
+  // Os valores de um bloco sao armazenados em dois vetores de planos (val e def,
+  // com a mesma codificacao de bool3S_64), com W palavras de 64 bits por sinal:
+  // o bit K da palavra w do sinal j estah em val[j*W+w] e def[j*W+w] e
+  // corresponde aa combinacao de entrada 64*w+K do bloco
+
+  // Numero de palavras por bloco usado em gerarTabela (1024 combinacoes de entrada)
+  static const unsigned PALAVRAS_BLOCO = PALAVRAS_BLOCO3S;
+
+  // Equivalente a gerarEntradas64, para as 64*W linhas a partir de Linha0
+  void gerarEntradasBloco(unsigned long long Linha0, unsigned W,
+                          std::vector<uint64_t>& val_in, std::vector<uint64_t>& def_in) const;
+
+  // Equivalente a simular64, para 64*W combinacoes de entrada
+  // Os vetores de entrada devem ter W*getNumInputs() palavras; os de saida sao
+  // redimensionados para W*getNumOutputs() palavras
+  // Cada porta eh avaliada pelos kernels vetorizados (kernel3S), a partir da netlist
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool simularBloco(const std::vector<uint64_t>& val_in, const std::vector<uint64_t>& def_in,
+                    unsigned W,
+                    std::vector<uint64_t>& val_out, std::vector<uint64_t>& def_out) const;
+
+  // Gera todas as linhas da tabela verdade, simulando 64*PALAVRAS_BLOCO linhas de cada vez
+  // O resultado eh armazenado em tabela (compactada, 2 bits por valor), que eh
+  // redimensionada para getNumLinhasTabela()*getNumOutputs() elementos: o valor
+  // da saida de id IdOutput na linha L estah em tabela[L*getNumOutputs() + IdOutput-1]
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool gerarTabela(bool3S_vector& tabela) const;
+
+  // Numero de linhas de cada tarefa em gerarTabelaParalela (64 blocos)
+  // Eh multiplo de bool3S_vector::POR_PALAVRA, de modo que duas tarefas nunca
+  // escrevem na mesma palavra da tabela
+  static const unsigned LINHAS_TAREFA = 64*64*PALAVRAS_BLOCO;
+
+  // Gera a tabela verdade (mesmo resultado de gerarTabela) em paralelo, com
+  // NumThreads threads (0: uma por nucleo do processador)
+  // As linhas sao divididas em tarefas de LINHAS_TAREFA linhas consecutivas; cada
+  // thread pega a proxima tarefa livre, simula com o seu proprio estado e escreve
+  // diretamente na sua faixa da tabela, sem nenhuma sincronizacao alem do
+  // contador de tarefas
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool gerarTabelaParalela(bool3S_vector& tabela, unsigned NumThreads=0) const;
+
+  // Gera em paralelo apenas as linhas Ini a Fim-1 da tabela verdade
+  // tabela eh redimensionada para (Fim-Ini)*getNumOutputs() elementos: o valor da
+  // saida de id IdOutput na linha L estah em tabela[(L-Ini)*getNumOutputs() + IdOutput-1]
+  // Permite percorrer tabelas muito grandes por partes, com memoria limitada
+  // (reusando o mesmo vetor, nao ha novas alocacoes)
+  // Retorna false se a faixa de linhas for invalida
+  bool gerarFaixaTabela(unsigned long long Ini, unsigned long long Fim,
+                        bool3S_vector& tabela, unsigned NumThreads=0) const;
+
+  // Gera todas as linhas da tabela verdade por simulacao incremental: as combinacoes
+  // de entrada sao percorridas em codigo de Gray ternario (EnumeradorGray3S), de modo
+  // que de uma linha para a seguinte muda uma unica entrada e soh as portas afetadas
+  // por ela sao reavaliadas. O resultado eh igual ao de gerarTabela (mesma ordem
+  // das linhas); eh vantajosa em circuitos grandes em que cada entrada afeta
+  // uma pequena parte das portas
+  // Retorna true se a simulacao foi OK; false caso deh erro
+  bool gerarTabelaIncremental(bool3S_vector& tabela) const;
+
+  // Gera a tabela verdade simulando apenas as 2^n combinacoes de entrada sem
+  // UNDEF (simulacao booleana em bloco, Netlist::simularBlocoBooleano) e deduzindo
+  // delas as demais linhas: a saida numa linha com entradas UNDEF eh o valor comum
+  // a todos os "completamentos" da linha (as linhas obtidas trocando cada UNDEF por
+  // FALSE ou TRUE), ou UNDEF se eles divergirem. As linhas sao deduzidas por uma
+  // transformada sobre a tabela (n passadas, cada linha de cada passada com uma
+  // unica operacao), sem nenhuma simulacao. Mesma ordem e formato de gerarTabela
+  // Semantica, comparada com a propagacao porta a porta de bool3S (gerarTabela):
+  // - linhas sem UNDEF: exatamente iguais
+  // - linhas com UNDEF: sempre que gerarTabela dah um valor definido, este modo dah
+  //   o mesmo valor (a propagacao de bool3S eh monotona); mas este modo dah um valor
+  //   definido tambem quando um UNDEF chega a uma porta por dois caminhos que se
+  //   cancelam, e gerarTabela dah UNDEF. Ex., com x=UNDEF: AN(x,NT(x)) = FALSE,
+  //   OR(x,NT(x)) = TRUE, XO(x,x) = FALSE, e um multiplexador com as duas entradas
+  //   de dados TRUE dah TRUE com a selecao UNDEF. Nunca ocorre o contrario
+  // - circuitos com lacos: as linhas booleanas sao simuladas em 3 estados, como em
+  //   gerarTabela (um laco pode ficar UNDEF mesmo com as entradas definidas); um
+  //   completamento UNDEF torna UNDEF a linha deduzida
+  // Custo: 2^n simulacoes e n*3^n*Nout operacoes de 1 byte, contra 3^n simulacoes;
+  // a memoria extra eh de 3^n*Nout bytes (4 vezes a propria tabela)
+  // Retorna false se o circuito nao for valido ou se a tabela for grande demais
+  // (3^n*Nout maior que SIZE_MAX, ou sem memoria para a tabela e o rascunho)
+  bool gerarTabelaBooleana(bool3S_vector& tabela) const;
+
+  /// ***********************
+  /// CONES DAS SAIDAS (tabelas restritas ao suporte de cada saida)
+  /// ***********************
+
+  // Calcula o suporte (entradas das quais a saida depende) e o cone (portas das
+  // quais a saida depende) de cada saida (ver cones.h); o cone da saida de id
+  // IdOutput estah em Cones[IdOutput-1]
+  // Retorna false se o circuito nao for valido
+  bool analisarCones(std::vector<ConeSaida>& Cones) const;
+
+  // Gera o circuito formado apenas pelo cone da saida de id IdOutput, com uma
+  // entrada para cada entrada do suporte (na ordem de ConeSaida::suporte) e uma saida
+  // Retorna false se o circuito nao for valido ou se IdOutput for invalido
+  bool extrairCone(int IdOutput, Circuito& C) const;
+
+  // Gera a tabela verdade de cada saida apenas sobre o seu suporte (3^k linhas,
+  // com k entradas no suporte, em vez de 3^Nin), simulando apenas as portas do
+  // cone da saida (com gerarTabelaParalela e NumThreads threads). As saidas com o
+  // mesmo suporte sao simuladas juntas, no mesmo circuito
+  // A tabela da saida de id IdOutput estah em Tabelas[IdOutput-1]; os valores
+  // sao iguais aos da tabela completa (ver TabelaSaida::getValorLinha)
+  // Retorna false se o circuito nao for valido ou se alguma tabela for grande demais
+  bool gerarTabelasSaidas(std::vector<TabelaSaida>& Tabelas, unsigned NumThreads=0) const;
+
+  /// ***********************
+  /// SIMULACAO ALEATORIA (Monte Carlo)
+  /// ***********************
+
+  // Simula NumVetores combinacoes de entrada sorteadas com a semente Semente e as
+  // probabilidades P de cada entrada (P vazio: FALSE, TRUE e UNDEF equiprovaveis)
+  // e guarda em E, para cada entrada, porta e saida, a frequencia de cada valor e a
+  // taxa de troca (ver montecarlo.h). Em E, o sinal da entrada de id -i eh i-1 e o
+  // da porta de id p eh getNumInputs()+p-1
+  // Se Tolerancia > 0, para assim que o erro padrao de todas as frequencias for no
+  // maximo Tolerancia (ex.: 0.005 com cerca de 10000 combinacoes)
+  // Retorna false se o circuito nao for valido ou se P for invalido
+  bool simularMonteCarlo(EstatisticaSinais& E, unsigned long long NumVetores,
+                         uint64_t Semente=1,
+                         const std::vector<ProbabilidadeEntrada>& P=std::vector<ProbabilidadeEntrada>(),
+                         double Tolerancia=0.0) const;
+
+  /// ***********************
+  /// SIMULACAO DE FALHAS
+  /// ***********************
+
+  // Cria em S a lista de falhas stuck-at do circuito (saida e entradas de cada
+  // porta, entradas do circuito), com ou sem colapsamento das falhas equivalentes
+  // A cobertura de um conjunto de vetores de teste eh obtida com S.simular (ver falhas.h)
+  // Retorna false se o circuito nao for valido
+  bool gerarFalhas(SimuladorFalhas& S, bool Colapsar=true) const;
+
+  /// ***********************
+  /// GERACAO DE VETORES DE TESTE
+  /// ***********************
+
+  // Gera em R um conjunto compacto de vetores de teste para as falhas stuck-at
+  // (colapsadas) do circuito, pelo algoritmo PODEM com compactacao dinamica e
+  // estatica (ver atpg.h), ateh atingir a cobertura Op.coberturaAlvo
+  // Retorna false se o circuito nao for valido
+  bool gerarTestes(ResultadoAtpg& R, const OpcoesAtpg& Op=OpcoesAtpg()) const;
+
 
 };
 
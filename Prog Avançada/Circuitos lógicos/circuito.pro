@@ -11,6 +11,9 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = Circuito
 TEMPLATE = app
 
+# std::thread e std::atomic (gerarTabelaParalela); std::from_chars (C++17, leitorcircuito)
+CONFIG += c++17 thread
+
 # The following define makes your compiler emit warnings if you use
 # any feature of Qt which as been marked as deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -24,21 +27,59 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 
 SOURCES += main.cpp\
+    aig.cpp \
+    arenaportas.cpp \
+    bdd.cpp \
+    sat.cpp \
+    equivalencia.cpp \
+    cones.cpp \
+    montecarlo.cpp \
+    falhas.cpp \
+    atpg.cpp \
     bool3S.cpp \
+    bool3S_vector.cpp \
     circuito.cpp \
+    gray3S.cpp \
+    kernel3S.cpp \
+    leitorcircuito.cpp \
+    netlist.cpp \
+    netlistbin.cpp \
+    otimizacao.cpp \
     maincircuito.cpp \
+    modelotabelaverdade.cpp \
     modificarporta.cpp \
     newcircuito.cpp \
     modificarsaida.cpp \
-    port.cpp
+    port.cpp \
+    sequencial.cpp
 
 HEADERS  += maincircuito.h \
+    modelotabelaverdade.h \
+    aig.h \
+    arenaportas.h \
+    bdd.h \
+    sat.h \
+    equivalencia.h \
+    cones.h \
+    montecarlo.h \
+    falhas.h \
+    atpg.h \
     bool3S.h \
+    bool3S_64.h \
+    bool3S_lut.h \
+    bool3S_vector.h \
     circuito.h \
+    gray3S.h \
+    kernel3S.h \
+    leitorcircuito.h \
+    netlist.h \
+    netlistbin.h \
+    otimizacao.h \
     modificarporta.h \
     newcircuito.h \
     modificarsaida.h \
-    port.h
+    port.h \
+    sequencial.h
 
 FORMS    += maincircuito.ui \
     modificarporta.ui \
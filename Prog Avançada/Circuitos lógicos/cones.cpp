@@ -0,0 +1,103 @@
+#include <algorithm>
+#include "cones.h"
+
+using namespace std;
+
+/// ***********************
+/// Cones e suportes
+/// ***********************
+
+void analisarCones(const Netlist& N, std::vector<ConeSaida>& Cones)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais();
+  Cones.resize(N.getNumOutputs());
+  // Uma rodada por saida: nao eh preciso limpar as marcas entre as saidas
+  vector<uint32_t> marca(NS, 0);
+  vector<unsigned> origem(1);
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    origem[0] = N.getSaida(j);
+    N.marcarCone(origem, marca, j+1);
+    ConeSaida& C = Cones[j];
+    C.suporte.clear();
+    C.portas.clear();
+    for (unsigned s=0; s<NS; s++)
+    {
+      if (marca[s] != j+1) continue;
+      if (s < NI) C.suporte.push_back(s);
+      else C.portas.push_back(s-NI);
+    }
+    if (C.suporte.empty()) C.suporte.push_back(0);
+  }
+}
+
+void extrairCone(const Netlist& N, const std::vector<unsigned>& Saidas,
+                 const std::vector<unsigned>& Suporte, std::vector<uint8_t>& Tipos,
+                 std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                 std::vector<uint32_t>& SaidasCone)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais(), K = Suporte.size();
+
+  vector<uint32_t> marca(NS, 0);
+  vector<unsigned> origens;
+  for (unsigned j : Saidas) origens.push_back(N.getSaida(j));
+  N.marcarCone(origens, marca, 1);
+
+  // O novo sinal de cada sinal do cone
+  vector<uint32_t> novo(NS, 0);
+  for (unsigned k=0; k<K; k++) novo[Suporte[k]] = k;
+  unsigned Nportas = 0;
+  for (unsigned p=0; p<N.getNumPorts(); p++)
+  {
+    if (marca[NI+p]) novo[NI+p] = K + Nportas++;
+  }
+
+  Tipos.clear();
+  FaninIni.assign(1, 0);
+  Fanin.clear();
+  SaidasCone.clear();
+  for (unsigned p=0; p<N.getNumPorts(); p++)
+  {
+    if (!marca[NI+p]) continue;
+    Tipos.push_back(uint8_t(N.getTipo(p)));
+    const unsigned* in = N.getFanin(p);
+    for (unsigned j=0; j<N.getNumFanin(p); j++) Fanin.push_back(novo[in[j]]);
+    FaninIni.push_back(Fanin.size());
+  }
+  for (unsigned j : Saidas) SaidasCone.push_back(novo[N.getSaida(j)]);
+  // O circuito precisa de ao menos uma porta
+  Netlist::garantirPorta(K, Tipos, FaninIni, Fanin, SaidasCone);
+}
+
+/// ***********************
+/// Tabela de uma saida
+/// ***********************
+
+void TabelaSaida::set(const std::vector<unsigned>& Suporte, bool3S_vector& Tabela)
+{
+  suporte = Suporte;
+  tabela.clear();
+  swap(tabela, Tabela);
+}
+
+bool3S TabelaSaida::getValor(const std::vector<bool3S>& In) const
+{
+  // Os digitos da linha sao os codigos de bool3S: UNDEF=0, FALSE=1, TRUE=2
+  unsigned long long L = 0;
+  for (unsigned k=0; k<suporte.size(); k++) L = 3*L + unsigned(In[suporte[k]]);
+  return tabela[L];
+}
+
+bool3S TabelaSaida::getValorLinha(unsigned long long L, unsigned NI) const
+{
+  // Os digitos da linha da tabela completa, da ultima entrada para a primeira
+  vector<unsigned> digito(NI);
+  for (unsigned i=NI; i>0; i--)
+  {
+    digito[i-1] = L%3;
+    L /= 3;
+  }
+  unsigned long long Ls = 0;
+  for (unsigned k=0; k<suporte.size(); k++) Ls = 3*Ls + digito[suporte[k]];
+  return tabela[Ls];
+}
@@ -0,0 +1,78 @@
+#ifndef _CONES_H_
+#define _CONES_H_
+
+#include <cstdint>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_vector.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// SUPORTE E CONE DAS SAIDAS
+/// O cone de uma saida eh o conjunto das portas das quais ela depende (as portas
+/// de onde existe um caminho ateh a saida); o suporte eh o conjunto das entradas
+/// do circuito que alimentam o cone. A saida soh depende das entradas do seu
+/// suporte, de modo que a sua coluna da tabela verdade eh determinada por uma
+/// tabela de 3^k linhas (k: tamanho do suporte), em vez de 3^n, e cada linha
+/// dessa tabela custa a simulacao apenas das portas do cone.
+///
+/// Uma componente ciclica estah inteira dentro ou inteira fora de um cone (as
+/// portas de um laco alcancam umas as outras), de modo que o cone, simulado
+/// sozinho, tem o mesmo resultado que dentro do circuito completo.
+///
+/// O suporte eh estrutural: pode conter entradas das quais a saida nao depende de
+/// fato (ex.: uma entrada que soh chega aa saida por dois caminhos que se anulam).
+/// ###########################################################################
+
+// O cone e o suporte de uma saida
+struct ConeSaida {
+  // As entradas do circuito (de 0 a Nin-1) que alimentam a saida, em ordem crescente
+  // Se a saida nao depender de nenhuma entrada (laco sem entradas), contem a
+  // entrada 0: um circuito tem sempre pelo menos uma entrada
+  std::vector<unsigned> suporte;
+  // As portas do cone (de 0 a Nports-1), em ordem crescente
+  std::vector<unsigned> portas;
+};
+
+// Calcula o cone e o suporte de cada saida da netlist N (que deve estar montada)
+// Cones eh redimensionado para N.getNumOutputs() elementos
+void analisarCones(const Netlist& N, std::vector<ConeSaida>& Cones);
+
+// Gera a netlist plana (como no formato binario, ver netlistbin.h) formada pelo
+// cone das saidas Saidas da netlist N, cujo suporte (uniao dos suportes) eh Suporte
+// As entradas sao renumeradas: a entrada k da nova netlist eh a entrada Suporte[k]
+// de N; as portas mantem a ordem relativa; a saida q eh a saida Saidas[q] de N
+// Se todas as saidas vierem de entradas, eh criada uma porta AN(x,x), como em
+// otimizarNetlist (o circuito deve ter ao menos uma porta)
+void extrairCone(const Netlist& N, const std::vector<unsigned>& Saidas,
+                 const std::vector<unsigned>& Suporte, std::vector<uint8_t>& Tipos,
+                 std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                 std::vector<uint32_t>& SaidasCone);
+
+// A tabela verdade de uma saida, restrita ao seu suporte
+// A linha L da tabela corresponde aos valores das entradas do suporte na mesma
+// ordem da tabela completa (a ultima entrada do suporte varia mais rapido)
+class TabelaSaida {
+private:
+  // As entradas do circuito das quais a saida depende (ConeSaida::suporte)
+  std::vector<unsigned> suporte;
+  // Os 3^k valores da saida
+  bool3S_vector tabela;
+
+public:
+  TabelaSaida(): suporte(), tabela() {}
+
+  // Fixa o suporte e a tabela (o conteudo de Tabela eh transferido, sem copia)
+  void set(const std::vector<unsigned>& Suporte, bool3S_vector& Tabela);
+
+  const std::vector<unsigned>& getSuporte() const {return suporte;}
+  const bool3S_vector& getTabela() const {return tabela;}
+  unsigned long long getNumLinhas() const {return tabela.size();}
+
+  // O valor da saida para os valores In de todas as entradas do circuito
+  bool3S getValor(const std::vector<bool3S>& In) const;
+  // O valor da saida na linha L da tabela verdade completa de um circuito de NI entradas
+  bool3S getValorLinha(unsigned long long L, unsigned NI) const;
+};
+
+#endif // _CONES_H_
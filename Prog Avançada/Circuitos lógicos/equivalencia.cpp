@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <unordered_map>
+#include "equivalencia.h"
+#include "montecarlo.h"
+#include "sat.h"
+
+using namespace std;
+
+/// ***********************
+/// Resultado
+/// ***********************
+
+void ResultadoEquivalencia::clear()
+{
+  equivalentes = false;
+  contraexemplo.clear();
+  saida = 0;
+  valorA = valorB = bool3S::UNDEF;
+  porSimulacao = false;
+  simuladas = 0;
+  variaveis = 0;
+  clausulas = 0;
+  conflitos = 0;
+}
+
+std::ostream& ResultadoEquivalencia::imprimir(std::ostream& O, bool Estatisticas) const
+{
+  if (equivalentes) O << "EQUIVALENTES\n";
+  else
+  {
+    O << "DIFERENTES\nEntradas: ";
+    for (unsigned i=0; i<contraexemplo.size(); i++) O << contraexemplo[i];
+    O << "\nSaida " << saida+1 << ": " << valorA << " x " << valorB << '\n';
+  }
+  if (Estatisticas)
+  {
+    O << "Combinacoes simuladas: " << simuladas << '\n';
+    if (porSimulacao) O << "Contra-exemplo encontrado na simulacao\n";
+    else O << "SAT: " << variaveis << " variaveis, " << clausulas << " clausulas, "
+           << conflitos << " conflitos\n";
+  }
+  return O;
+}
+
+/// ***********************
+/// Codificacao em CNF
+/// ***********************
+
+// Os literais T e F de um sinal (dual-rail)
+struct Trilhos {
+  uint32_t T, F;
+  bool operator!=(const Trilhos& X) const {return T!=X.T || F!=X.F;}
+};
+
+// Espalhamento de uma lista de literais (tabela de portas AND jah codificadas)
+struct EspalharLiterais {
+  size_t operator()(const vector<uint32_t>& L) const
+  {
+    return size_t(espalharSinais(L.data(), L.size()));
+  }
+};
+
+// Monta as clausulas das portas de uma ou mais netlists num resolvedor SAT
+// Todas as operacoes sao reduzidas a AND de literais (OR por De Morgan), com as
+// simplificacoes booleanas (as variaveis dos trilhos sao booleanas) e o hash
+// estrutural das portas AND
+class CodificadorCnf {
+private:
+  SolverSat& S;
+  // O literal constante falso
+  uint32_t falso;
+  // As portas AND jah codificadas: as entradas (ordenadas) e o literal da saida
+  unordered_map<vector<uint32_t>, uint32_t, EspalharLiterais> portas;
+
+public:
+  explicit CodificadorCnf(SolverSat& Solver): S(Solver), falso(0), portas()
+  {
+    falso = SolverSat::literal(S.novaVariavel(), false);
+    S.adicionarClausula(SolverSat::negar(falso));
+  }
+
+  uint32_t getFalso() const {return falso;}
+  uint32_t getVerdade() const {return SolverSat::negar(falso);}
+
+  // O literal do AND dos literais L
+  uint32_t e(vector<uint32_t> L);
+  // O literal do OR dos literais L
+  uint32_t ou(vector<uint32_t> L)
+  {
+    for (uint32_t& X : L) X = SolverSat::negar(X);
+    return SolverSat::negar(e(L));
+  }
+  // O literal do XOR de A e B
+  uint32_t xou(uint32_t A, uint32_t B)
+  {
+    return ou({e({A, SolverSat::negar(B)}), e({SolverSat::negar(A), B})});
+  }
+
+  // Os trilhos da saida de uma porta do tipo T com as N entradas In
+  Trilhos porta(tipoPorta T, const Trilhos* In, unsigned N);
+  // Codifica as portas da netlist N que alcancam alguma saida, com os trilhos
+  // Entradas nas entradas do circuito; retorna os trilhos das saidas em Saidas
+  void codificar(const Netlist& N, const vector<Trilhos>& Entradas, vector<Trilhos>& Saidas);
+};
+
+uint32_t CodificadorCnf::e(vector<uint32_t> L)
+{
+  // x.1 = x, x.0 = 0, x.x = x e x.~x = 0 (literais booleanos): depois de
+  // ordenar, x e ~x ficam lado a lado
+  sort(L.begin(), L.end());
+  L.erase(unique(L.begin(), L.end()), L.end());
+  size_t n = 0;
+  for (size_t k=0; k<L.size(); k++)
+  {
+    if (L[k]==falso) return falso;
+    if (k+1<L.size() && L[k+1]==SolverSat::negar(L[k])) return falso;
+    if (L[k] != getVerdade()) L[n++] = L[k];
+  }
+  L.resize(n);
+  if (L.empty()) return getVerdade();
+  if (L.size() == 1) return L[0];
+
+  auto it = portas.find(L);
+  if (it != portas.end()) return it->second;
+  // X <-> L0.L1...: (~X + Li) para cada i e (X + ~L0 + ~L1 + ...)
+  uint32_t X = SolverSat::literal(S.novaVariavel(), false);
+  vector<uint32_t> clausula(1, X);
+  for (uint32_t Li : L)
+  {
+    S.adicionarClausula(SolverSat::negar(X), Li);
+    clausula.push_back(SolverSat::negar(Li));
+  }
+  S.adicionarClausula(clausula);
+  portas.emplace(std::move(L), X);
+  return X;
+}
+
+Trilhos CodificadorCnf::porta(tipoPorta T, const Trilhos* In, unsigned N)
+{
+  vector<uint32_t> t(N), f(N);
+  for (unsigned k=0; k<N; k++)
+  {
+    t[k] = In[k].T;
+    f[k] = In[k].F;
+  }
+  Trilhos R;
+  switch (T)
+  {
+  case tipoPorta::NT:
+    R.T = In[0].F;
+    R.F = In[0].T;
+    return R;
+  case tipoPorta::AN:
+  case tipoPorta::NA:
+    // TRUE se todas TRUE; FALSE se alguma FALSE
+    R.T = e(t);
+    R.F = ou(f);
+    break;
+  case tipoPorta::OR:
+  case tipoPorta::NO:
+    // TRUE se alguma TRUE; FALSE se todas FALSE
+    R.T = ou(t);
+    R.F = e(f);
+    break;
+  case tipoPorta::XO:
+  case tipoPorta::NX:
+  default:
+    // Duas a duas: TRUE se uma TRUE e a outra FALSE; FALSE se as duas iguais
+    R = In[0];
+    for (unsigned k=1; k<N; k++)
+    {
+      Trilhos X;
+      X.T = ou({e({R.T, In[k].F}), e({R.F, In[k].T})});
+      X.F = ou({e({R.T, In[k].T}), e({R.F, In[k].F})});
+      R = X;
+    }
+    break;
+  }
+  if (T==tipoPorta::NA || T==tipoPorta::NO || T==tipoPorta::NX) swap(R.T, R.F);
+  return R;
+}
+
+void CodificadorCnf::codificar(const Netlist& N, const vector<Trilhos>& Entradas,
+                               vector<Trilhos>& Saidas)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais();
+
+  // As portas que alcancam alguma saida
+  vector<uint32_t> util;
+  N.marcarObservaveis(util);
+
+  vector<Trilhos> sinal(NS);
+  for (unsigned i=0; i<NI; i++) sinal[i] = Entradas[i];
+  vector<Trilhos> in, novo;
+  // Os trilhos das entradas da porta P
+  auto entradas = [&](unsigned P)
+  {
+    in.resize(N.getNumFanin(P));
+    for (unsigned j=0; j<in.size(); j++) in[j] = sinal[N.getFanin(P)[j]];
+  };
+
+  for (unsigned c=0; c<N.getNumComponentes(); c++)
+  {
+    const unsigned* portas = N.getPortasComponente(c);
+    const unsigned tam = N.getTamanhoComponente(c);
+    // Numa componente ciclica, ou todas as portas sao uteis ou nenhuma eh
+    if (!util[NI+portas[0]]) continue;
+    if (!N.getCiclica(c))
+    {
+      entradas(portas[0]);
+      sinal[NI+portas[0]] = porta(N.getTipo(portas[0]), in.data(), in.size());
+      continue;
+    }
+
+    // Componente ciclica: rodadas a partir de todas UNDEF (T = F = 0)
+    Trilhos indefinido = {falso, falso};
+    for (unsigned k=0; k<tam; k++) sinal[NI+portas[k]] = indefinido;
+    novo.resize(tam);
+    for (unsigned r=0; r<tam; r++)
+    {
+      for (unsigned k=0; k<tam; k++)
+      {
+        entradas(portas[k]);
+        novo[k] = porta(N.getTipo(portas[k]), in.data(), in.size());
+      }
+      bool mudou = false;
+      for (unsigned k=0; k<tam; k++)
+      {
+        if (novo[k] != sinal[NI+portas[k]]) mudou = true;
+        sinal[NI+portas[k]] = novo[k];
+      }
+      if (!mudou) break;
+    }
+  }
+
+  Saidas.resize(N.getNumOutputs());
+  for (unsigned j=0; j<N.getNumOutputs(); j++) Saidas[j] = sinal[N.getSaida(j)];
+}
+
+/// ***********************
+/// Verificacao
+/// ***********************
+
+// Simula a combinacao de entrada In nas netlists A e B e guarda em R o
+// contra-exemplo (a primeira saida diferente)
+// Retorna false se todas as saidas forem iguais
+static bool registrarContraexemplo(const Netlist& A, const Netlist& B,
+                                   const vector<bool3S>& In, ResultadoEquivalencia& R)
+{
+  EstadoNetlist EA, EB;
+  A.prepararEstado(EA);
+  B.prepararEstado(EB);
+  for (unsigned i=0; i<In.size(); i++) EA.valor[i] = EB.valor[i] = In[i];
+  A.simular(EA);
+  B.simular(EB);
+  for (unsigned j=0; j<A.getNumOutputs(); j++)
+  {
+    bool3S va = EA.valor[A.getSaida(j)], vb = EB.valor[B.getSaida(j)];
+    if (va != vb)
+    {
+      R.equivalentes = false;
+      R.contraexemplo = In;
+      R.saida = j;
+      R.valorA = va;
+      R.valorB = vb;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool verificarEquivalencia(const Netlist& A, const Netlist& B, ResultadoEquivalencia& R,
+                           unsigned BlocosAleatorios)
+{
+  R.clear();
+  if (A.getNumInputs()!=B.getNumInputs() || A.getNumOutputs()!=B.getNumOutputs()) return false;
+  const unsigned NI = A.getNumInputs(), NO = A.getNumOutputs(), W = PALAVRAS_BLOCO3S;
+
+  ///1) SIMULACAO ALEATORIA
+  if (BlocosAleatorios > 0)
+  {
+    EstadoNetlist EA, EB;
+    A.prepararEstado(EA, W);
+    B.prepararEstado(EB, W);
+    GeradorXoshiro G(0x9E3779B97F4A7C15ull);
+    vector<bool3S> in(NI);
+    for (unsigned b=0; b<BlocosAleatorios; b++)
+    {
+      // Cada valor eh UNDEF com probabilidade 1/4 e TRUE ou FALSE com 3/8
+      for (unsigned k=0; k<NI*W; k++)
+      {
+        uint64_t def = G() | G();
+        uint64_t val = G() & def;
+        EA.val[k] = EB.val[k] = val;
+        EA.def[k] = EB.def[k] = def;
+      }
+      A.simularBloco(EA);
+      B.simularBloco(EB);
+      R.simuladas += 64*W;
+
+      for (unsigned j=0; j<NO; j++)
+      {
+        const unsigned sa = A.getSaida(j)*W, sb = B.getSaida(j)*W;
+        for (unsigned w=0; w<W; w++)
+        {
+          uint64_t dif = (EA.val[sa+w]^EB.val[sb+w]) | (EA.def[sa+w]^EB.def[sb+w]);
+          if (dif == 0) continue;
+          unsigned bit = 0;
+          while (!((dif>>bit) & 1)) bit++;
+          for (unsigned i=0; i<NI; i++)
+          {
+            if (!((EA.def[i*W+w]>>bit) & 1)) in[i] = bool3S::UNDEF;
+            else in[i] = ((EA.val[i*W+w]>>bit) & 1) ? bool3S::TRUE : bool3S::FALSE;
+          }
+          R.porSimulacao = true;
+          registrarContraexemplo(A, B, in, R);
+          return true;
+        }
+      }
+    }
+  }
+
+  ///2) PROVA POR SAT
+  SolverSat S;
+  CodificadorCnf cod(S);
+  // As entradas, compartilhadas: T e F nao podem ser 1 ao mesmo tempo
+  vector<Trilhos> entradas(NI), saidasA, saidasB;
+  for (unsigned i=0; i<NI; i++)
+  {
+    entradas[i].T = SolverSat::literal(S.novaVariavel(), false);
+    entradas[i].F = SolverSat::literal(S.novaVariavel(), false);
+    S.adicionarClausula(SolverSat::negar(entradas[i].T), SolverSat::negar(entradas[i].F));
+  }
+  cod.codificar(A, entradas, saidasA);
+  cod.codificar(B, entradas, saidasB);
+
+  // O miter: alguma saida com T ou F diferente nos dois circuitos
+  // As saidas que o hash estrutural jah tornou identicas ficam de fora
+  vector<uint32_t> diferente;
+  for (unsigned j=0; j<NO; j++)
+  {
+    if (!(saidasA[j] != saidasB[j])) continue;
+    uint32_t d = cod.ou({cod.xou(saidasA[j].T, saidasB[j].T),
+                         cod.xou(saidasA[j].F, saidasB[j].F)});
+    if (d != cod.getFalso()) diferente.push_back(d);
+  }
+  resultadoSat res = resultadoSat::INSATISFAZIVEL;
+  if (!diferente.empty() && S.adicionarClausula(diferente)) res = S.resolver();
+  R.variaveis = S.getNumVariaveis();
+  R.clausulas = S.getNumClausulas();
+  R.conflitos = S.getNumConflitos();
+
+  if (res == resultadoSat::INSATISFAZIVEL)
+  {
+    R.equivalentes = true;
+    return true;
+  }
+  vector<bool3S> in(NI);
+  for (unsigned i=0; i<NI; i++)
+  {
+    if (S.getValor(SolverSat::variavel(entradas[i].T))) in[i] = bool3S::TRUE;
+    else if (S.getValor(SolverSat::variavel(entradas[i].F))) in[i] = bool3S::FALSE;
+    else in[i] = bool3S::UNDEF;
+  }
+  registrarContraexemplo(A, B, in, R);
+  return true;
+}
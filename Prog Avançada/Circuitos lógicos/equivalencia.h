@@ -0,0 +1,74 @@
+#ifndef _EQUIVALENCIA_H_
+#define _EQUIVALENCIA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// VERIFICACAO DE EQUIVALENCIA COMBINACIONAL
+/// Dois circuitos com o mesmo numero de entradas e de saidas sao equivalentes
+/// se tem as mesmas saidas para todas as 3^n combinacoes de entrada (UNDEF
+/// inclusive), ou seja, se tem a mesma tabela verdade. A verificacao nao
+/// percorre a tabela:
+///
+/// 1) Simulacao aleatoria: blocos de combinacoes de entrada sorteadas sao
+///    simulados nos dois circuitos (simulacao em bloco, 64 combinacoes por
+///    palavra). Uma saida diferente eh um contra-exemplo obtido sem custo.
+/// 2) Prova por SAT: monta-se o "miter" dos dois circuitos (as entradas sao
+///    compartilhadas e uma saida indica se alguma saida dos dois circuitos eh
+///    diferente) na forma normal conjuntiva e pergunta-se ao resolvedor SAT
+///    (sat.h) se essa saida pode ser 1. Se nao puder, os circuitos sao
+///    equivalentes; se puder, a atribuicao encontrada eh um contra-exemplo.
+///
+/// A logica de 3 estados eh codificada em "dual-rail", como nos BDDs (bdd.h):
+/// cada sinal tem duas variaveis booleanas, T (o sinal eh TRUE) e F (o sinal eh
+/// FALSE), e eh UNDEF quando as duas sao 0. Nas entradas, T e F nao podem ser 1
+/// ao mesmo tempo. As portas sao codificadas pelas regras de bool3S aplicadas a
+/// T e F (ver bdd.h), e portas iguais dos dois circuitos (mesma operacao sobre os
+/// mesmos literais) viram uma unica variavel (hash estrutural), de modo que as
+/// partes comuns aos dois circuitos nao custam nada ao resolvedor.
+///
+/// As componentes ciclicas (lacos de realimentacao) sao desenroladas: partindo de
+/// todas as portas UNDEF, cada rodada reavalia todas as portas da componente a
+/// partir da rodada anterior, ateh que duas rodadas sejam iguais ou ateh o numero
+/// de portas da componente (cada rodada define pelo menos uma porta a mais, ateh
+/// o ponto fixo), o que dah o mesmo resultado de Netlist::simular. O tamanho da
+/// formula cresce com o quadrado do tamanho dos lacos.
+/// ###########################################################################
+
+// O resultado da verificacao
+struct ResultadoEquivalencia {
+  // true se os circuitos sao equivalentes
+  bool equivalentes;
+  // Se nao forem: a combinacao de entrada que distingue os circuitos, a primeira
+  // saida diferente (de 0 a Nout-1) e o valor dessa saida em cada circuito
+  std::vector<bool3S> contraexemplo;
+  unsigned saida;
+  bool3S valorA, valorB;
+  // true se a decisao foi tomada pela simulacao aleatoria (sem usar o SAT)
+  bool porSimulacao;
+  // Estatisticas: combinacoes simuladas; tamanho da formula e conflitos do SAT
+  unsigned long long simuladas;
+  unsigned variaveis;
+  size_t clausulas;
+  unsigned long long conflitos;
+
+  ResultadoEquivalencia() {clear();}
+  void clear();
+  // Imprime o resultado: EQUIVALENTES, ou DIFERENTES seguido da combinacao de
+  // entrada e da saida diferente; com Estatisticas, tambem como foi decidido
+  std::ostream& imprimir(std::ostream& O, bool Estatisticas=false) const;
+};
+
+// Verifica se as netlists A e B (que devem estar montadas) sao equivalentes
+// Simula BlocosAleatorios blocos de 1024 combinacoes de entrada sorteadas antes
+// de recorrer ao SAT (0: vai direto ao SAT)
+// Retorna false se A e B tiverem numeros diferentes de entradas ou de saidas
+bool verificarEquivalencia(const Netlist& A, const Netlist& B, ResultadoEquivalencia& R,
+                           unsigned BlocosAleatorios=64);
+
+#endif // _EQUIVALENCIA_H_
@@ -0,0 +1,485 @@
+#include <algorithm>
+#include <iomanip>
+#include "falhas.h"
+#include "kernel3S.h"
+
+using namespace std;
+
+/// ***********************
+/// Falha
+/// ***********************
+
+std::ostream& FalhaStuckAt::imprimir(std::ostream& O, unsigned Nin) const
+{
+  if (ramo) O << 'P' << porta+1 << '.' << pino+1;
+  else if (sinal < Nin) O << 'E' << sinal+1;
+  else O << 'P' << sinal-Nin+1;
+  return O << '/' << (valor ? '1' : '0');
+}
+
+/// ***********************
+/// Lista de falhas e colapsamento
+/// ***********************
+
+SimuladorFalhas::SimuladorFalhas():
+  N(), falhas(), classe(), representantes(), tamanho(), estado(), deteccoes(), primeiro(),
+  vetores(0), observavel(), bom(), fval(), fdef(), marca(), rodada(0), eventos(), agendada(),
+  nivel_max(0), constF(), constT(), val_novo(), def_novo(), in_port()
+{
+}
+
+// Raiz da classe da falha I (com compressao de caminho)
+static unsigned raiz(vector<unsigned>& C, unsigned I)
+{
+  while (C[I] != I)
+  {
+    C[I] = C[C[I]];
+    I = C[I];
+  }
+  return I;
+}
+
+// Une as classes das falhas I e J; a raiz eh a de menor indice (os troncos, que
+// vem primeiro na lista, sao preferidos como representantes)
+static void unir(vector<unsigned>& C, unsigned I, unsigned J)
+{
+  I = raiz(C, I);
+  J = raiz(C, J);
+  if (I < J) C[J] = I;
+  else if (J < I) C[I] = J;
+}
+
+void SimuladorFalhas::criarFalhas(bool Colapsar)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais(), NP = N.getNumPorts();
+
+  // As falhas dos troncos: 2*s+valor
+  falhas.clear();
+  for (unsigned s=0; s<NS; s++)
+  {
+    for (unsigned v=0; v<2; v++) falhas.push_back({s, false, 0, 0, v==1});
+  }
+  // As falhas dos ramos: ini[p]+2*j+valor
+  vector<unsigned> ini(NP);
+  for (unsigned p=0; p<NP; p++)
+  {
+    ini[p] = falhas.size();
+    const unsigned* in = N.getFanin(p);
+    for (unsigned j=0; j<N.getNumFanin(p); j++)
+    {
+      for (unsigned v=0; v<2; v++) falhas.push_back({in[j], true, p, j, v==1});
+    }
+  }
+
+  classe.resize(falhas.size());
+  for (unsigned i=0; i<falhas.size(); i++) classe[i] = i;
+
+  if (Colapsar)
+  {
+    // Numero de usos de cada sinal (entradas de portas e saidas do circuito)
+    vector<unsigned> usos(NS, 0);
+    for (unsigned p=0; p<NP; p++)
+    {
+      for (unsigned j=0; j<N.getNumFanin(p); j++) usos[N.getFanin(p)[j]]++;
+    }
+    for (unsigned j=0; j<N.getNumOutputs(); j++) usos[N.getSaida(j)]++;
+
+    for (unsigned p=0; p<NP; p++)
+    {
+      const unsigned* in = N.getFanin(p);
+      const unsigned n = N.getNumFanin(p), saida = 2*(NI+p);
+      const tipoPorta T = N.getTipo(p);
+      for (unsigned j=0; j<n; j++)
+      {
+        const unsigned r = ini[p]+2*j;
+        // Ramo unico: equivalente ao tronco
+        if (usos[in[j]] == 1)
+        {
+          unir(classe, r, 2*in[j]);
+          unir(classe, r+1, 2*in[j]+1);
+        }
+        // Entrada com o valor controlador: equivalente a saida com o valor resultante
+        if (n == 1)
+        {
+          unsigned inv = (T==tipoPorta::NT || T==tipoPorta::NA ||
+                          T==tipoPorta::NO || T==tipoPorta::NX);
+          unir(classe, r, saida+inv);
+          unir(classe, r+1, saida+1-inv);
+        }
+        else switch (T)
+        {
+        case tipoPorta::AN: unir(classe, r, saida); break;
+        case tipoPorta::NA: unir(classe, r, saida+1); break;
+        case tipoPorta::OR: unir(classe, r+1, saida+1); break;
+        case tipoPorta::NO: unir(classe, r+1, saida); break;
+        default: break;
+        }
+      }
+    }
+  }
+
+  // Os sinais observaveis: os que alcancam alguma saida (busca a partir das saidas)
+  N.marcarObservaveis(observavel);
+
+  representantes.clear();
+  tamanho.assign(falhas.size(), 0);
+  for (unsigned i=0; i<falhas.size(); i++)
+  {
+    classe[i] = raiz(classe, i);
+    if (classe[i] == i) representantes.push_back(i);
+    tamanho[classe[i]]++;
+  }
+}
+
+void SimuladorFalhas::gerarFalhas(const Netlist& Net, bool Colapsar)
+{
+  N = Net;
+  criarFalhas(Colapsar);
+  reiniciar();
+}
+
+void SimuladorFalhas::reiniciar()
+{
+  estado.assign(falhas.size(), estadoFalha::NAO_DETECTADA);
+  deteccoes.assign(falhas.size(), 0);
+  primeiro.assign(falhas.size(), 0);
+  vetores = 0;
+}
+
+/// ***********************
+/// Consultas
+/// ***********************
+
+unsigned SimuladorFalhas::getNumClasses(estadoFalha E) const
+{
+  unsigned n = 0;
+  for (unsigned r : representantes) if (estado[r] == E) n++;
+  return n;
+}
+
+double SimuladorFalhas::getCobertura() const
+{
+  if (representantes.empty()) return 0.0;
+  return double(getNumClasses(estadoFalha::DETECTADA))/representantes.size();
+}
+
+double SimuladorFalhas::getCoberturaTotal() const
+{
+  if (falhas.empty()) return 0.0;
+  unsigned long long n = 0;
+  for (unsigned r : representantes) if (estado[r] == estadoFalha::DETECTADA) n += tamanho[r];
+  return double(n)/falhas.size();
+}
+
+double SimuladorFalhas::getCoberturaPotencial() const
+{
+  if (representantes.empty()) return 0.0;
+  return double(getNumClasses(estadoFalha::DETECTADA)+getNumClasses(estadoFalha::POTENCIAL))/
+         representantes.size();
+}
+
+std::ostream& SimuladorFalhas::imprimir(std::ostream& O, bool Listar) const
+{
+  O << "Falhas: " << falhas.size() << " (" << representantes.size() << " classes)\n"
+    << "Vetores: " << vetores << '\n'
+    << "Detectadas: " << getNumClasses(estadoFalha::DETECTADA) << '\n'
+    << "Potencialmente detectadas: " << getNumClasses(estadoFalha::POTENCIAL) << '\n'
+    << "Nao detectadas: " << getNumClasses(estadoFalha::NAO_DETECTADA) << '\n'
+    << fixed << setprecision(2)
+    << "Cobertura: " << 100.0*getCobertura() << "% (lista completa: "
+    << 100.0*getCoberturaTotal() << "%)\n"
+    << "Cobertura com as potenciais: " << 100.0*getCoberturaPotencial() << "%\n";
+  O.unsetf(ios::floatfield);
+  if (Listar)
+  {
+    for (unsigned r : representantes)
+    {
+      if (estado[r] == estadoFalha::DETECTADA) continue;
+      falhas[r].imprimir(O, N.getNumInputs());
+      O << (estado[r]==estadoFalha::POTENCIAL ? " potencial\n" : " nao detectada\n");
+    }
+  }
+  return O;
+}
+
+/// ***********************
+/// Simulacao
+/// ***********************
+
+void SimuladorFalhas::agendarFanout(unsigned S)
+{
+  const unsigned* f = N.getFanout(S);
+  for (unsigned k=0; k<N.getNumFanout(S); k++)
+  {
+    // As portas que nao alcancam nenhuma saida nao afetam a deteccao
+    if (!observavel[N.getNumInputs()+f[k]]) continue;
+    unsigned c = N.getComponente(f[k]);
+    if (agendada[c] == rodada) continue;
+    agendada[c] = rodada;
+    unsigned L = N.getNivel(f[k]);
+    eventos[L].push_back(c);
+    if (L > nivel_max) nivel_max = L;
+  }
+}
+
+const uint64_t* SimuladorFalhas::getVal(unsigned S) const
+{
+  return (marca[S]==rodada ? &fval[S*bom.W] : &bom.val[S*bom.W]);
+}
+
+const uint64_t* SimuladorFalhas::getDef(unsigned S) const
+{
+  return (marca[S]==rodada ? &fdef[S*bom.W] : &bom.def[S*bom.W]);
+}
+
+void SimuladorFalhas::avaliarPorta(unsigned P, const FalhaStuckAt& F, uint64_t* Val, uint64_t* Def)
+{
+  const unsigned W = bom.W;
+  // Falha na saida da porta: o valor eh constante
+  if (!F.ramo && F.sinal == N.getNumInputs()+P)
+  {
+    const uint64_t* c = (F.valor ? constT.data() : constF.data());
+    for (unsigned w=0; w<W; w++) {Val[w] = c[w]; Def[w] = constT[w];}
+    return;
+  }
+  const unsigned n = N.getNumFanin(P);
+  const unsigned* in = N.getFanin(P);
+  in_port.resize(n);
+  for (unsigned j=0; j<n; j++)
+  {
+    if (F.ramo && F.porta == P && F.pino == j)
+    {
+      in_port[j].val = (F.valor ? constT.data() : constF.data());
+      in_port[j].def = constT.data();
+    }
+    else
+    {
+      in_port[j].val = getVal(in[j]);
+      in_port[j].def = getDef(in[j]);
+    }
+  }
+  const Kernel3S& K = kernel3S();
+  switch (N.getTipo(P))
+  {
+  case tipoPorta::NT: K.portaAND(in_port.data(), n, true, Val, Def, W); break;
+  case tipoPorta::AN: K.portaAND(in_port.data(), n, false, Val, Def, W); break;
+  case tipoPorta::NA: K.portaAND(in_port.data(), n, true, Val, Def, W); break;
+  case tipoPorta::OR: K.portaOR(in_port.data(), n, false, Val, Def, W); break;
+  case tipoPorta::NO: K.portaOR(in_port.data(), n, true, Val, Def, W); break;
+  case tipoPorta::XO: K.portaXOR(in_port.data(), n, false, Val, Def, W); break;
+  case tipoPorta::NX: K.portaXOR(in_port.data(), n, true, Val, Def, W); break;
+  }
+}
+
+// true se os planos (Va,Da) e (Vb,Db) representam valores diferentes em algum vetor
+static inline bool diferentes(const uint64_t* Va, const uint64_t* Da,
+                              const uint64_t* Vb, const uint64_t* Db, unsigned W)
+{
+  uint64_t dif = 0;
+  for (unsigned w=0; w<W; w++) dif |= ((Va[w]&Da[w]) ^ (Vb[w]&Db[w])) | (Da[w] ^ Db[w]);
+  return dif != 0;
+}
+
+void SimuladorFalhas::propagarFalha(const FalhaStuckAt& F, unsigned W, const uint64_t* Mascara,
+                                    std::vector<uint64_t>& Det, std::vector<uint64_t>& Pot)
+{
+  const unsigned NI = N.getNumInputs();
+  Det.assign(W, 0);
+  Pot.assign(W, 0);
+
+  // A falha soh eh ativada nos vetores em que o ponto nao tem o valor da falha
+  const uint64_t* gv = &bom.val[F.sinal*W];
+  const uint64_t* gd = &bom.def[F.sinal*W];
+  uint64_t ativa = 0;
+  for (unsigned w=0; w<W; w++)
+  {
+    ativa |= ~(gd[w] & (F.valor ? gv[w] : ~gv[w])) & Mascara[w];
+  }
+  if (ativa == 0) return;
+
+  if (++rodada == 0)
+  {
+    fill(marca.begin(), marca.end(), 0);
+    fill(agendada.begin(), agendada.end(), 0);
+    rodada = 1;
+  }
+  nivel_max = 0;
+  unsigned nivel_min;
+  if (!F.ramo && F.sinal < NI)
+  {
+    // Falha no tronco de uma entrada do circuito
+    unsigned s = F.sinal;
+    marca[s] = rodada;
+    for (unsigned w=0; w<W; w++)
+    {
+      fval[s*W+w] = (F.valor ? constT[w] : 0);
+      fdef[s*W+w] = constT[w];
+    }
+    agendarFanout(s);
+    nivel_min = 0;
+  }
+  else
+  {
+    // Falha na saida ou numa entrada de uma porta: a componente da porta eh reavaliada
+    unsigned p = (F.ramo ? F.porta : F.sinal-NI);
+    unsigned c = N.getComponente(p);
+    agendada[c] = rodada;
+    nivel_min = nivel_max = N.getNivel(p);
+    eventos[nivel_min].push_back(c);
+  }
+
+  for (unsigned L=nivel_min; L<=nivel_max; L++)
+  {
+    for (unsigned i=0; i<eventos[L].size(); i++)
+    {
+      unsigned c = eventos[L][i];
+      const unsigned* portas = N.getPortasComponente(c);
+      const unsigned tam = N.getTamanhoComponente(c);
+      if (!N.getCiclica(c))
+      {
+        unsigned s = NI+portas[0];
+        avaliarPorta(portas[0], F, val_novo.data(), def_novo.data());
+        if (diferentes(val_novo.data(), def_novo.data(), &bom.val[s*W], &bom.def[s*W], W))
+        {
+          marca[s] = rodada;
+          copy(val_novo.begin(), val_novo.begin()+W, fval.begin()+s*W);
+          copy(def_novo.begin(), def_novo.begin()+W, fdef.begin()+s*W);
+          agendarFanout(s);
+        }
+        continue;
+      }
+      // Componente ciclica: simulada de novo a partir de UNDEF, como em
+      // Netlist::simularBlocoComponente, com os valores do circuito com a falha
+      for (unsigned k=0; k<tam; k++)
+      {
+        unsigned s = NI+portas[k];
+        marca[s] = rodada;
+        for (unsigned w=0; w<W; w++) fval[s*W+w] = fdef[s*W+w] = 0;
+      }
+      bool mudou;
+      do
+      {
+        mudou = false;
+        for (unsigned k=0; k<tam; k++)
+        {
+          unsigned s = NI+portas[k];
+          avaliarPorta(portas[k], F, val_novo.data(), def_novo.data());
+          for (unsigned w=0; w<W; w++)
+          {
+            uint64_t novos_def = def_novo[w] & ~fdef[s*W+w];
+            if (novos_def != 0)
+            {
+              fval[s*W+w] |= val_novo[w] & novos_def;
+              fdef[s*W+w] |= novos_def;
+              mudou = true;
+            }
+          }
+        }
+      }
+      while (mudou);
+      for (unsigned k=0; k<tam; k++)
+      {
+        unsigned s = NI+portas[k];
+        if (diferentes(&fval[s*W], &fdef[s*W], &bom.val[s*W], &bom.def[s*W], W)) agendarFanout(s);
+      }
+    }
+    eventos[L].clear();
+  }
+
+  // Deteccao nas saidas do circuito
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    unsigned o = N.getSaida(j);
+    if (marca[o] != rodada) continue;
+    for (unsigned w=0; w<W; w++)
+    {
+      uint64_t bd = bom.def[o*W+w], bv = bom.val[o*W+w] & bd;
+      uint64_t fd = fdef[o*W+w], fv = fval[o*W+w] & fd;
+      Det[w] |= bd & fd & (bv ^ fv) & Mascara[w];
+      Pot[w] |= bd & ~fd & Mascara[w];
+    }
+  }
+}
+
+bool SimuladorFalhas::simular(const std::vector< std::vector<bool3S> >& Vetores, bool Descartar)
+{
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais();
+  for (const vector<bool3S>& V : Vetores) if (V.size() != NI) return false;
+  if (Vetores.empty()) return true;
+
+  // Blocos de ateh PALAVRAS_BLOCO3S palavras (menores se houver poucos vetores)
+  const unsigned W = unsigned(min<size_t>(PALAVRAS_BLOCO3S, (Vetores.size()+63)/64));
+  N.prepararEstado(bom, W);
+  fval.assign(NS*W, 0);
+  fdef.assign(NS*W, 0);
+  marca.assign(NS, 0);
+  agendada.assign(N.getNumComponentes(), 0);
+  eventos.assign(max(N.getNumNiveis(), 1u), vector<unsigned>());
+  rodada = 0;
+  constF.assign(W, 0);
+  constT.assign(W, ~uint64_t(0));
+  val_novo.resize(W);
+  def_novo.resize(W);
+
+  vector<uint64_t> mascara(W), det, pot;
+  for (size_t base=0; base<Vetores.size(); base+=64*W)
+  {
+    const size_t n = min<size_t>(64*W, Vetores.size()-base);
+
+    // Os planos das entradas e a mascara dos vetores validos do bloco
+    fill(bom.val.begin(), bom.val.begin()+NI*W, 0);
+    fill(bom.def.begin(), bom.def.begin()+NI*W, 0);
+    fill(mascara.begin(), mascara.end(), 0);
+    for (size_t k=0; k<n; k++)
+    {
+      const uint64_t bit = uint64_t(1) << (k%64);
+      mascara[k/64] |= bit;
+      for (unsigned i=0; i<NI; i++)
+      {
+        bool3S b = Vetores[base+k][i];
+        if (b == bool3S::UNDEF) continue;
+        bom.def[i*W+k/64] |= bit;
+        if (b == bool3S::TRUE) bom.val[i*W+k/64] |= bit;
+      }
+    }
+    N.simularBloco(bom);
+
+    for (unsigned r : representantes)
+    {
+      if (Descartar && estado[r] == estadoFalha::DETECTADA) continue;
+      // Uma falha cujo ponto nao alcanca nenhuma saida nao eh detectavel
+      const FalhaStuckAt& F = falhas[r];
+      if (!observavel[F.ramo ? NI+F.porta : F.sinal]) continue;
+      propagarFalha(F, W, mascara.data(), det, pot);
+
+      unsigned long long nDet = 0;
+      unsigned long long prim = 0;
+      bool achou = false;
+      for (unsigned w=0; w<W; w++)
+      {
+        if (det[w] != 0 && !achou)
+        {
+          prim = vetores+base+64*w+__builtin_ctzll(det[w]);
+          achou = true;
+        }
+        nDet += contarBits(det[w]);
+      }
+      if (achou)
+      {
+        if (estado[r] != estadoFalha::DETECTADA)
+        {
+          estado[r] = estadoFalha::DETECTADA;
+          primeiro[r] = prim;
+        }
+        deteccoes[r] = (Descartar ? 1 : deteccoes[r]+nDet);
+        continue;
+      }
+      if (estado[r] == estadoFalha::NAO_DETECTADA)
+      {
+        for (unsigned w=0; w<W; w++) if (pot[w] != 0) estado[r] = estadoFalha::POTENCIAL;
+      }
+    }
+  }
+  vetores += Vetores.size();
+  return true;
+}
@@ -0,0 +1,172 @@
+#ifndef _FALHAS_H_
+#define _FALHAS_H_
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// SIMULACAO DE FALHAS STUCK-AT
+/// Uma falha stuck-at fixa um ponto do circuito em FALSE (stuck-at-0) ou em TRUE
+/// (stuck-at-1). Os pontos sao a saida de cada porta e cada entrada do circuito
+/// (o "tronco" do sinal, que afeta todas as portas alimentadas por ele e as saidas
+/// do circuito ligadas a ele) e cada entrada de cada porta (um "ramo", que afeta
+/// apenas aquela porta).
+///
+/// Um vetor de teste (combinacao de entrada) detecta uma falha se alguma saida do
+/// circuito tiver, no circuito com a falha, um valor definido diferente do valor
+/// (definido) do circuito correto. Se o circuito correto der um valor definido e o
+/// circuito com falha der UNDEF, a falha eh apenas potencialmente detectada (o
+/// testador veria um valor qualquer). A simulacao segue a mesma semantica de
+/// Netlist::simularBloco, inclusive nos lacos de realimentacao.
+///
+/// Colapsamento: falhas equivalentes (detectadas exatamente pelos mesmos vetores)
+/// formam uma classe, e apenas uma falha de cada classe eh simulada:
+/// - o ramo de um sinal que alimenta uma unica porta (e nenhuma saida) eh
+///   equivalente ao tronco;
+/// - uma entrada com o valor controlador da porta eh equivalente aa saida com o
+///   valor resultante: AN entrada-0 = saida-0, NA entrada-0 = saida-1,
+///   OR entrada-1 = saida-1, NO entrada-1 = saida-0; nas portas de uma entrada
+///   (buffer ou inversor, NT inclusive), as duas falhas da entrada sao
+///   equivalentes as da saida. Essas equivalencias valem tambem com UNDEF
+///   (FALSE AND UNDEF = FALSE) e dentro de lacos.
+///
+/// Simulacao (PPSFP, "parallel pattern single fault propagation"): os vetores
+/// sao simulados em blocos de ateh 1024 no circuito correto (simulacao em bloco);
+/// em seguida, cada falha ainda nao detectada eh propagada sozinha, sobre o bloco
+/// inteiro, apenas pelas portas do seu cone de fanout cujo valor muda (simulacao
+/// por eventos, em ordem de nivel). Os valores alterados pela falha ficam em uma
+/// copia esparsa do estado, e o circuito correto nao eh simulado de novo. Uma
+/// falha que nao eh ativada pelo bloco (o ponto jah tem o valor da falha em todos
+/// os vetores) nao eh propagada, e a propagacao nao passa pelas portas que nao
+/// alcancam nenhuma saida (as falhas dessas portas nunca sao simuladas: nao sao
+/// detectaveis). Com o descarte de falhas, uma falha detectada nao eh mais
+/// simulada nos blocos seguintes.
+/// ###########################################################################
+
+// Uma falha stuck-at
+struct FalhaStuckAt {
+  // O sinal da falha (entrada do circuito ou porta, como em Netlist)
+  unsigned sinal;
+  // true se a falha eh no ramo que vai do sinal aa entrada Pino da porta Porta;
+  // false se eh no tronco do sinal
+  bool ramo;
+  unsigned porta, pino;
+  // O valor fixado: false (stuck-at-0) ou true (stuck-at-1)
+  bool valor;
+
+  // Imprime a falha com as ids de Circuito: o ponto (E3: entrada 3 do circuito;
+  // P5: saida da porta 5; P5.2: segunda entrada da porta 5) e o valor (/0 ou /1)
+  std::ostream& imprimir(std::ostream& O, unsigned Nin) const;
+};
+
+// O estado de uma falha depois da simulacao
+enum class estadoFalha {NAO_DETECTADA, POTENCIAL, DETECTADA};
+
+class SimuladorFalhas {
+private:
+  // A netlist do circuito (copia)
+  Netlist N;
+  // Todas as falhas (2 por sinal e 2 por entrada de porta)
+  std::vector<FalhaStuckAt> falhas;
+  // A falha representante da classe de cada falha
+  std::vector<unsigned> classe;
+  // As falhas representantes (as que sao simuladas), em ordem crescente
+  std::vector<unsigned> representantes;
+  // Numero de falhas em cada classe (indexado pela representante)
+  std::vector<unsigned> tamanho;
+  // Para cada representante: estado, numero de vetores que a detectam e o
+  // primeiro vetor que a detecta
+  std::vector<estadoFalha> estado;
+  std::vector<unsigned long long> deteccoes, primeiro;
+  // Numero de vetores simulados
+  unsigned long long vetores;
+  // observavel[s] != 0 se existe um caminho do sinal s ateh uma saida do circuito
+  std::vector<uint32_t> observavel;
+
+  // Estado da simulacao: o circuito correto e a copia esparsa com a falha
+  // (marca[s]==rodada se o sinal s tem valor proprio em fval/fdef)
+  EstadoNetlist bom;
+  std::vector<uint64_t> fval, fdef;
+  std::vector<uint32_t> marca;
+  uint32_t rodada;
+  // As componentes agendadas, por nivel, e a marca de agendamento de cada uma
+  std::vector< std::vector<unsigned> > eventos;
+  std::vector<uint32_t> agendada;
+  // O maior nivel com componentes agendadas
+  unsigned nivel_max;
+  // Planos constantes (FALSE e TRUE) e auxiliares
+  std::vector<uint64_t> constF, constT, val_novo, def_novo;
+  std::vector<bloco3S> in_port;
+
+  // Cria a lista de falhas e as classes (Colapsar==false: cada falha na sua classe)
+  void criarFalhas(bool Colapsar);
+  // Agenda as componentes alimentadas pelo sinal S
+  void agendarFanout(unsigned S);
+  // Os planos do sinal S no circuito com a falha
+  const uint64_t* getVal(unsigned S) const;
+  const uint64_t* getDef(unsigned S) const;
+  // Avalia a porta P no circuito com a falha F, guardando o resultado em Val e Def
+  void avaliarPorta(unsigned P, const FalhaStuckAt& F, uint64_t* Val, uint64_t* Def);
+  // Propaga a falha F sobre o bloco atual (W palavras); em Det e Pot ficam as
+  // mascaras dos vetores que detectam e que potencialmente detectam a falha
+  void propagarFalha(const FalhaStuckAt& F, unsigned W, const uint64_t* Mascara,
+                     std::vector<uint64_t>& Det, std::vector<uint64_t>& Pot);
+
+public:
+  SimuladorFalhas();
+
+  // Cria a lista de falhas da netlist N (que deve estar montada), com ou sem
+  // colapsamento, e zera o estado de todas as falhas
+  void gerarFalhas(const Netlist& Net, bool Colapsar=true);
+  // Zera o estado de todas as falhas (nenhuma detectada, nenhum vetor simulado)
+  void reiniciar();
+
+  // A netlist usada na simulacao
+  const Netlist& getNetlist() const {return N;}
+  // Os sinais que alcancam alguma saida (Netlist::marcarObservaveis)
+  const std::vector<uint32_t>& getObservaveis() const {return observavel;}
+
+  // Numero de falhas (sem colapsamento) e de classes (falhas simuladas)
+  unsigned getNumFalhas() const {return falhas.size();}
+  unsigned getNumClasses() const {return representantes.size();}
+  const FalhaStuckAt& getFalha(unsigned I) const {return falhas[I];}
+  // A representante da classe da falha I
+  unsigned getClasse(unsigned I) const {return classe[I];}
+  // A K-esima representante (de 0 a getNumClasses()-1)
+  unsigned getRepresentante(unsigned K) const {return representantes[K];}
+
+  // Estado da classe da falha I
+  estadoFalha getEstado(unsigned I) const {return estado[classe[I]];}
+  // Numero de vetores que detectam a classe da falha I (com descarte, 0 ou 1)
+  unsigned long long getNumDeteccoes(unsigned I) const {return deteccoes[classe[I]];}
+  // O primeiro vetor (na ordem em que foram simulados) que detecta a classe da falha I
+  unsigned long long getPrimeiroVetor(unsigned I) const {return primeiro[classe[I]];}
+
+  unsigned long long getNumVetores() const {return vetores;}
+  // Numero de classes em cada estado
+  unsigned getNumClasses(estadoFalha E) const;
+  // Cobertura de falhas (de 0 a 1): fracao das classes detectadas
+  double getCobertura() const;
+  // Cobertura sobre a lista completa (cada classe conta com o numero de falhas dela)
+  double getCoberturaTotal() const;
+  // Cobertura potencial (de 0 a 1): fracao das classes detectadas ou potencialmente
+  // detectadas (o testador pode ou nao ver a diferenca nas potenciais)
+  double getCoberturaPotencial() const;
+
+  // Simula os vetores de teste Vetores (cada um com um valor por entrada do
+  // circuito), continuando a partir do estado atual das falhas: os vetores sao
+  // numerados a partir de getNumVetores()
+  // Com Descartar, uma falha detectada nao eh mais simulada; sem descarte, todas as
+  // falhas sao simuladas com todos os vetores, e getNumDeteccoes conta os vetores
+  // Retorna false se algum vetor tiver o numero errado de valores
+  bool simular(const std::vector< std::vector<bool3S> >& Vetores, bool Descartar=true);
+
+  // Imprime o resumo (numeros de falhas e de classes, detectadas, potenciais,
+  // cobertura); com Listar, tambem a lista das classes nao detectadas
+  std::ostream& imprimir(std::ostream& O, bool Listar=false) const;
+};
+
+#endif // _FALHAS_H_
@@ -0,0 +1,81 @@
+#include "gray3S.h"
+
+EnumeradorGray3S::EnumeradorGray3S(unsigned NI)
+{
+  reiniciar(NI);
+}
+
+void EnumeradorGray3S::reiniciar(unsigned NI)
+{
+  entradas.assign(NI, bool3S::UNDEF);
+  sentido.assign(NI, +1);
+  peso.assign(NI, 1);
+  for (int j=int(NI)-2; j>=0; j--) peso[j] = 3*peso[j+1];
+  total = (NI>0 ? 3*peso[0] : 1);
+  passo = 0;
+  linha = 0;
+  alterada = -1;
+}
+
+unsigned EnumeradorGray3S::getNumInputs() const
+{
+  return entradas.size();
+}
+
+unsigned long long EnumeradorGray3S::getNumCombinacoes() const
+{
+  return total;
+}
+
+unsigned long long EnumeradorGray3S::getPasso() const
+{
+  return passo;
+}
+
+const std::vector<bool3S>& EnumeradorGray3S::getEntradas() const
+{
+  return entradas;
+}
+
+int EnumeradorGray3S::getEntradaAlterada() const
+{
+  return alterada;
+}
+
+unsigned long long EnumeradorGray3S::getLinha() const
+{
+  return linha;
+}
+
+// No codigo de Gray ternario refletido, no passo t (contando a partir de 1) muda a
+// entrada cuja posicao, contada a partir da ultima, eh o numero de zeros no final
+// da representacao de t na base 3. Essa entrada anda um valor no seu sentido atual;
+// ao chegar a um extremo (UNDEF ou TRUE), o sentido se inverte.
+bool EnumeradorGray3S::proximo()
+{
+  if (passo+1 >= total) return false;
+  passo++;
+
+  unsigned long long t = passo;
+  int j = entradas.size()-1;
+  while (t%3 == 0)
+  {
+    t /= 3;
+    j--;
+  }
+
+  if (sentido[j] > 0)
+  {
+    ++entradas[j];
+    linha += peso[j];
+    if (entradas[j] == bool3S::TRUE) sentido[j] = -1;
+  }
+  else
+  {
+    --entradas[j];
+    linha -= peso[j];
+    if (entradas[j] == bool3S::UNDEF) sentido[j] = +1;
+  }
+  alterada = j;
+  return true;
+}
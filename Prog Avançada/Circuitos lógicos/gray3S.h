@@ -0,0 +1,61 @@
+#ifndef _GRAY3S_H_
+#define _GRAY3S_H_
+
+#include <vector>
+#include "bool3S.h"
+
+// Enumerador de todas as 3^NI combinacoes de NI entradas bool3S em codigo de Gray
+// ternario refletido: de uma combinacao para a seguinte, exatamente uma entrada muda
+// de valor, e sempre para um valor vizinho (UNDEF<->FALSE ou FALSE<->TRUE).
+// Cada entrada percorre os valores UNDEF, FALSE, TRUE e depois volta em ordem
+// inversa (TRUE, FALSE, UNDEF), como num odometro "refletido".
+// A primeira combinacao tem todas as entradas UNDEF.
+//
+// Uso tipico:
+//   EnumeradorGray3S G(NI);
+//   do { ... usa G.getEntradas(), G.getEntradaAlterada(), G.getLinha() ... }
+//   while (G.proximo());
+class EnumeradorGray3S {
+private:
+  // A combinacao atual
+  std::vector<bool3S> entradas;
+  // O sentido em que cada entrada estah variando (+1 ou -1)
+  std::vector<int> sentido;
+  // O peso de cada entrada na numeracao das linhas da tabela verdade: 3^(NI-1-j)
+  std::vector<unsigned long long> peso;
+  // Numero de passos jah dados e numero total de combinacoes
+  unsigned long long passo, total;
+  // A linha da tabela verdade (ordem usual, em que a ultima entrada varia mais
+  // rapido) que corresponde aa combinacao atual
+  unsigned long long linha;
+  // O indice da entrada que mudou no ultimo passo (-1 antes do primeiro passo)
+  int alterada;
+
+public:
+  // Cria o enumerador e posiciona na primeira combinacao (todas as entradas UNDEF)
+  // O numero de combinacoes (3^NI) deve caber em um unsigned long long
+  explicit EnumeradorGray3S(unsigned NI=0);
+
+  // Volta para a primeira combinacao, com NI entradas
+  void reiniciar(unsigned NI);
+
+  // Numero de entradas e de combinacoes
+  unsigned getNumInputs() const;
+  unsigned long long getNumCombinacoes() const;
+  // Numero de passos dados desde a primeira combinacao (de 0 a 3^NI-1)
+  unsigned long long getPasso() const;
+
+  // A combinacao atual
+  const std::vector<bool3S>& getEntradas() const;
+  // O indice (de 0 a NI-1) da entrada que mudou no ultimo passo,
+  // ou -1 se estiver na primeira combinacao
+  int getEntradaAlterada() const;
+  // A linha da tabela verdade, na ordem usual, que corresponde aa combinacao atual
+  unsigned long long getLinha() const;
+
+  // Avanca para a proxima combinacao, alterando uma unica entrada
+  // Retorna false (e nao altera nada) se jah estiver na ultima combinacao
+  bool proximo();
+};
+
+#endif // _GRAY3S_H_
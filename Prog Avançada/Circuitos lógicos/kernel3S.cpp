@@ -0,0 +1,288 @@
+#include <atomic>
+#include <utility>
+#include "kernel3S.h"
+
+// As versoes vetorizadas dependem de extensoes do GCC/Clang (atributo target e
+// __builtin_cpu_supports) e soh existem em processadores x86
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define KERNEL3S_X86
+#include <immintrin.h>
+#endif
+
+// Em todos os kernels, o resultado eh calculado em dois planos auxiliares:
+// t (bit 1 se o valor eh TRUE) e f (bit 1 se o valor eh FALSE)
+// AND 3S: t = AND dos t das entradas; f = OR dos f das entradas
+// OR 3S:  t = OR dos t das entradas;  f = AND dos f das entradas
+// Negar o resultado equivale a trocar t e f. No final, val <- t e def <- t|f
+// XOR 3S eh calculado diretamente nos planos val (XOR) e def (AND)
+
+/// ***********************
+/// Versao escalar (uma palavra de 64 bits de cada vez)
+/// ***********************
+
+// Avaliam a palavra W do bloco
+// Tambem sao usadas pelas versoes vetorizadas para as palavras finais do bloco
+
+static inline void andPalavra(const bloco3S* in, unsigned NIn, bool Inverte,
+                              uint64_t* val, uint64_t* def, unsigned w)
+{
+  uint64_t t = in[0].val[w];
+  uint64_t f = in[0].def[w] & ~t;
+  for (unsigned i=1; i<NIn; i++)
+  {
+    t &= in[i].val[w];
+    f |= in[i].def[w] & ~in[i].val[w];
+  }
+  if (Inverte) std::swap(t,f);
+  val[w] = t;
+  def[w] = t|f;
+}
+
+static inline void orPalavra(const bloco3S* in, unsigned NIn, bool Inverte,
+                             uint64_t* val, uint64_t* def, unsigned w)
+{
+  uint64_t t = in[0].val[w];
+  uint64_t f = in[0].def[w] & ~t;
+  for (unsigned i=1; i<NIn; i++)
+  {
+    t |= in[i].val[w];
+    f &= in[i].def[w] & ~in[i].val[w];
+  }
+  if (Inverte) std::swap(t,f);
+  val[w] = t;
+  def[w] = t|f;
+}
+
+static inline void xorPalavra(const bloco3S* in, unsigned NIn, bool Inverte,
+                              uint64_t* val, uint64_t* def, unsigned w)
+{
+  uint64_t v = in[0].val[w];
+  uint64_t d = in[0].def[w];
+  for (unsigned i=1; i<NIn; i++)
+  {
+    v ^= in[i].val[w];
+    d &= in[i].def[w];
+  }
+  val[w] = (Inverte ? ~v : v) & d;
+  def[w] = d;
+}
+
+static void andEscalar(const bloco3S* in, unsigned NIn, bool Inverte,
+                       uint64_t* val, uint64_t* def, unsigned W)
+{
+  for (unsigned w=0; w<W; w++) andPalavra(in, NIn, Inverte, val, def, w);
+}
+
+static void orEscalar(const bloco3S* in, unsigned NIn, bool Inverte,
+                      uint64_t* val, uint64_t* def, unsigned W)
+{
+  for (unsigned w=0; w<W; w++) orPalavra(in, NIn, Inverte, val, def, w);
+}
+
+static void xorEscalar(const bloco3S* in, unsigned NIn, bool Inverte,
+                       uint64_t* val, uint64_t* def, unsigned W)
+{
+  for (unsigned w=0; w<W; w++) xorPalavra(in, NIn, Inverte, val, def, w);
+}
+
+static const Kernel3S kernelEscalar = {"escalar", 1, andEscalar, orEscalar, xorEscalar};
+
+#ifdef KERNEL3S_X86
+
+/// ***********************
+/// Versao AVX2 (4 palavras de 64 bits de cada vez)
+/// ***********************
+
+#define LOAD256(p) _mm256_loadu_si256((const __m256i*)(p))
+#define STORE256(p,x) _mm256_storeu_si256((__m256i*)(p),(x))
+
+__attribute__((target("avx2")))
+static void andAVX2(const bloco3S* in, unsigned NIn, bool Inverte,
+                    uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+4<=W; w+=4)
+  {
+    __m256i t = LOAD256(in[0].val+w);
+    __m256i f = _mm256_andnot_si256(t, LOAD256(in[0].def+w));
+    for (unsigned i=1; i<NIn; i++)
+    {
+      __m256i v = LOAD256(in[i].val+w);
+      t = _mm256_and_si256(t, v);
+      f = _mm256_or_si256(f, _mm256_andnot_si256(v, LOAD256(in[i].def+w)));
+    }
+    if (Inverte) std::swap(t,f);
+    STORE256(val+w, t);
+    STORE256(def+w, _mm256_or_si256(t,f));
+  }
+  for (; w<W; w++) andPalavra(in, NIn, Inverte, val, def, w);
+}
+
+__attribute__((target("avx2")))
+static void orAVX2(const bloco3S* in, unsigned NIn, bool Inverte,
+                   uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+4<=W; w+=4)
+  {
+    __m256i t = LOAD256(in[0].val+w);
+    __m256i f = _mm256_andnot_si256(t, LOAD256(in[0].def+w));
+    for (unsigned i=1; i<NIn; i++)
+    {
+      __m256i v = LOAD256(in[i].val+w);
+      t = _mm256_or_si256(t, v);
+      f = _mm256_and_si256(f, _mm256_andnot_si256(v, LOAD256(in[i].def+w)));
+    }
+    if (Inverte) std::swap(t,f);
+    STORE256(val+w, t);
+    STORE256(def+w, _mm256_or_si256(t,f));
+  }
+  for (; w<W; w++) orPalavra(in, NIn, Inverte, val, def, w);
+}
+
+__attribute__((target("avx2")))
+static void xorAVX2(const bloco3S* in, unsigned NIn, bool Inverte,
+                    uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+4<=W; w+=4)
+  {
+    __m256i v = LOAD256(in[0].val+w);
+    __m256i d = LOAD256(in[0].def+w);
+    for (unsigned i=1; i<NIn; i++)
+    {
+      v = _mm256_xor_si256(v, LOAD256(in[i].val+w));
+      d = _mm256_and_si256(d, LOAD256(in[i].def+w));
+    }
+    STORE256(val+w, Inverte ? _mm256_andnot_si256(v,d) : _mm256_and_si256(v,d));
+    STORE256(def+w, d);
+  }
+  for (; w<W; w++) xorPalavra(in, NIn, Inverte, val, def, w);
+}
+
+static const Kernel3S kernelAVX2 = {"avx2", 4, andAVX2, orAVX2, xorAVX2};
+
+/// ***********************
+/// Versao AVX-512 (8 palavras de 64 bits de cada vez)
+/// ***********************
+
+#define LOAD512(p) _mm512_loadu_si512((const void*)(p))
+#define STORE512(p,x) _mm512_storeu_si512((void*)(p),(x))
+// ~a & b: o mesmo que _mm512_andnot_si512, cuja implementacao no GCC gera avisos
+// falsos de variavel nao inicializada (tabela 0x0C: a=0 e b=1)
+#define ANDNOT512(a,b) _mm512_ternarylogic_epi64((a),(b),(b),0x0C)
+
+__attribute__((target("avx512f")))
+static void andAVX512(const bloco3S* in, unsigned NIn, bool Inverte,
+                      uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+8<=W; w+=8)
+  {
+    __m512i t = LOAD512(in[0].val+w);
+    __m512i f = ANDNOT512(t, LOAD512(in[0].def+w));
+    for (unsigned i=1; i<NIn; i++)
+    {
+      __m512i v = LOAD512(in[i].val+w);
+      t = _mm512_and_si512(t, v);
+      f = _mm512_or_si512(f, ANDNOT512(v, LOAD512(in[i].def+w)));
+    }
+    if (Inverte) std::swap(t,f);
+    STORE512(val+w, t);
+    STORE512(def+w, _mm512_or_si512(t,f));
+  }
+  for (; w<W; w++) andPalavra(in, NIn, Inverte, val, def, w);
+}
+
+__attribute__((target("avx512f")))
+static void orAVX512(const bloco3S* in, unsigned NIn, bool Inverte,
+                     uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+8<=W; w+=8)
+  {
+    __m512i t = LOAD512(in[0].val+w);
+    __m512i f = ANDNOT512(t, LOAD512(in[0].def+w));
+    for (unsigned i=1; i<NIn; i++)
+    {
+      __m512i v = LOAD512(in[i].val+w);
+      t = _mm512_or_si512(t, v);
+      f = _mm512_and_si512(f, ANDNOT512(v, LOAD512(in[i].def+w)));
+    }
+    if (Inverte) std::swap(t,f);
+    STORE512(val+w, t);
+    STORE512(def+w, _mm512_or_si512(t,f));
+  }
+  for (; w<W; w++) orPalavra(in, NIn, Inverte, val, def, w);
+}
+
+__attribute__((target("avx512f")))
+static void xorAVX512(const bloco3S* in, unsigned NIn, bool Inverte,
+                      uint64_t* val, uint64_t* def, unsigned W)
+{
+  unsigned w=0;
+  for (; w+8<=W; w+=8)
+  {
+    __m512i v = LOAD512(in[0].val+w);
+    __m512i d = LOAD512(in[0].def+w);
+    for (unsigned i=1; i<NIn; i++)
+    {
+      v = _mm512_xor_si512(v, LOAD512(in[i].val+w));
+      d = _mm512_and_si512(d, LOAD512(in[i].def+w));
+    }
+    STORE512(val+w, Inverte ? ANDNOT512(v,d) : _mm512_and_si512(v,d));
+    STORE512(def+w, d);
+  }
+  for (; w<W; w++) xorPalavra(in, NIn, Inverte, val, def, w);
+}
+
+static const Kernel3S kernelAVX512 = {"avx512", 8, andAVX512, orAVX512, xorAVX512};
+
+#endif // KERNEL3S_X86
+
+/// ***********************
+/// Escolha do kernel em tempo de execucao
+/// ***********************
+
+// Retorna o kernel de nome Nome, ou nullptr se nao existir ou nao for suportado pela CPU
+static const Kernel3S* buscarKernel3S(const std::string& Nome)
+{
+  if (Nome=="escalar") return &kernelEscalar;
+#ifdef KERNEL3S_X86
+  __builtin_cpu_init();
+  if (Nome=="avx2" && __builtin_cpu_supports("avx2")) return &kernelAVX2;
+  if (Nome=="avx512" && __builtin_cpu_supports("avx512f")) return &kernelAVX512;
+#endif
+  return nullptr;
+}
+
+// Retorna o kernel mais largo suportado pela CPU
+static const Kernel3S* melhorKernel3S()
+{
+  const Kernel3S* K;
+  if ((K = buscarKernel3S("avx512")) != nullptr) return K;
+  if ((K = buscarKernel3S("avx2")) != nullptr) return K;
+  return &kernelEscalar;
+}
+
+// O kernel em uso (atomico, pois pode ser consultado por varias threads)
+static std::atomic<const Kernel3S*> kernelAtual(nullptr);
+
+const Kernel3S& kernel3S()
+{
+  const Kernel3S* K = kernelAtual.load();
+  if (K == nullptr)
+  {
+    K = melhorKernel3S();
+    kernelAtual.store(K);
+  }
+  return *K;
+}
+
+bool selecionarKernel3S(const std::string& Nome)
+{
+  const Kernel3S* K = buscarKernel3S(Nome);
+  if (K == nullptr) return false;
+  kernelAtual = K;
+  return true;
+}
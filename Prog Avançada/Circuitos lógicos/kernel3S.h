@@ -0,0 +1,64 @@
+#ifndef _KERNEL3S_H_
+#define _KERNEL3S_H_
+
+#include <cstdint>
+#include <string>
+
+// Os kernels de simulacao em bloco de bool3S
+// Um bloco contem W palavras de 64 bits em cada um dos planos val e def
+// (mesma codificacao de bool3S_64), ou seja, 64*W valores bool3S independentes.
+// Os kernels avaliam uma porta inteira (todas as entradas) sobre um bloco.
+// Ha versoes escalar (64 bits), AVX2 (256 bits) e AVX-512 (512 bits); a versao
+// usada eh escolhida em tempo de execucao, de acordo com a CPU.
+
+// Numero de palavras de 64 bits dos blocos usados pelas simulacoes em bloco
+// (tabela verdade, Monte Carlo, simulacao de falhas, equivalencia): 1024 combinacoes
+const unsigned PALAVRAS_BLOCO3S = 16;
+
+// Numero de bits iguais a 1 em uma palavra (usado para contar as combinacoes de
+// um bloco que satisfazem uma condicao)
+inline unsigned contarBits(uint64_t X)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll(X);
+#else
+  unsigned n = 0;
+  for (; X!=0; X &= X-1) n++;
+  return n;
+#endif
+}
+
+// Os planos de um bloco de entrada de uma porta
+struct bloco3S {
+  const uint64_t* val;
+  const uint64_t* def;
+};
+
+// Um conjunto de kernels
+// Cada kernel recebe os NIn blocos de entrada da porta e escreve o resultado
+// nos planos val e def (W palavras cada). Se Inverte==true, o resultado eh negado
+// (NAND, NOR, NXOR; a porta NOT eh um AND de uma entrada, invertido)
+struct Kernel3S {
+  // Nome do conjunto: "escalar", "avx2" ou "avx512"
+  const char* nome;
+  // Numero de palavras de 64 bits processadas por instrucao
+  unsigned palavras;
+
+  void (*portaAND)(const bloco3S* in, unsigned NIn, bool Inverte,
+                   uint64_t* val, uint64_t* def, unsigned W);
+  void (*portaOR)(const bloco3S* in, unsigned NIn, bool Inverte,
+                  uint64_t* val, uint64_t* def, unsigned W);
+  void (*portaXOR)(const bloco3S* in, unsigned NIn, bool Inverte,
+                   uint64_t* val, uint64_t* def, unsigned W);
+};
+
+// Retorna o conjunto de kernels em uso
+// Na primeira chamada, escolhe o mais largo suportado pela CPU
+const Kernel3S& kernel3S();
+
+// Fixa o conjunto de kernels em uso pelo nome ("escalar", "avx2" ou "avx512")
+// Retorna false (e nao altera nada) se o nome for invalido ou se a CPU nao
+// suportar as instrucoes correspondentes
+bool selecionarKernel3S(const std::string& Nome);
+
+#endif // _KERNEL3S_H_
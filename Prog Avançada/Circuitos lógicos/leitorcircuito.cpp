@@ -0,0 +1,350 @@
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include "leitorcircuito.h"
+
+using namespace std;
+
+// Tamanho minimo (em bytes) da faixa da secao PORTAS lida por cada thread
+static const size_t TAMANHO_MIN_FAIXA = 1<<20;
+
+/// ***********************
+/// Funcoes auxiliares
+/// ***********************
+
+static inline bool ehEspaco(char C)
+{
+  return C==' ' || C=='\t' || C=='\r';
+}
+
+// Avanca P sobre espacos e tabulacoes da linha atual
+static inline void pularEspacos(const char*& P, const char* Fim)
+{
+  while (P<Fim && ehEspaco(*P)) P++;
+}
+
+// Avanca P sobre espacos, tabulacoes e fins de linha
+static inline void pularBrancos(const char*& P, const char* Fim)
+{
+  while (P<Fim && (ehEspaco(*P) || *P=='\n')) P++;
+}
+
+// Leh uma palavra (sequencia de caracteres ateh o proximo branco)
+// Retorna true se a palavra for igual a Palavra
+static bool lerPalavra(const char*& P, const char* Fim, const char* Palavra)
+{
+  size_t n = strlen(Palavra);
+  if (size_t(Fim-P) < n || memcmp(P, Palavra, n) != 0) return false;
+  if (P+n < Fim && !ehEspaco(P[n]) && P[n]!='\n') return false;
+  P += n;
+  return true;
+}
+
+// Leh um numero (com from_chars); retorna false se nao houver numero em P
+template <class T>
+static inline bool lerNumero(const char*& P, const char* Fim, T& X)
+{
+  from_chars_result r = from_chars(P, Fim, X);
+  if (r.ec != errc()) return false;
+  P = r.ptr;
+  return true;
+}
+
+// Uma faixa de linhas da secao PORTAS e o resultado da sua leitura
+struct FaixaPortas {
+  const char* ini;
+  const char* fim;
+  // As portas lidas, na ordem do arquivo, e a arena em que foram criadas
+  vector<ptr_Port> ports;
+  ArenaPortas arena;
+  vector<uint8_t> tipo;
+  vector<uint32_t> num_in;   // numero de entradas de cada porta
+  vector<uint32_t> fanin;    // as entradas, em sinais
+  // A id e a posicao da primeira porta da faixa (primeira==0 se nenhuma)
+  unsigned primeira;
+  const char* pos_primeira;
+  // O primeiro erro da faixa (pos_erro==nullptr se nao houve erro)
+  const char* pos_erro;
+  const char* msg_erro;
+
+  FaixaPortas(): ini(nullptr), fim(nullptr), ports(), arena(), tipo(), num_in(), fanin(),
+    primeira(0), pos_primeira(nullptr), pos_erro(nullptr), msg_erro(nullptr) {}
+};
+
+// Leh as portas de uma faixa de linhas (executada em paralelo, uma faixa por thread)
+// Nin e NP sao o numero de entradas e de portas do circuito
+static void lerFaixa(FaixaPortas& F, unsigned Nin, unsigned NP)
+{
+  const char* P = F.ini;
+  const char* erro = nullptr;
+
+  while (P < F.fim && erro == nullptr)
+  {
+    const char* fim_linha = static_cast<const char*>(memchr(P, '\n', F.fim-P));
+    if (fim_linha == nullptr) fim_linha = F.fim;
+    const char* linha = P;
+    pularEspacos(P, fim_linha);
+    if (P == fim_linha)
+    {
+      P = fim_linha+1;
+      continue;
+    }
+
+    ///ID DA PORTA
+    unsigned id;
+    if (!lerNumero(P, fim_linha, id)) {erro = "id de porta esperada"; break;}
+    if (F.primeira == 0)
+    {
+      F.primeira = id;
+      F.pos_primeira = linha;
+    }
+    if (id != F.primeira + F.ports.size()) {P = linha; erro = "id de porta fora de sequencia"; break;}
+    if (id == 0 || id > NP) {P = linha; erro = "id de porta maior que o numero de portas"; break;}
+    pularEspacos(P, fim_linha);
+    if (P == fim_linha || *P != ')') {erro = "')' esperado"; break;}
+    P++;
+
+    ///TIPO DA PORTA
+    pularEspacos(P, fim_linha);
+    tipoPorta T;
+    string nome(P, (fim_linha-P < 2 ? fim_linha-P : 2));
+    for (unsigned k=0; k<nome.size(); k++) nome[k] = toupper(nome[k]);
+    if (nome.size() != 2 || (P+2 < fim_linha && !ehEspaco(P[2])) || !toTipoPorta(nome, T))
+    {
+      erro = "tipo de porta invalido";
+      break;
+    }
+    P += 2;
+
+    ///ENTRADAS (Port::ler)
+    ptr_Port porta = F.arena.criar(T);
+    const char* msg;
+    if (!porta->ler(P, fim_linha, msg))
+    {
+      ArenaPortas::destruir(porta);
+      erro = msg;
+      break;
+    }
+    F.ports.push_back(porta);
+    pularEspacos(P, fim_linha);
+    if (P != fim_linha) {erro = "caractere inesperado no fim da linha"; break;}
+
+    ///IDS DE ORIGEM
+    unsigned n = porta->getNumInputs();
+    for (unsigned i=0; i<n && erro==nullptr; i++)
+    {
+      int o = porta->getId_in(i);
+      if (o < -int(Nin) || o > int(NP))
+      {
+        // Reposiciona P sobre a id invalida (soh no caminho de erro)
+        P = static_cast<const char*>(memchr(linha, ':', fim_linha-linha)) + 1;
+        for (unsigned k=0; k<=i; k++)
+        {
+          pularEspacos(P, fim_linha);
+          if (k<i) lerNumero(P, fim_linha, o);
+        }
+        erro = "id de origem inexistente";
+      }
+      else F.fanin.push_back(o < 0 ? -o-1 : Nin+o-1);
+    }
+    if (erro != nullptr) break;
+    F.tipo.push_back(uint8_t(T));
+    F.num_in.push_back(n);
+    P = fim_linha+1;
+  }
+
+  if (erro != nullptr)
+  {
+    F.pos_erro = P;
+    F.msg_erro = erro;
+  }
+}
+
+///######### CLASSE LEITORCIRCUITO #########///
+
+LeitorCircuito::LeitorCircuito(): Nin(0), Nports(0), ports(), arena(), id_out(), tipo(),
+  fanin_ini(), fanin(), saida(), erro() {}
+
+LeitorCircuito::~LeitorCircuito()
+{
+  limpar();
+}
+
+void LeitorCircuito::limpar()
+{
+  for (unsigned i=0; i<ports.size(); i++) ArenaPortas::destruir(ports[i]);
+  ports.clear();
+  arena.clear();
+  Nin = Nports = 0;
+  id_out.clear();
+  tipo.clear();
+  fanin_ini.clear();
+  fanin.clear();
+  saida.clear();
+}
+
+void LeitorCircuito::registrarErro(const char* Ini, const char* Pos, const string& Msg)
+{
+  unsigned long long linha = 1;
+  const char* ini_linha = Ini;
+  for (const char* p=Ini; p<Pos; p++)
+  {
+    if (*p == '\n')
+    {
+      linha++;
+      ini_linha = p+1;
+    }
+  }
+  erro = "linha " + to_string(linha) + ", coluna " + to_string(Pos-ini_linha+1) + ": " + Msg;
+}
+
+void LeitorCircuito::transferirPorts(vector<ptr_Port>& P, ArenaPortas& A)
+{
+  P.swap(ports);
+  ports.clear();
+  A.absorver(arena);
+}
+
+bool LeitorCircuito::lerArquivo(const string& arq, unsigned NumThreads)
+{
+  ArquivoMapeado A;
+  if (!A.abrir(arq))
+  {
+    limpar();
+    erro = "erro na abertura do arquivo " + arq;
+    return false;
+  }
+  const char* ini = reinterpret_cast<const char*>(A.getDados());
+  return ler(ini, ini+A.getTamanho(), NumThreads);
+}
+
+bool LeitorCircuito::ler(const char* Ini, const char* Fim, unsigned NumThreads)
+{
+  limpar();
+  erro.clear();
+  const char* P = Ini;
+  unsigned NO;
+
+  ///CABECALHO
+  pularBrancos(P, Fim);
+  if (!lerPalavra(P, Fim, "CIRCUITO")) {registrarErro(Ini, P, "CIRCUITO esperado"); return false;}
+  pularEspacos(P, Fim);
+  if (!lerNumero(P, Fim, Nin) || Nin == 0) {registrarErro(Ini, P, "numero de entradas invalido"); limpar(); return false;}
+  pularEspacos(P, Fim);
+  if (!lerNumero(P, Fim, NO) || NO == 0) {registrarErro(Ini, P, "numero de saidas invalido"); limpar(); return false;}
+  pularEspacos(P, Fim);
+  if (!lerNumero(P, Fim, Nports) || Nports == 0) {registrarErro(Ini, P, "numero de portas invalido"); limpar(); return false;}
+  pularBrancos(P, Fim);
+  if (!lerPalavra(P, Fim, "PORTAS")) {registrarErro(Ini, P, "PORTAS esperado"); limpar(); return false;}
+
+  ///LOCALIZA A SECAO SAIDAS
+  // Procura de tras para frente: as linhas das portas nao podem conter a palavra
+  // A palavra candidata ocupa [q-6, q): o tamanho eh testado antes de formar q-6,
+  // para nunca apontar antes do inicio do buffer
+  const char* saidas = nullptr;
+  for (const char* f=Fim; f-P >= 6; f--)
+  {
+    const char* q = f-6;
+    if (*q=='S' && memcmp(q, "SAIDAS", 6)==0 &&
+        (q==Ini || ehEspaco(q[-1]) || q[-1]=='\n') &&
+        (q+6==Fim || ehEspaco(q[6]) || q[6]=='\n'))
+    {
+      saidas = q;
+      break;
+    }
+  }
+  if (saidas == nullptr) {registrarErro(Ini, Fim, "SAIDAS esperado"); limpar(); return false;}
+
+  ///DIVIDE A SECAO PORTAS EM FAIXAS DE LINHAS
+  if (NumThreads == 0) NumThreads = thread::hardware_concurrency();
+  if (NumThreads == 0) NumThreads = 1;
+  size_t tam = saidas-P;
+  if (NumThreads > tam/TAMANHO_MIN_FAIXA+1) NumThreads = tam/TAMANHO_MIN_FAIXA+1;
+  vector<FaixaPortas> faixas(NumThreads);
+  const char* q = P;
+  for (unsigned t=0; t<NumThreads; t++)
+  {
+    faixas[t].ini = q;
+    q = (t+1 == NumThreads ? saidas : P + tam*(t+1)/NumThreads);
+    if (q < faixas[t].ini) q = faixas[t].ini;
+    // Cada faixa termina depois de um fim de linha
+    while (q < saidas && q[-1] != '\n') q++;
+    faixas[t].fim = q;
+  }
+
+  ///LEH AS FAIXAS EM PARALELO
+  // A thread que chama tambem trabalha (leh a primeira faixa)
+  vector<thread> threads;
+  for (unsigned t=1; t<NumThreads; t++)
+  {
+    threads.push_back(thread(lerFaixa, ref(faixas[t]), Nin, Nports));
+  }
+  lerFaixa(faixas[0], Nin, Nports);
+  for (unsigned t=0; t<threads.size(); t++) threads[t].join();
+
+  ///JUNTA AS FAIXAS (NA ORDEM DO ARQUIVO)
+  bool ok = true;
+  fanin_ini.reserve(Nports+1);
+  fanin_ini.push_back(0);
+  for (unsigned t=0; t<NumThreads; t++)
+  {
+    FaixaPortas& F = faixas[t];
+    if (ok && F.primeira != 0 && F.primeira != ports.size()+1)
+    {
+      registrarErro(Ini, F.pos_primeira, "id de porta fora de sequencia");
+      ok = false;
+    }
+    if (ok && F.pos_erro != nullptr)
+    {
+      registrarErro(Ini, F.pos_erro, F.msg_erro);
+      ok = false;
+    }
+    // As portas sao transferidas mesmo depois de um erro, para serem liberadas
+    ports.insert(ports.end(), F.ports.begin(), F.ports.end());
+    arena.absorver(F.arena);
+    if (!ok) continue;
+    tipo.insert(tipo.end(), F.tipo.begin(), F.tipo.end());
+    for (unsigned k=0; k<F.num_in.size(); k++) fanin_ini.push_back(fanin_ini.back()+F.num_in[k]);
+    fanin.insert(fanin.end(), F.fanin.begin(), F.fanin.end());
+  }
+  if (ok && ports.size() != Nports)
+  {
+    registrarErro(Ini, saidas, "numero de portas menor que o indicado no cabecalho");
+    ok = false;
+  }
+  if (!ok)
+  {
+    limpar();
+    return false;
+  }
+
+  ///SAIDAS
+  P = saidas+6;
+  id_out.resize(NO);
+  saida.resize(NO);
+  for (unsigned j=0; j<NO; j++)
+  {
+    unsigned id;
+    int o;
+    pularBrancos(P, Fim);
+    const char* pos = P;
+    if (!lerNumero(P, Fim, id)) {registrarErro(Ini, P, "id de saida esperada"); limpar(); return false;}
+    if (id != j+1) {registrarErro(Ini, pos, "id de saida fora de sequencia"); limpar(); return false;}
+    pularEspacos(P, Fim);
+    if (P == Fim || *P != ')') {registrarErro(Ini, P, "')' esperado"); limpar(); return false;}
+    P++;
+    pularEspacos(P, Fim);
+    pos = P;
+    if (!lerNumero(P, Fim, o)) {registrarErro(Ini, P, "id de origem da saida esperada"); limpar(); return false;}
+    if (o == 0 || o < -int(Nin) || o > int(Nports))
+    {
+      registrarErro(Ini, pos, "id de origem inexistente");
+      limpar();
+      return false;
+    }
+    id_out[j] = o;
+    saida[j] = (o < 0 ? -o-1 : Nin+o-1);
+  }
+  return true;
+}
@@ -0,0 +1,85 @@
+#ifndef _LEITORCIRCUITO_H_
+#define _LEITORCIRCUITO_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "port.h"
+#include "arenaportas.h"
+#include "netlist.h"
+#include "netlistbin.h"
+
+/// ###########################################################################
+/// LEITURA RAPIDA DO FORMATO TEXTO (CIRCUITO/PORTAS/SAIDAS)
+/// O arquivo eh mapeado em memoria e lido diretamente do buffer (std::from_chars),
+/// sem streams e sem copias. A secao PORTAS, que tem uma porta por linha, eh
+/// dividida em faixas de linhas lidas em paralelo.
+///
+/// Sao feitos os mesmos testes da leitura por stream: cabecalho, ids das portas
+/// e das saidas em sequencia, tipo de porta (validType), numero de entradas de
+/// cada porta (validNumInputs) e ids de origem validas (entradas de -1 a -Nin,
+/// portas de 1 a Nports). Em caso de erro, a mensagem indica a linha e a coluna.
+///
+/// O resultado sao as portas (criadas em uma arena), as ids das saidas e a
+/// netlist "plana" (tipos, fanin e saidas em sinais, como no formato binario),
+/// pronta para Netlist::montar.
+/// ###########################################################################
+
+class LeitorCircuito {
+private:
+  // Numero de entradas e de portas do circuito
+  unsigned Nin, Nports;
+  // As portas lidas: pertencem ao leitor ateh serem transferidas (transferirPorts)
+  std::vector<ptr_Port> ports;
+  // A memoria das portas (as arenas das threads de leitura, juntas)
+  ArenaPortas arena;
+  // As ids das origens das saidas
+  std::vector<int> id_out;
+  // A netlist plana: tipos, entradas em formato CSR e saidas, em sinais
+  std::vector<uint8_t> tipo;
+  std::vector<uint32_t> fanin_ini, fanin, saida;
+  // A mensagem do ultimo erro
+  std::string erro;
+
+  // Libera as portas ainda nao transferidas e limpa os dados
+  void limpar();
+  // Registra um erro na posicao Pos do buffer que comeca em Ini
+  // (linha e coluna sao calculadas soh aqui, no caminho de erro)
+  void registrarErro(const char* Ini, const char* Pos, const std::string& Msg);
+
+  LeitorCircuito(const LeitorCircuito&);
+  void operator=(const LeitorCircuito&);
+
+public:
+  LeitorCircuito();
+  ~LeitorCircuito();
+
+  // Leh um circuito do arquivo arq (mapeado em memoria)
+  // NumThreads eh o numero de threads da leitura das portas (0: uma por nucleo)
+  // Retorna true se deu tudo OK; false se deu erro (ver getErro)
+  bool lerArquivo(const std::string& arq, unsigned NumThreads=0);
+
+  // Leh um circuito do buffer de texto Ini a Fim-1
+  bool ler(const char* Ini, const char* Fim, unsigned NumThreads=0);
+
+  // A mensagem do ultimo erro ("linha L, coluna C: ..."); vazia se nao houve erro
+  const std::string& getErro() const {return erro;}
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumPorts() const {return Nports;}
+  unsigned getNumOutputs() const {return id_out.size();}
+  const std::vector<int>& getIdOutputs() const {return id_out;}
+
+  // A netlist plana (ver Netlist::montar)
+  const uint8_t* getTipos() const {return tipo.data();}
+  const uint32_t* getFaninIni() const {return fanin_ini.data();}
+  const uint32_t* getFanin() const {return fanin.data();}
+  const uint32_t* getSaidas() const {return saida.data();}
+
+  // Transfere as portas lidas para P e a memoria delas para a arena A (o leitor
+  // deixa de ser o dono das portas)
+  // O conteudo anterior de P eh descartado sem liberacao: P deve estar vazio
+  void transferirPorts(std::vector<ptr_Port>& P, ArenaPortas& A);
+};
+
+#endif // _LEITORCIRCUITO_H_
@@ -7,7 +7,6 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <time.h>
-#include <cmath>
 #include <vector>
 #include <string>
 #include "bool3S.h"
@@ -23,9 +22,13 @@ MainCircuito::MainCircuito(QWidget *parent) : QMainWindow(parent)
 ,newCircuito(new NewCircuito(this))
 ,modificarPorta(new ModificarPorta(this))
 ,modificarSaida(new ModificarSaida(this))
+,modeloTabela(new ModeloTabelaVerdade(this))
 {
   ui->setupUi(this);
 
+  // A tabela verdade exibe os dados do modelo
+  ui->tableTabelaVerdade->setModel(modeloTabela);
+
   // Cabecalhos da tabela de portas
   ui->tablePortas->horizontalHeader()->setVisible(true);
   ui->tablePortas->verticalHeader()->setVisible(true);
@@ -128,7 +131,6 @@ void MainCircuito::redimensionaTabelas()
 
   // Variaveis auxiliares
   QString texto;
-  QLabel *prov;
   int i;
 
   // ==========================================================
@@ -169,39 +171,8 @@ void MainCircuito::redimensionaTabelas()
   // Redimensiona a tabela verdade
   // ==========================================================
 
-  // Antes de redimensionar a tabela, anula todos os setSpan da primeira linha
-  // Se nao fizer isso, dah erro ao redimensionar
-  ui->tableTabelaVerdade->clearSpans();
-
-  // Limpa todo o conteudo, inclusive cabecalhos
-  ui->tableTabelaVerdade->clear();
-
-  // Modifica as dimensoes
-  ui->tableTabelaVerdade->setColumnCount(numInputs+numOutputs);
-  int numCombinacoesEntrada = (numInputs>0 ? round(pow(3,numInputs)) : 0);
-  // a tabela verdade tem uma linha a mais do que o numero de combinacoes de entrada
-  // para conter o pseudocabecalho
-  ui->tableTabelaVerdade->setRowCount(1 + numCombinacoesEntrada);
-
-  // Cria o pseudocabecalho na primeira linha
-  // Entradas
-  if (numInputs > 0)
-  {
-    ui->tableTabelaVerdade->setSpan(0,0,1,numInputs);
-    prov = new QLabel("ENTRADAS");
-    prov->setAlignment(Qt::AlignCenter);
-    prov->setStyleSheet("font-weight: bold");
-    ui->tableTabelaVerdade->setCellWidget(0,0,prov);
-  }
-  // Saidas
-  if (numOutputs > 0)
-  {
-    ui->tableTabelaVerdade->setSpan(0,numInputs,1,numOutputs);
-    prov = new QLabel("SAIDAS");
-    prov->setAlignment(Qt::AlignCenter);
-    prov->setStyleSheet("font-weight: bold");
-    ui->tableTabelaVerdade->setCellWidget(0,numInputs,prov);
-  }
+  // A tabela verdade fica vazia, apenas com os cabecalhos das colunas
+  modeloTabela->limpar(numInputs, numOutputs);
 
   // ==========================================================
   // Fixa os limites para os spin boxs (emit signSetRangeInputs)
@@ -296,29 +267,8 @@ void MainCircuito::limparTabelaVerdade()
   int numInputs=C.getNumInputs();
   int numOutputs=C.getNumOutputs();
 
-  // Variavel auxiliar
-  QLabel *prov;
-
-  // Limpa todo o conteudo, inclusive cabecalhos
-  ui->tableTabelaVerdade->clear();
-
-  // Recoloca os textos dos cabecalhos na primeira linha
-  // Entradas
-  if (numInputs > 0)
-  {
-    prov = new QLabel("ENTRADAS");
-    prov->setAlignment(Qt::AlignCenter);
-    prov->setStyleSheet("font-weight: bold");
-    ui->tableTabelaVerdade->setCellWidget(0,0,prov);
-  }
-  // Saidas
-  if (numOutputs > 0)
-  {
-    prov = new QLabel("SAIDAS");
-    prov->setAlignment(Qt::AlignCenter);
-    prov->setStyleSheet("font-weight: bold");
-    ui->tableTabelaVerdade->setCellWidget(0,numInputs,prov);
-  }
+  // Remove todas as linhas, mantendo os cabecalhos das colunas
+  modeloTabela->limpar(numInputs, numOutputs);
 }
 
 void MainCircuito::on_actionSair_triggered()
@@ -341,12 +291,33 @@ void MainCircuito::on_actionLer_triggered()
   if (!fileName.isEmpty()) {
     // Leh o circuito do arquivo com nome "fileName", usando a funcao apropriada da classe Circuito
     // e testa se a leitura deu certo
-    bool leitura_OK = C.ler(fileName.toStdString());
+    std::string erro;
+    bool leitura_OK = C.ler(fileName.toStdString(), erro);
     if (!leitura_OK)
     {
-      // Exibe uma msg de erro na leitura
+      // Exibe uma msg de erro na leitura (com a linha e a coluna do erro)
+      QMessageBox msgBox;
+      msgBox.setText("Erro ao ler um circuito a partir do arquivo:\n"+fileName+
+                     "\n"+QString::fromStdString(erro));
+      msgBox.exec();
+    }
+    else if (C.realimentado())
+    {
+      // Informa que o circuito possui lacos de realimentacao
+      // (componentes fortemente conexas ciclicas) e os seus tamanhos
+      std::vector<unsigned> tamanhos = C.getTamanhosComponentesCiclicas();
+      QString lista;
+      for (unsigned k=0; k<tamanhos.size(); k++)
+      {
+        lista += (k>0 ? ", " : "") + QString::number(tamanhos[k]);
+      }
       QMessageBox msgBox;
-      msgBox.setText("Erro ao ler um circuito a partir do arquivo:\n"+fileName);
+      msgBox.setText("O circuito possui realimentacao.\n"
+                     "Numero de componentes fortemente conexas: " +
+                     QString::number(C.getNumComponentes()) +
+                     "\nNumero de lacos (componentes ciclicas): " +
+                     QString::number(tamanhos.size()) +
+                     "\nNumero de portas em cada laco: " + lista);
       msgBox.exec();
     }
 
@@ -385,7 +356,7 @@ void MainCircuito::on_actionSalvar_triggered()
 }
 
 // Gera e exibe a tabela verdade para o circuito
-// Chama a funcao simular da classe circuito
+// As linhas sao simuladas sob demanda pelo modelo da tabela (ModeloTabelaVerdade)
 void MainCircuito::on_actionGerar_tabela_triggered()
 {
   // Soh pode simular se o Circuito for valido
@@ -398,79 +369,9 @@ void MainCircuito::on_actionGerar_tabela_triggered()
     return;
   }
 
-  //
-  // Cria e inicializa o vetor de entradas do circuito
-  //
-
-  // Esses valores (numInputs, numOutputs)
-  // devem ser lidos a partir de metodos de consulta da classe Circuito
-  int numInputs=C.getNumInputs();
-  int numOutputs=C.getNumOutputs();
-  // Calcula o numero de combinacoes de entrada
-  int numCombinacoesEntrada = (numInputs>0 ? round(pow(3,numInputs)) : 0);
-
-  // As entradas do circuito
-  std::vector<bool3S> in_circ(numInputs);    // bool3S::UNDEF; bool3S::FALSE; bool3S::TRUE
-
-  // Variaveis auxiliares
-  QLabel *prov;
-  int i,j;
-
-  // Inicializa todas as entradas com bool3S::UNDEF
-  for (i=0; i<numInputs; i++) in_circ[i] = bool3S::UNDEF;
-
-  //
-  // Gera todas as combinacoes de entrada e as linhas correspondentes da tabela verdade
-  //
-  for (i=0; i<numCombinacoesEntrada; i++)
-  {
-    //
-    // Exibe a i-esima combinao de entrada
-    //
-
-    // Cria os QLabels correspondentes aas entradas in_circ[j]
-    for (j=0; j<numInputs; j++)
-    {
-      prov = new QLabel( QString( toChar(in_circ[j]) ) );
-      prov->setAlignment(Qt::AlignCenter);
-      ui->tableTabelaVerdade->setCellWidget(i+1, j, prov);
-    }
-
-    //
-    // Simula a saida para a i-esima combinacao de entrada
-    //
-
-    // Chama o metodo de simulacao da classe Circuito
-    C.simular(in_circ);
-
-    //
-    // Exibe a saida correspondente aa i-esima combinacao de entrada
-    //
-
-    // Cria os QLabels correspondentes aas saidas outputs[j]
-    for (j=0; j<numOutputs; j++)
-    {
-      // A saida deve ser obtida com um metodo de consulta da classe Circuito
-      bool3S output = C.getOutput(j);
-      prov = new QLabel( QString( toChar(output) ) );
-      prov->setAlignment(Qt::AlignCenter);
-      ui->tableTabelaVerdade->setCellWidget(i+1, j+numInputs, prov);
-    }
-
-    // Gera a proxima combinacao de entrada
-
-    // Incrementa a ultima entrada que nao for TRUE
-    // Se a ultima for TRUE, faz essa ser UNDEF e tenta incrementar a anterior
-    j = numInputs-1;
-    while (in_circ[j]==bool3S::TRUE && j>=0)
-    {
-      in_circ[j] = bool3S::UNDEF;
-      j--;
-    };
-    // Incrementa a input selecionada
-    if (j>=0) in_circ[j]++;
-  }
-
+  // A tabela verdade eh exibida atraves do modelo: as linhas soh sao simuladas
+  // quando aparecem na tela, em blocos de 64*Circuito::PALAVRAS_BLOCO linhas
+  modeloTabela->setCircuito(C);
 }
 
 // Exibe a caixa de dialogo para fixar caracteristicas de uma porta
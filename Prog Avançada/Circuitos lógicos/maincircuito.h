@@ -6,6 +6,7 @@
 #include "newcircuito.h"
 #include "modificarporta.h"
 #include "modificarsaida.h"
+#include "modelotabelaverdade.h"
 #include "circuito.h"
 #include "port.h"
 
@@ -49,7 +50,7 @@ private slots:
   void on_actionSalvar_triggered();
 
   // Gera e exibe a tabela verdade para o circuito
-  // Chama a funcao simular da classe circuito
+  // As linhas sao simuladas sob demanda pelo modelo da tabela (ModeloTabelaVerdade)
   void on_actionGerar_tabela_triggered();
 
   // Exibe a caixa de dialogo para fixar caracteristicas de uma porta
@@ -87,6 +88,9 @@ private:
   ModificarPorta *modificarPorta;  // Caixa de dialogo para modificar uma porta
   ModificarSaida *modificarSaida;  // Caixa de dialogo para modificar uma saida
 
+  // O modelo que fornece as celulas da tabela verdade para a view tableTabelaVerdade
+  ModeloTabelaVerdade *modeloTabela;
+
   // Redimensiona todas as tabelas e reexibe todos os valores da barra de status
   // Essa funcao deve ser chamada sempre que mudar o circuito (digitar ou ler de arquivo)
   void redimensionaTabelas();
@@ -0,0 +1,120 @@
+#include "modelotabelaverdade.h"
+#include <climits>
+
+ModeloTabelaVerdade::ModeloTabelaVerdade(QObject *parent) : QAbstractTableModel(parent)
+,C()
+,numInputs(0)
+,numOutputs(0)
+,numLinhas(0)
+,peso()
+,cache()
+,blocoCache()
+{
+}
+
+// Passa a exibir a tabela verdade do circuito C
+bool ModeloTabelaVerdade::setCircuito(const Circuito& Circ)
+{
+  // Nao exibe circuitos invalidos nem com tantas entradas que o numero de linhas
+  // nao caiba em um unsigned long long
+  if (!Circ.valid() || Circ.getNumLinhasTabela()==0)
+  {
+    limpar(Circ.getNumInputs(), Circ.getNumOutputs());
+    return false;
+  }
+
+  beginResetModel();
+  C = Circ;
+  numInputs = C.getNumInputs();
+  numOutputs = C.getNumOutputs();
+  // O numero de linhas de um modelo do Qt eh um int
+  // Circuitos com muitas entradas (mais de 19) tem apenas as primeiras linhas exibidas
+  unsigned long long linhas = C.getNumLinhasTabela();
+  numLinhas = (linhas > INT_MAX ? INT_MAX : int(linhas));
+
+  peso.assign(numInputs, 1);
+  for (int j=numInputs-2; j>=0; j--) peso[j] = 3*peso[j+1];
+
+  // A cache eh alocada uma unica vez por circuito e comeca vazia
+  cache.assign(NUM_BLOCOS, bool3S_vector(LINHAS_BLOCO*numOutputs));
+  blocoCache.assign(NUM_BLOCOS, -1);
+  endResetModel();
+  return true;
+}
+
+// Exibe uma tabela sem linhas, apenas com os cabecalhos
+void ModeloTabelaVerdade::limpar(int NumInputs, int NumOutputs)
+{
+  beginResetModel();
+  C.clear();
+  numInputs = NumInputs;
+  numOutputs = NumOutputs;
+  numLinhas = 0;
+  peso.clear();
+  cache.clear();
+  blocoCache.clear();
+  endResetModel();
+}
+
+int ModeloTabelaVerdade::rowCount(const QModelIndex &parent) const
+{
+  return (parent.isValid() ? 0 : numLinhas);
+}
+
+int ModeloTabelaVerdade::columnCount(const QModelIndex &parent) const
+{
+  return (parent.isValid() ? 0 : numInputs+numOutputs);
+}
+
+// Retorna o valor da saida J na linha L, simulando o bloco se necessario
+bool3S ModeloTabelaVerdade::saida(int L, int J) const
+{
+  int bloco = L/LINHAS_BLOCO;
+  int k = bloco%NUM_BLOCOS;
+
+  if (blocoCache[k] != bloco)
+  {
+    // Simula o bloco inteiro (com uma soh thread: um bloco eh pequeno)
+    unsigned long long ini = (unsigned long long)bloco*LINHAS_BLOCO;
+    unsigned long long fim = ini+LINHAS_BLOCO;
+    if (fim > C.getNumLinhasTabela()) fim = C.getNumLinhasTabela();
+    if (!C.gerarFaixaTabela(ini, fim, cache[k], 1)) return bool3S::UNDEF;
+    blocoCache[k] = bloco;
+  }
+  return cache[k][(L%LINHAS_BLOCO)*numOutputs + J];
+}
+
+QVariant ModeloTabelaVerdade::data(const QModelIndex &index, int role) const
+{
+  if (!index.isValid() || index.row()>=numLinhas ||
+      index.column()>=numInputs+numOutputs) return QVariant();
+
+  if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+  if (role != Qt::DisplayRole) return QVariant();
+
+  int L = index.row();
+  int j = index.column();
+  bool3S valor;
+  if (j < numInputs)
+  {
+    // O valor da entrada j eh o j-esimo digito (na base 3) do numero da linha
+    valor = bool3S((L/peso[j])%3);
+  }
+  else
+  {
+    valor = saida(L, j-numInputs);
+  }
+  return QString(toChar(valor));
+}
+
+QVariant ModeloTabelaVerdade::headerData(int section, Qt::Orientation orientation,
+                                         int role) const
+{
+  if (role != Qt::DisplayRole) return QVariant();
+
+  // As linhas sao numeradas a partir de 0 (o numero da linha em base 3 eh a combinacao)
+  if (orientation == Qt::Vertical) return section;
+  // As colunas das entradas (E1, E2...) e depois as das saidas (S1, S2...)
+  if (section < numInputs) return QString("E%1").arg(section+1);
+  return QString("S%1").arg(section-numInputs+1);
+}
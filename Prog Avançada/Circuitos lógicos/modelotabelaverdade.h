@@ -0,0 +1,70 @@
+#ifndef MODELOTABELAVERDADE_H
+#define MODELOTABELAVERDADE_H
+
+#include <QAbstractTableModel>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_vector.h"
+#include "circuito.h"
+
+/* ======================================================================== *
+ * ESSA EH A CLASSE QUE FORNECE OS DADOS DA TABELA VERDADE PARA A TELA      *
+ * ======================================================================== */
+
+// Modelo (no sentido do Qt) da tabela verdade de um circuito
+// Nenhuma linha eh armazenada por inteiro: cada celula eh calculada quando a
+// view pede para exibi-la. Os valores das entradas sao obtidos a partir do numero
+// da linha; os das saidas sao simulados em blocos de LINHAS_BLOCO linhas, e os
+// ultimos NUM_BLOCOS blocos simulados ficam guardados em uma cache.
+// Assim, a memoria e o tempo gastos dependem apenas das linhas exibidas, e nao
+// do numero total (3^Nin) de linhas.
+class ModeloTabelaVerdade : public QAbstractTableModel
+{
+  Q_OBJECT
+
+public:
+  explicit ModeloTabelaVerdade(QObject *parent = 0);
+
+  // Passa a exibir a tabela verdade do circuito C
+  // O circuito eh copiado, para que as linhas ainda nao simuladas nao dependam
+  // de alteracoes posteriores. Nenhuma linha eh simulada aqui
+  // Retorna false (e exibe uma tabela vazia) se o circuito nao for valido
+  bool setCircuito(const Circuito& C);
+
+  // Exibe uma tabela sem linhas, apenas com os cabecalhos das colunas
+  // de NumInputs entradas e NumOutputs saidas
+  void limpar(int NumInputs, int NumOutputs);
+
+  // As funcoes da interface QAbstractTableModel
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+private:
+  // Numero de linhas simuladas de cada vez (um bloco de Circuito::simularBloco)
+  static const int LINHAS_BLOCO = 64*Circuito::PALAVRAS_BLOCO;
+  // Numero de blocos guardados na cache
+  static const int NUM_BLOCOS = 64;
+
+  // O circuito cuja tabela eh exibida
+  Circuito C;
+  // Dimensoes da tabela
+  int numInputs, numOutputs, numLinhas;
+  // O peso de cada entrada no numero da linha: 3^(numInputs-1-j)
+  std::vector<long long> peso;
+
+  // A cache de blocos simulados (mapeamento direto: o bloco B fica na posicao
+  // B%NUM_BLOCOS). As saidas da linha L do bloco que estah na posicao k ficam em
+  // cache[k][(L%LINHAS_BLOCO)*numOutputs] em diante
+  mutable std::vector<bool3S_vector> cache;
+  // O bloco que estah em cada posicao da cache (-1 se nenhum)
+  mutable std::vector<int> blocoCache;
+
+  // Retorna o valor da saida J (de 0 a numOutputs-1) na linha L,
+  // simulando o bloco se necessario
+  bool3S saida(int L, int J) const;
+};
+
+#endif // MODELOTABELAVERDADE_H
@@ -0,0 +1,197 @@
+#include <cmath>
+#include "montecarlo.h"
+
+using namespace std;
+
+/// ***********************
+/// Probabilidades
+/// ***********************
+
+bool ProbabilidadeEntrada::valid() const
+{
+  return pFalse >= 0.0 && pTrue >= 0.0 && pFalse+pTrue <= 1.0+1e-9;
+}
+
+/// ***********************
+/// Estatisticas
+/// ***********************
+
+void EstatisticaSinais::clear()
+{
+  Nin = Nsinais = 0;
+  saidas.clear();
+  amostras = 0;
+  contTrue.clear();
+  contFalse.clear();
+  trocas.clear();
+}
+
+unsigned long long EstatisticaSinais::getContagem(unsigned S, bool3S B) const
+{
+  switch (B)
+  {
+  case bool3S::TRUE: return contTrue[S];
+  case bool3S::FALSE: return contFalse[S];
+  default: return amostras-contTrue[S]-contFalse[S];
+  }
+}
+
+double EstatisticaSinais::getFrequencia(unsigned S, bool3S B) const
+{
+  if (amostras == 0) return 0.0;
+  return double(getContagem(S, B))/amostras;
+}
+
+double EstatisticaSinais::getTaxaTroca(unsigned S) const
+{
+  if (amostras < 2) return 0.0;
+  return double(trocas[S])/(amostras-1);
+}
+
+double EstatisticaSinais::getErroPadrao() const
+{
+  if (amostras == 0) return 1.0;
+  // O erro padrao de uma frequencia p estimada com n amostras eh sqrt(p(1-p)/n)
+  double maior = 0.0;
+  for (unsigned s=0; s<Nsinais; s++)
+  {
+    for (bool3S B : {bool3S::TRUE, bool3S::FALSE, bool3S::UNDEF})
+    {
+      double p = getFrequencia(s, B);
+      if (p*(1.0-p) > maior) maior = p*(1.0-p);
+    }
+  }
+  return sqrt(maior/amostras);
+}
+
+std::ostream& EstatisticaSinais::imprimirCsv(std::ostream& O) const
+{
+  O << "Sinal,TRUE,FALSE,UNDEF,Trocas\n";
+  for (unsigned s=0; s<Nsinais+saidas.size(); s++)
+  {
+    unsigned sinal = (s<Nsinais ? s : saidas[s-Nsinais]);
+    if (s < Nin) O << 'E' << s+1;
+    else if (s < Nsinais) O << 'P' << s-Nin+1;
+    else O << 'S' << s-Nsinais+1;
+    O << ',' << getFrequencia(sinal, bool3S::TRUE)
+      << ',' << getFrequencia(sinal, bool3S::FALSE)
+      << ',' << getFrequencia(sinal, bool3S::UNDEF)
+      << ',' << getTaxaTroca(sinal) << '\n';
+  }
+  return O;
+}
+
+/// ***********************
+/// Simulacao
+/// ***********************
+
+// Probabilidades quantizadas: multiplos de 2^-16 (de 0 a 65536)
+static const uint32_t UM_QUANT = 65536;
+
+static uint32_t quantizar(double P)
+{
+  if (P <= 0.0) return 0;
+  if (P >= 1.0) return UM_QUANT;
+  return uint32_t(P*UM_QUANT+0.5);
+}
+
+// Sorteia 64 bits independentes, cada um igual a 1 com probabilidade P/2^16
+// Os bits de P sao percorridos do menos para o mais significativo: depois de
+// cada passo, a probabilidade de 1 eh (bit + probabilidade anterior)/2
+static inline uint64_t sortearBits(GeradorXoshiro& G, uint32_t P)
+{
+  if (P == 0) return 0;
+  if (P >= UM_QUANT) return ~uint64_t(0);
+  uint64_t r = 0;
+  for (unsigned i=__builtin_ctz(P); i<16; i++)
+  {
+    uint64_t w = G();
+    r = ((P>>i) & 1) ? (r|w) : (r&w);
+  }
+  return r;
+}
+
+bool simularMonteCarlo(const Netlist& N, const std::vector<ProbabilidadeEntrada>& P,
+                       unsigned long long NumVetores, uint64_t Semente,
+                       EstatisticaSinais& E, double Tolerancia)
+{
+  E.clear();
+  const unsigned NI = N.getNumInputs(), NS = N.getNumSinais(), W = PALAVRAS_BLOCO3S;
+  if (!P.empty() && P.size() != NI) return false;
+
+  // Para cada entrada: probabilidade de ser definida, e de ser TRUE se for definida
+  vector<uint32_t> pDef(NI), pTrue(NI);
+  for (unsigned i=0; i<NI; i++)
+  {
+    ProbabilidadeEntrada p = (P.empty() ? ProbabilidadeEntrada() : P[i]);
+    if (!p.valid()) return false;
+    double d = p.pFalse+p.pTrue;
+    pDef[i] = quantizar(d);
+    pTrue[i] = (d > 0.0 ? quantizar(p.pTrue/d) : 0);
+  }
+
+  E.Nin = NI;
+  E.Nsinais = NS;
+  for (unsigned j=0; j<N.getNumOutputs(); j++) E.saidas.push_back(N.getSaida(j));
+  E.contTrue.assign(NS, 0);
+  E.contFalse.assign(NS, 0);
+  E.trocas.assign(NS, 0);
+
+  EstadoNetlist S;
+  N.prepararEstado(S, W);
+  GeradorXoshiro G(Semente);
+  // O valor de cada sinal na ultima combinacao do bloco anterior (bit 63)
+  vector<uint64_t> val_ant(NS, 0), def_ant(NS, 0);
+
+  while (E.amostras < NumVetores)
+  {
+    // Numero de combinacoes validas deste bloco (o ultimo pode ser incompleto)
+    unsigned long long restantes = NumVetores-E.amostras;
+    unsigned validas = (restantes < 64ull*W ? unsigned(restantes) : 64*W);
+
+    for (unsigned i=0; i<NI; i++)
+    {
+      for (unsigned w=0; w<W; w++)
+      {
+        uint64_t def = sortearBits(G, pDef[i]);
+        S.def[i*W+w] = def;
+        S.val[i*W+w] = sortearBits(G, pTrue[i]) & def;
+      }
+    }
+    N.simularBloco(S);
+
+    for (unsigned s=0; s<NS; s++)
+    {
+      const uint64_t* val = &S.val[s*W];
+      const uint64_t* def = &S.def[s*W];
+      uint64_t va = val_ant[s], da = def_ant[s];
+      unsigned long long nT = 0, nF = 0, nTroca = 0;
+      for (unsigned w=0; w<W && 64*w<validas; w++)
+      {
+        uint64_t mascara = (validas-64*w >= 64 ? ~uint64_t(0) : (uint64_t(1) << (validas-64*w))-1);
+        // O valor de cada combinacao anterior: a palavra deslocada de 1 bit, com
+        // o ultimo bit da palavra anterior
+        // (o plano val soh eh considerado onde o valor eh definido)
+        uint64_t v = val[w] & def[w], d = def[w];
+        uint64_t vp = (v << 1) | (va >> 63), dp = (d << 1) | (da >> 63);
+        uint64_t troca = ((v^vp) | (d^dp)) & mascara;
+        // A primeira combinacao da sequencia nao tem anterior
+        if (E.amostras == 0 && w == 0) troca &= ~uint64_t(1);
+        nT += contarBits(v & mascara);
+        nF += contarBits(~v & d & mascara);
+        nTroca += contarBits(troca);
+        va = v;
+        da = d;
+      }
+      E.contTrue[s] += nT;
+      E.contFalse[s] += nF;
+      E.trocas[s] += nTroca;
+      val_ant[s] = va;
+      def_ant[s] = da;
+    }
+    E.amostras += validas;
+
+    if (Tolerancia > 0.0 && E.getErroPadrao() <= Tolerancia) break;
+  }
+  return true;
+}
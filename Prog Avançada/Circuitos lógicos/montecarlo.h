@@ -0,0 +1,131 @@
+#ifndef _MONTECARLO_H_
+#define _MONTECARLO_H_
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "netlist.h"
+
+/// ###########################################################################
+/// SIMULACAO ALEATORIA (MONTE CARLO)
+/// Para circuitos com entradas demais para percorrer a tabela verdade, estima o
+/// comportamento dos sinais a partir de uma sequencia de combinacoes de entrada
+/// sorteadas: para cada sinal (entradas e portas), a frequencia de cada valor
+/// (TRUE, FALSE, UNDEF) e a taxa de troca (fracao das combinacoes consecutivas da
+/// sequencia em que o valor do sinal muda, ou seja, a atividade de chaveamento).
+///
+/// Cada entrada tem as suas proprias probabilidades de FALSE, TRUE e UNDEF, e as
+/// entradas sao sorteadas de forma independente. As combinacoes sao simuladas em
+/// blocos de 1024 (simulacao em bloco, Netlist::simularBloco), e as
+/// contagens sao feitas por palavra (popcount), sem percorrer as combinacoes uma
+/// a uma. O gerador (xoshiro256**) eh inicializado pela semente: a mesma semente
+/// da sempre as mesmas estatisticas.
+///
+/// As probabilidades das entradas sao arredondadas para multiplos de 2^-16: cada
+/// bit sorteado com probabilidade p custa ateh 16 palavras aleatorias por 64
+/// combinacoes (1 palavra se p=1/2).
+/// ###########################################################################
+
+// Gerador pseudo-aleatorio xoshiro256** (usado tambem na simulacao aleatoria
+// da verificacao de equivalencia)
+class GeradorXoshiro {
+private:
+  uint64_t s[4];
+  static uint64_t rotl(uint64_t X, int K) {return (X << K) | (X >> (64-K));}
+
+public:
+  // Os 4 estados iniciais sao gerados a partir da semente por splitmix64
+  explicit GeradorXoshiro(uint64_t Semente)
+  {
+    for (unsigned k=0; k<4; k++)
+    {
+      uint64_t z = (Semente += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      s[k] = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t operator()()
+  {
+    const uint64_t r = rotl(s[1]*5, 7)*9, t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return r;
+  }
+};
+
+// As probabilidades dos valores de uma entrada (a de UNDEF eh 1-pFalse-pTrue)
+struct ProbabilidadeEntrada {
+  double pFalse, pTrue;
+
+  // O padrao eh a distribuicao uniforme sobre os 3 valores
+  ProbabilidadeEntrada(double F=1.0/3, double T=1.0/3): pFalse(F), pTrue(T) {}
+  double pUndef() const {return 1.0-pFalse-pTrue;}
+  // true se as probabilidades forem validas (nao negativas e com soma ateh 1)
+  bool valid() const;
+};
+
+// As estatisticas dos sinais de uma netlist
+// O sinal s eh a entrada s (s < Nin) ou a porta s-Nin (como em Netlist)
+class EstatisticaSinais {
+private:
+  // Numero de entradas e sinais da netlist
+  unsigned Nin, Nsinais;
+  // O sinal de cada saida
+  std::vector<unsigned> saidas;
+  // Numero de combinacoes simuladas
+  unsigned long long amostras;
+  // Para cada sinal: numero de combinacoes com o valor TRUE e com o valor FALSE
+  // (as demais sao UNDEF) e numero de trocas de valor entre combinacoes consecutivas
+  std::vector<unsigned long long> contTrue, contFalse, trocas;
+
+  friend bool simularMonteCarlo(const Netlist& N, const std::vector<ProbabilidadeEntrada>& P,
+                                unsigned long long NumVetores, uint64_t Semente,
+                                EstatisticaSinais& E, double Tolerancia);
+
+public:
+  EstatisticaSinais(): Nin(0), Nsinais(0), saidas(), amostras(0), contTrue(), contFalse(), trocas() {}
+  void clear();
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumSinais() const {return Nsinais;}
+  unsigned getNumOutputs() const {return saidas.size();}
+  // O sinal da saida J (de 0 a Nout-1)
+  unsigned getSaida(unsigned J) const {return saidas[J];}
+  unsigned long long getNumAmostras() const {return amostras;}
+
+  // Numero de combinacoes em que o sinal S teve o valor B
+  unsigned long long getContagem(unsigned S, bool3S B) const;
+  // Frequencia (de 0 a 1) do valor B no sinal S
+  double getFrequencia(unsigned S, bool3S B) const;
+  // Numero de trocas de valor do sinal S entre combinacoes consecutivas
+  unsigned long long getNumTrocas(unsigned S) const {return trocas[S];}
+  // Fracao das combinacoes consecutivas em que o valor do sinal S muda
+  double getTaxaTroca(unsigned S) const;
+  // Maior erro padrao das frequencias estimadas, entre todos os sinais e valores
+  double getErroPadrao() const;
+
+  // Grava as estatisticas em CSV: cabecalho Sinal,TRUE,FALSE,UNDEF,Trocas e uma
+  // linha por sinal, com as frequencias e a taxa de troca: primeiro as entradas
+  // (E1 a En), depois as portas (P1 a Pm) e as saidas (S1 a Sk)
+  std::ostream& imprimirCsv(std::ostream& O) const;
+};
+
+// Simula NumVetores combinacoes de entrada sorteadas (com as probabilidades P de
+// cada entrada; P vazio: todas com a distribuicao uniforme) e guarda em E as
+// estatisticas dos sinais da netlist N (que deve estar montada)
+// Se Tolerancia > 0, para antes, ao fim do primeiro bloco em que o erro padrao de
+// todas as frequencias estimadas (getErroPadrao) for no maximo Tolerancia
+// Retorna false se P nao tiver um elemento por entrada ou se alguma probabilidade
+// for invalida
+bool simularMonteCarlo(const Netlist& N, const std::vector<ProbabilidadeEntrada>& P,
+                       unsigned long long NumVetores, uint64_t Semente,
+                       EstatisticaSinais& E, double Tolerancia=0.0);
+
+#endif // _MONTECARLO_H_
@@ -0,0 +1,652 @@
+#include "netlist.h"
+
+using namespace std;
+
+///
+/// Conversoes de tipoPorta
+///
+
+bool toTipoPorta(const std::string& Nome, tipoPorta& T)
+{
+  if (Nome=="NT") {T=tipoPorta::NT; return true;}
+  if (Nome=="AN") {T=tipoPorta::AN; return true;}
+  if (Nome=="NA") {T=tipoPorta::NA; return true;}
+  if (Nome=="OR") {T=tipoPorta::OR; return true;}
+  if (Nome=="NO") {T=tipoPorta::NO; return true;}
+  if (Nome=="XO") {T=tipoPorta::XO; return true;}
+  if (Nome=="NX") {T=tipoPorta::NX; return true;}
+  return false;
+}
+
+std::string toString(tipoPorta T)
+{
+  switch (T)
+  {
+  case tipoPorta::NT: return "NT";
+  case tipoPorta::AN: return "AN";
+  case tipoPorta::NA: return "NA";
+  case tipoPorta::OR: return "OR";
+  case tipoPorta::NO: return "NO";
+  case tipoPorta::XO: return "XO";
+  case tipoPorta::NX: return "NX";
+  }
+  return "??";
+}
+
+///######### CLASSE NETLIST #########///
+
+/// ***********************
+/// Inicializacao
+/// ***********************
+
+Netlist::Netlist(): Nin(0), tipo(), fanin_ini(1,0), fanin(), saida(),
+  fanout_ini(1,0), fanout(), comp_ini(1,0), comp(), ciclica(), comp_porta(),
+  realim(), Nniveis(0), nivel() {}
+
+void Netlist::clear()
+{
+  Nin = 0;
+  tipo.clear();
+  fanin_ini.assign(1,0);
+  fanin.clear();
+  saida.clear();
+  fanout_ini.assign(1,0);
+  fanout.clear();
+  comp_ini.assign(1,0);
+  comp.clear();
+  ciclica.clear();
+  comp_porta.clear();
+  realim.clear();
+  Nniveis = 0;
+  nivel.clear();
+}
+
+void Netlist::montar(unsigned NI, const std::vector<tipoPorta>& Tipos,
+                     const std::vector< std::vector<int> >& IdIn, const std::vector<int>& IdOut)
+{
+  clear();
+  Nin = NI;
+  tipo = Tipos;
+  for (unsigned p=0; p<IdIn.size(); p++)
+  {
+    for (unsigned j=0; j<IdIn[p].size(); j++) fanin.push_back(sinal(IdIn[p][j]));
+    fanin_ini.push_back(fanin.size());
+  }
+  for (unsigned j=0; j<IdOut.size(); j++) saida.push_back(sinal(IdOut[j]));
+  calcularFanout();
+  calcularComponentes();
+}
+
+void Netlist::montar(unsigned NI, unsigned NP, const uint8_t* Tipos,
+                     const uint32_t* FaninIni, const uint32_t* Fanin,
+                     unsigned NO, const uint32_t* Saidas)
+{
+  clear();
+  Nin = NI;
+  tipo.resize(NP);
+  for (unsigned p=0; p<NP; p++) tipo[p] = tipoPorta(Tipos[p]);
+  fanin_ini.assign(FaninIni, FaninIni+NP+1);
+  fanin.assign(Fanin, Fanin+FaninIni[NP]);
+  saida.assign(Saidas, Saidas+NO);
+  calcularFanout();
+  calcularComponentes();
+}
+
+void Netlist::garantirPorta(unsigned NI, std::vector<uint8_t>& Tipos,
+                            std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                            std::vector<uint32_t>& Saidas)
+{
+  if (!Tipos.empty() || Saidas.empty()) return;
+  Tipos.push_back(uint8_t(tipoPorta::AN));
+  Fanin.push_back(Saidas[0]);
+  Fanin.push_back(Saidas[0]);
+  FaninIni.push_back(Fanin.size());
+  Saidas[0] = NI;
+}
+
+// Calcula as listas de fanout a partir das listas de fanin (CSR transposto)
+void Netlist::calcularFanout()
+{
+  unsigned NS = getNumSinais();
+  fanout_ini.assign(NS+1, 0);
+  fanout.resize(fanin.size());
+  for (unsigned k=0; k<fanin.size(); k++) fanout_ini[fanin[k]+1]++;
+  for (unsigned s=0; s<NS; s++) fanout_ini[s+1] += fanout_ini[s];
+  vector<unsigned> pos(fanout_ini.begin(), fanout_ini.end()-1);
+  for (unsigned p=0; p<getNumPorts(); p++)
+  {
+    for (unsigned k=fanin_ini[p]; k<fanin_ini[p+1]; k++) fanout[pos[fanin[k]]++] = p;
+  }
+}
+
+// Calcula as componentes fortemente conexas do grafo das portas (uma aresta de p
+// para q se a saida de p alimenta q) pelo algoritmo de Tarjan, em versao
+// iterativa (sem recursao, para nao estourar a pilha em circuitos grandes).
+// O algoritmo completa cada componente depois de todas as que sao alcancaveis a
+// partir dela, ou seja, em ordem topologica inversa.
+void Netlist::calcularComponentes()
+{
+  const unsigned NENHUM = ~0u;
+  unsigned NP = getNumPorts();
+
+  // Caso comum nos arquivos gerados por ferramentas: cada porta soh depende de
+  // entradas do circuito ou de portas anteriores. Nao ha lacos e a propria
+  // numeracao das portas jah eh uma ordem topologica (uma componente por porta)
+  bool ordenada = true;
+  for (unsigned p=0; p<NP && ordenada; p++)
+  {
+    for (unsigned k=fanin_ini[p]; k<fanin_ini[p+1]; k++)
+    {
+      if (fanin[k] >= Nin+p) {ordenada = false; break;}
+    }
+  }
+  if (ordenada)
+  {
+    comp_ini.resize(NP+1);
+    comp.resize(NP);
+    comp_porta.resize(NP);
+    for (unsigned p=0; p<NP; p++) comp_ini[p] = comp[p] = comp_porta[p] = p;
+    comp_ini[NP] = NP;
+    ciclica.assign(NP, 0);
+    realim.clear();
+    calcularNiveis();
+    return;
+  }
+
+  // Ordem de visita e menor ordem alcancavel de cada porta
+  vector<unsigned> indice(NP, NENHUM), menor(NP, 0);
+  vector<uint8_t> na_pilha(NP, 0);
+  // A pilha de portas visitadas cuja componente ainda nao foi completada
+  vector<unsigned> pilha;
+  // A pilha de "chamadas": a porta e a posicao do proximo fanout a examinar
+  vector< pair<unsigned,unsigned> > chamadas;
+  unsigned proximo_indice = 0;
+
+  // As componentes, na ordem em que sao completadas (topologica inversa)
+  vector<unsigned> ordem_inv, ini_inv(1, 0);
+
+  for (unsigned r=0; r<NP; r++)
+  {
+    if (indice[r] != NENHUM) continue;
+    indice[r] = menor[r] = proximo_indice++;
+    pilha.push_back(r);
+    na_pilha[r] = 1;
+    chamadas.push_back(make_pair(r, fanout_ini[Nin+r]));
+    while (!chamadas.empty())
+    {
+      unsigned v = chamadas.back().first;
+      unsigned& k = chamadas.back().second;
+      if (k < fanout_ini[Nin+v+1])
+      {
+        unsigned w = fanout[k++];
+        if (indice[w] == NENHUM)
+        {
+          indice[w] = menor[w] = proximo_indice++;
+          pilha.push_back(w);
+          na_pilha[w] = 1;
+          chamadas.push_back(make_pair(w, fanout_ini[Nin+w]));
+        }
+        else if (na_pilha[w] && indice[w] < menor[v]) menor[v] = indice[w];
+        continue;
+      }
+      // Todos os sucessores de v foram examinados
+      chamadas.pop_back();
+      if (menor[v] == indice[v])
+      {
+        // v eh a raiz de uma componente: as portas acima dele na pilha
+        unsigned w;
+        do
+        {
+          w = pilha.back();
+          pilha.pop_back();
+          na_pilha[w] = 0;
+          ordem_inv.push_back(w);
+        }
+        while (w != v);
+        ini_inv.push_back(ordem_inv.size());
+      }
+      if (!chamadas.empty())
+      {
+        unsigned u = chamadas.back().first;
+        if (menor[v] < menor[u]) menor[u] = menor[v];
+      }
+    }
+  }
+
+  // Inverte a ordem das componentes (fica topologica)
+  unsigned NC = ini_inv.size()-1;
+  comp_ini.assign(1, 0);
+  comp.clear();
+  comp.reserve(NP);
+  ciclica.assign(NC, 0);
+  comp_porta.assign(NP, 0);
+  realim.clear();
+  for (unsigned c=0; c<NC; c++)
+  {
+    unsigned c_inv = NC-1-c;
+    for (unsigned k=ini_inv[c_inv]; k<ini_inv[c_inv+1]; k++)
+    {
+      comp.push_back(ordem_inv[k]);
+      comp_porta[ordem_inv[k]] = c;
+    }
+    comp_ini.push_back(comp.size());
+  }
+
+  // As componentes ciclicas: mais de uma porta, ou uma porta que alimenta a si mesma
+  for (unsigned c=0; c<NC; c++)
+  {
+    unsigned p = comp[comp_ini[c]];
+    bool laco = (comp_ini[c+1]-comp_ini[c] > 1);
+    for (unsigned k=fanin_ini[p]; !laco && k<fanin_ini[p+1]; k++) laco = (fanin[k] == Nin+p);
+    if (laco)
+    {
+      ciclica[c] = 1;
+      for (unsigned k=comp_ini[c]; k<comp_ini[c+1]; k++) realim.push_back(comp[k]);
+    }
+  }
+
+  calcularNiveis();
+}
+
+// Os niveis: uma componente fica um nivel acima da mais alta que a alimenta
+// As componentes jah estao em ordem topologica: basta uma passada
+void Netlist::calcularNiveis()
+{
+  unsigned NC = getNumComponentes();
+  nivel.assign(NC, 0);
+  Nniveis = 0;
+  for (unsigned c=0; c<NC; c++)
+  {
+    for (unsigned k=comp_ini[c]; k<comp_ini[c+1]; k++)
+    {
+      unsigned p = comp[k];
+      for (unsigned i=fanin_ini[p]; i<fanin_ini[p+1]; i++)
+      {
+        if (fanin[i] < Nin) continue;
+        unsigned origem = comp_porta[fanin[i]-Nin];
+        if (origem != c && nivel[origem]+1 > nivel[c]) nivel[c] = nivel[origem]+1;
+      }
+    }
+    if (nivel[c]+1 > Nniveis) Nniveis = nivel[c]+1;
+  }
+}
+
+/// ***********************
+/// CONES
+/// ***********************
+
+void Netlist::marcarCone(const std::vector<unsigned>& Origens, std::vector<uint32_t>& Marca,
+                         uint32_t Rodada) const
+{
+  vector<unsigned> pilha;
+  for (unsigned s : Origens)
+  {
+    if (Marca[s] != Rodada) {Marca[s] = Rodada; pilha.push_back(s);}
+  }
+  while (!pilha.empty())
+  {
+    unsigned s = pilha.back();
+    pilha.pop_back();
+    if (s < Nin) continue;
+    const unsigned p = s-Nin;
+    for (unsigned i=fanin_ini[p]; i<fanin_ini[p+1]; i++)
+    {
+      if (Marca[fanin[i]] != Rodada) {Marca[fanin[i]] = Rodada; pilha.push_back(fanin[i]);}
+    }
+  }
+}
+
+void Netlist::marcarObservaveis(std::vector<uint32_t>& Observavel) const
+{
+  Observavel.assign(getNumSinais(), 0);
+  marcarCone(saida, Observavel, 1);
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+void Netlist::prepararEstado(EstadoNetlist& E, unsigned W) const
+{
+  E.valor.assign(getNumSinais(), bool3S::UNDEF);
+  E.W = W;
+  E.val.assign(getNumSinais()*W, 0);
+  E.def.assign(getNumSinais()*W, 0);
+  E.val_novo.assign(W, 0);
+  E.def_novo.assign(W, 0);
+  E.in_port.clear();
+  E.consistente = false;
+  E.eventos.assign(Nniveis, vector<unsigned>());
+  E.num_eventos = 0;
+  E.agendada.assign(getNumComponentes(), 0);
+  E.antigo.clear();
+  E.avaliadas = 0;
+}
+
+// Funcao auxiliar que calcula a saida de uma porta do tipo T, cujas entradas sao
+// os sinais In[0] a In[N-1], a partir dos valores V de todos os sinais
+// Usa os avaliadores por tabela de bool3S_lut.h, especializados por tipo e
+// numero de entradas
+static inline bool3S avaliarPorta(tipoPorta T, const unsigned* In, unsigned N, const bool3S* V)
+{
+  return lut3S::avaliar(T, V, In, N);
+}
+
+void Netlist::simular(EstadoNetlist& E) const
+{
+  bool3S* V = E.valor.data();
+  unsigned p;
+
+  // Uma unica passada pelas componentes, em ordem topologica
+  E.avaliadas = 0;
+  for (unsigned c=0; c<getNumComponentes(); c++)
+  {
+    if (ciclica[c]) simularComponente(E, c);
+    else
+    {
+      p = comp[comp_ini[c]];
+      V[Nin+p] = avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V);
+      E.avaliadas++;
+    }
+  }
+
+  // Descarta eventos que tenham sido agendados e nao propagados
+  for (unsigned n=0; n<E.eventos.size(); n++)
+  {
+    for (unsigned k=0; k<E.eventos[n].size(); k++) E.agendada[E.eventos[n][k]] = 0;
+    E.eventos[n].clear();
+  }
+  E.num_eventos = 0;
+  E.consistente = true;
+}
+
+// Simula as portas da componente ciclica C: iteracao a partir de UNDEF ateh que
+// nenhuma porta indefinida passe a ter valor definido
+// As entradas da componente que vem de fora dela jah estao calculadas
+void Netlist::simularComponente(EstadoNetlist& E, unsigned C) const
+{
+  bool3S* V = E.valor.data();
+  unsigned p;
+  bool alguma_def;
+
+  for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++) V[Nin+comp[k]] = bool3S::UNDEF;
+  do
+  {
+    alguma_def = false;
+    for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++)
+    {
+      p = comp[k];
+      if (V[Nin+p] != bool3S::UNDEF) continue;
+      V[Nin+p] = avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V);
+      E.avaliadas++;
+      if (V[Nin+p] != bool3S::UNDEF) alguma_def = true;
+    }
+  }
+  while (alguma_def);
+}
+
+void Netlist::simularCiclo(EstadoNetlist& E) const
+{
+  bool3S* V = E.valor.data();
+  unsigned p;
+
+  E.avaliadas = 0;
+  for (unsigned c=0; c<getNumComponentes(); c++)
+  {
+    if (ciclica[c]) simularCicloComponente(E, c);
+    else
+    {
+      p = comp[comp_ini[c]];
+      V[Nin+p] = avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V);
+      E.avaliadas++;
+    }
+  }
+  // Os valores nao sao mais o resultado de uma simulacao combinacional
+  E.consistente = false;
+}
+
+// Simulacao ternaria de Eichelberger, restrita as portas da componente C
+// Como as portas sao monotonas (UNDEF < FALSE,TRUE), a fase A soh leva valores
+// para UNDEF e a fase B soh leva UNDEF para valores definidos: cada fase termina
+// em, no maximo, tantas passadas quanto o numero de portas da componente
+void Netlist::simularCicloComponente(EstadoNetlist& E, unsigned C) const
+{
+  bool3S* V = E.valor.data();
+  unsigned p;
+  bool mudou;
+
+  // Fase A: uma porta cujo valor calculado difere do atual pode estar em transicao
+  do
+  {
+    mudou = false;
+    for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++)
+    {
+      p = comp[k];
+      if (V[Nin+p] == bool3S::UNDEF) continue;
+      E.avaliadas++;
+      if (avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V) != V[Nin+p])
+      {
+        V[Nin+p] = bool3S::UNDEF;
+        mudou = true;
+      }
+    }
+  }
+  while (mudou);
+
+  // Fase B: igual a simularComponente, mas partindo do resultado da fase A
+  do
+  {
+    mudou = false;
+    for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++)
+    {
+      p = comp[k];
+      if (V[Nin+p] != bool3S::UNDEF) continue;
+      V[Nin+p] = avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V);
+      E.avaliadas++;
+      if (V[Nin+p] != bool3S::UNDEF) mudou = true;
+    }
+  }
+  while (mudou);
+}
+
+// Funcao auxiliar que agenda as componentes alimentadas pelo sinal S
+inline void Netlist::agendarFanout(EstadoNetlist& E, unsigned S) const
+{
+  // A componente do proprio sinal (se for saida de porta) nao eh agendada:
+  // uma componente ciclica jah eh resolvida por inteiro
+  unsigned propria = (S >= Nin ? comp_porta[S-Nin] : ~0u);
+  uint8_t* agendada = E.agendada.data();
+  unsigned n = 0;
+  for (unsigned k=fanout_ini[S]; k<fanout_ini[S+1]; k++)
+  {
+    unsigned c = comp_porta[fanout[k]];
+    if (c != propria && !agendada[c])
+    {
+      agendada[c] = 1;
+      E.eventos[nivel[c]].push_back(c);
+      n++;
+    }
+  }
+  E.num_eventos += n;
+}
+
+void Netlist::alterarEntrada(EstadoNetlist& E, unsigned I, bool3S V) const
+{
+  if (E.valor[I] == V) return;
+  E.valor[I] = V;
+  agendarFanout(E, I);
+}
+
+void Netlist::propagar(EstadoNetlist& E) const
+{
+  bool3S* V = E.valor.data();
+  E.avaliadas = 0;
+
+  // As componentes de um nivel soh alimentam componentes de niveis maiores:
+  // basta percorrer os niveis em ordem crescente, ateh acabarem os eventos
+  for (unsigned n=0; n<E.eventos.size() && E.num_eventos>0; n++)
+  {
+    vector<unsigned>& lista = E.eventos[n];
+    for (unsigned k=0; k<lista.size(); k++)
+    {
+      unsigned c = lista[k];
+      E.agendada[c] = 0;
+      E.num_eventos--;
+      if (!ciclica[c])
+      {
+        unsigned p = comp[comp_ini[c]];
+        bool3S novo = avaliarPorta(tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p], V);
+        E.avaliadas++;
+        if (novo != V[Nin+p])
+        {
+          V[Nin+p] = novo;
+          agendarFanout(E, Nin+p);
+        }
+        continue;
+      }
+      // Componente ciclica: resolve de novo e propaga as portas que mudaram
+      E.antigo.clear();
+      for (unsigned i=comp_ini[c]; i<comp_ini[c+1]; i++) E.antigo.push_back(V[Nin+comp[i]]);
+      simularComponente(E, c);
+      for (unsigned i=comp_ini[c]; i<comp_ini[c+1]; i++)
+      {
+        unsigned p = comp[i];
+        if (V[Nin+p] != E.antigo[i-comp_ini[c]]) agendarFanout(E, Nin+p);
+      }
+    }
+    lista.clear();
+  }
+}
+
+// Funcao auxiliar que avalia uma porta do tipo T sobre um bloco, com o kernel K,
+// armazenando o resultado nos planos Val e Def
+static inline void avaliarBloco(const Kernel3S& K, tipoPorta T, const unsigned* In, unsigned N,
+                                EstadoNetlist& E, uint64_t* Val, uint64_t* Def)
+{
+  unsigned W = E.W;
+  E.in_port.resize(N);
+  for (unsigned i=0; i<N; i++)
+  {
+    E.in_port[i].val = &E.val[In[i]*W];
+    E.in_port[i].def = &E.def[In[i]*W];
+  }
+  switch (T)
+  {
+  case tipoPorta::NT: K.portaAND(E.in_port.data(), N, true, Val, Def, W); break;
+  case tipoPorta::AN: K.portaAND(E.in_port.data(), N, false, Val, Def, W); break;
+  case tipoPorta::NA: K.portaAND(E.in_port.data(), N, true, Val, Def, W); break;
+  case tipoPorta::OR: K.portaOR(E.in_port.data(), N, false, Val, Def, W); break;
+  case tipoPorta::NO: K.portaOR(E.in_port.data(), N, true, Val, Def, W); break;
+  case tipoPorta::XO: K.portaXOR(E.in_port.data(), N, false, Val, Def, W); break;
+  case tipoPorta::NX: K.portaXOR(E.in_port.data(), N, true, Val, Def, W); break;
+  }
+}
+
+void Netlist::simularBloco(EstadoNetlist& E) const
+{
+  const Kernel3S& K = kernel3S();
+  unsigned W = E.W;
+  unsigned p, s;
+
+  // Uma unica passada pelas componentes, em ordem topologica
+  for (unsigned c=0; c<getNumComponentes(); c++)
+  {
+    if (ciclica[c])
+    {
+      simularBlocoComponente(E, c);
+      continue;
+    }
+    p = comp[comp_ini[c]];
+    s = Nin+p;
+    avaliarBloco(K, tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p],
+                 E, &E.val[s*W], &E.def[s*W]);
+  }
+}
+
+// Simula em bloco as portas da componente ciclica C: em cada posicao do bloco,
+// um valor que jah foi definido nao muda mais
+void Netlist::simularBlocoComponente(EstadoNetlist& E, unsigned C) const
+{
+  const Kernel3S& K = kernel3S();
+  unsigned W = E.W;
+  unsigned p, s;
+  bool mudou;
+
+  for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++)
+  {
+    s = Nin+comp[k];
+    for (unsigned w=0; w<W; w++) E.val[s*W+w] = E.def[s*W+w] = 0;
+  }
+  do
+  {
+    mudou = false;
+    for (unsigned k=comp_ini[C]; k<comp_ini[C+1]; k++)
+    {
+      p = comp[k];
+      s = Nin+p;
+      avaliarBloco(K, tipo[p], &fanin[fanin_ini[p]], fanin_ini[p+1]-fanin_ini[p],
+                   E, E.val_novo.data(), E.def_novo.data());
+      for (unsigned w=0; w<W; w++)
+      {
+        uint64_t novos_def = E.def_novo[w] & ~E.def[s*W+w];
+        if (novos_def != 0)
+        {
+          E.val[s*W+w] |= E.val_novo[w] & novos_def;
+          E.def[s*W+w] |= novos_def;
+          mudou = true;
+        }
+      }
+    }
+  }
+  while (mudou);
+}
+
+void Netlist::simularBlocoBooleano(EstadoNetlist& E) const
+{
+  const unsigned W = E.W;
+  uint64_t* V = E.val.data();
+
+  // Sem lacos, cada componente tem uma unica porta
+  for (unsigned c=0; c<getNumComponentes(); c++)
+  {
+    unsigned q = comp[comp_ini[c]];
+    const unsigned* in = &fanin[fanin_ini[q]];
+    const unsigned N = fanin_ini[q+1]-fanin_ini[q];
+    uint64_t* out = &V[(Nin+q)*W];
+    const uint64_t* a = &V[in[0]*W];
+    for (unsigned w=0; w<W; w++) out[w] = a[w];
+    switch (tipo[q])
+    {
+    case tipoPorta::NT:
+    case tipoPorta::AN:
+    case tipoPorta::NA:
+      for (unsigned i=1; i<N; i++)
+      {
+        const uint64_t* b = &V[in[i]*W];
+        for (unsigned w=0; w<W; w++) out[w] &= b[w];
+      }
+      break;
+    case tipoPorta::OR:
+    case tipoPorta::NO:
+      for (unsigned i=1; i<N; i++)
+      {
+        const uint64_t* b = &V[in[i]*W];
+        for (unsigned w=0; w<W; w++) out[w] |= b[w];
+      }
+      break;
+    case tipoPorta::XO:
+    case tipoPorta::NX:
+      for (unsigned i=1; i<N; i++)
+      {
+        const uint64_t* b = &V[in[i]*W];
+        for (unsigned w=0; w<W; w++) out[w] ^= b[w];
+      }
+      break;
+    }
+    if (tipo[q]==tipoPorta::NT || tipo[q]==tipoPorta::NA ||
+        tipo[q]==tipoPorta::NO || tipo[q]==tipoPorta::NX)
+    {
+      for (unsigned w=0; w<W; w++) out[w] = ~out[w];
+    }
+  }
+}
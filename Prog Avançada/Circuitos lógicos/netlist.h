@@ -0,0 +1,280 @@
+#ifndef _NETLIST_H_
+#define _NETLIST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_lut.h"
+#include "kernel3S.h"
+
+/// ###########################################################################
+/// A NETLIST COMPILADA
+/// Representacao "achatada" de um circuito, usada no laco de simulacao:
+/// nenhuma chamada virtual, nenhum ponteiro por porta e nenhuma alocacao
+/// durante a simulacao de uma combinacao de entrada.
+///
+/// Os sinais sao numerados de forma contigua:
+/// - sinal 0 a Nin-1: entradas do circuito (id -1 a -Nin)
+/// - sinal Nin a Nin+Nports-1: saidas das portas (id 1 a Nports)
+/// As portas sao numeradas de 0 a Nports-1 (IdPort-1)
+/// ###########################################################################
+
+// Os tipos de porta (tipoPorta) estao definidos em bool3S_lut.h
+
+// Converte uma sigla de porta (NT, AN, NA, OR, NO, XO, NX) para o tipoPorta correspondente
+// Retorna false (e nao altera T) se a sigla for invalida
+bool toTipoPorta(const std::string& Nome, tipoPorta& T);
+
+// Retorna a sigla (NT, AN, etc.) correspondente a um tipoPorta
+std::string toString(tipoPorta T);
+
+// Espalhamento de uma lista de N sinais ou literais (para os hashes estruturais),
+// a partir do valor Inicio (ex.: o tipo da porta)
+inline uint64_t espalharSinais(const uint32_t* In, size_t N, uint64_t Inicio=0)
+{
+  uint64_t h = 0x9E3779B97F4A7C15ull ^ Inicio;
+  for (size_t j=0; j<N; j++)
+  {
+    h ^= In[j];
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 32;
+  }
+  return h;
+}
+
+// O estado de simulacao de uma netlist: os valores de todos os sinais
+// A netlist nao eh alterada durante a simulacao; cada thread que simula a mesma
+// netlist deve ter o seu proprio estado
+struct EstadoNetlist {
+  // Simulacao escalar: um bool3S por sinal
+  std::vector<bool3S> valor;
+  // Simulacao em bloco: W palavras de 64 bits por sinal em cada plano
+  // O bit K da palavra w do sinal s estah em val[s*W+w] e def[s*W+w]
+  unsigned W;
+  std::vector<uint64_t> val, def;
+  // Auxiliares da simulacao em bloco
+  std::vector<uint64_t> val_novo, def_novo;
+  std::vector<bloco3S> in_port;
+
+  // Simulacao por eventos (incremental)
+  // true se valor contem o resultado completo da ultima simulacao escalar
+  bool consistente;
+  // As componentes (ver Netlist) agendadas para reavaliacao, separadas por nivel
+  std::vector< std::vector<unsigned> > eventos;
+  // Numero total de componentes agendadas
+  unsigned num_eventos;
+  // agendada[c] != 0 se a componente c jah estah agendada
+  std::vector<uint8_t> agendada;
+  // Os valores anteriores das portas de uma componente com realimentacao
+  // que estah sendo reavaliada
+  std::vector<bool3S> antigo;
+  // Numero de avaliacoes de porta feitas na ultima simulacao escalar
+  unsigned long avaliadas;
+
+  EstadoNetlist(): valor(), W(0), val(), def(), val_novo(), def_novo(), in_port(),
+    consistente(false), eventos(), num_eventos(0), agendada(), antigo(), avaliadas(0) {}
+};
+
+class Netlist {
+private:
+  // Numero de entradas do circuito
+  unsigned Nin;
+
+  // O tipo de cada porta
+  std::vector<tipoPorta> tipo;
+  // As entradas das portas em formato CSR: as entradas da porta p sao os sinais
+  // fanin[fanin_ini[p]] a fanin[fanin_ini[p+1]-1]
+  std::vector<unsigned> fanin_ini;  // dimensao Nports+1
+  std::vector<unsigned> fanin;
+  // Os sinais que sao as saidas do circuito
+  std::vector<unsigned> saida;
+  // As portas alimentadas por cada sinal (fanout), em formato CSR: as portas
+  // alimentadas pelo sinal s sao fanout[fanout_ini[s]] a fanout[fanout_ini[s+1]-1]
+  std::vector<unsigned> fanout_ini;  // dimensao Nin+Nports+1
+  std::vector<unsigned> fanout;
+
+  // A ordem de simulacao
+  // O grafo das portas eh dividido em componentes fortemente conexas (SCC), em
+  // ordem topologica: as entradas das portas de uma componente vem das entradas
+  // do circuito, da propria componente ou de componentes anteriores.
+  // Uma componente eh ciclica (tem realimentacao) se tiver mais de uma porta ou
+  // se a sua unica porta alimentar a si mesma; as demais sao avaliadas uma soh vez.
+  // As portas da componente c sao comp[comp_ini[c]] a comp[comp_ini[c+1]-1]
+  std::vector<unsigned> comp_ini;  // dimensao Ncomp+1
+  std::vector<unsigned> comp;
+  // ciclica[c] != 0 se a componente c tem realimentacao
+  std::vector<uint8_t> ciclica;
+  // A componente de cada porta
+  std::vector<unsigned> comp_porta;
+  // As portas que estao em componentes ciclicas (em lacos de realimentacao)
+  std::vector<unsigned> realim;
+  // O numero de niveis da ordem de simulacao (profundidade do grafo de componentes)
+  unsigned Nniveis;
+  // O nivel de cada componente (de 0 a Nniveis-1): uma componente soh depende
+  // de componentes de niveis menores
+  std::vector<unsigned> nivel;
+
+  // Calcula as listas de fanout (fanout_ini e fanout)
+  void calcularFanout();
+  // Calcula as componentes fortemente conexas (algoritmo de Tarjan) e os niveis
+  // (comp_ini, comp, ciclica, comp_porta, realim, Nniveis e nivel)
+  void calcularComponentes();
+  // Calcula os niveis das componentes (Nniveis e nivel), depois de calcularComponentes
+  void calcularNiveis();
+
+  // Simula as portas da componente ciclica C: parte de UNDEF e itera ateh que
+  // nenhuma porta indefinida passe a ter valor definido (usada por simular e propagar)
+  void simularComponente(EstadoNetlist& E, unsigned C) const;
+  // Simula as portas da componente ciclica C a partir dos valores atuais (estado
+  // do ciclo anterior), pela simulacao ternaria em duas fases (usada por simularCiclo)
+  void simularCicloComponente(EstadoNetlist& E, unsigned C) const;
+  // Simula em bloco as portas da componente ciclica C (usada por simularBloco)
+  void simularBlocoComponente(EstadoNetlist& E, unsigned C) const;
+  // Agenda as componentes alimentadas pelo sinal S, exceto a propria componente
+  // de S (usada por alterarEntrada e propagar)
+  void agendarFanout(EstadoNetlist& E, unsigned S) const;
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  // Cria uma netlist vazia
+  Netlist();
+
+  // Limpa todo o conteudo da netlist
+  void clear();
+
+  // Monta a netlist a partir dos dados de um circuito, usando a convencao de ids
+  // da classe Circuito (entradas do circuito com id negativa, portas com id positiva)
+  // Tipos[p] e IdIn[p] sao o tipo e as ids de origem das entradas da porta p (IdPort-1);
+  // IdOut[j] eh a id de origem da saida j (IdOutput-1)
+  // Todas as ids devem ser validas (o circuito deve ter sido testado com valid)
+  // Depois de montar, calcula a ordem de simulacao
+  void montar(unsigned NI, const std::vector<tipoPorta>& Tipos,
+              const std::vector< std::vector<int> >& IdIn, const std::vector<int>& IdOut);
+
+  // Monta a netlist diretamente a partir das secoes do formato binario (ver
+  // netlistbin.h): NP portas com os tipos Tipos, as entradas em formato CSR
+  // (FaninIni e Fanin) e os sinais das NO saidas. As secoes sao copiadas em bloco,
+  // sem nenhuma conversao; os dados devem ter sido conferidos (NetlistBinaria::abrir)
+  // Depois de montar, calcula a ordem de simulacao
+  void montar(unsigned NI, unsigned NP, const uint8_t* Tipos,
+              const uint32_t* FaninIni, const uint32_t* Fanin,
+              unsigned NO, const uint32_t* Saidas);
+
+  // Garante que uma netlist em formato CSR (como em montar), com NI entradas, tem
+  // ao menos uma porta: se todas as saidas vem diretamente de entradas, cria a
+  // porta AN(x,x) = x para a primeira saida
+  static void garantirPorta(unsigned NI, std::vector<uint8_t>& Tipos,
+                            std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                            std::vector<uint32_t>& Saidas);
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumPorts() const {return tipo.size();}
+  unsigned getNumOutputs() const {return saida.size();}
+  unsigned getNumSinais() const {return Nin+tipo.size();}
+  unsigned getNumNiveis() const {return Nniveis;}
+  unsigned getNumComponentes() const {return ciclica.size();}
+
+  // Converte uma id (convencao de Circuito) para o indice do sinal correspondente
+  unsigned sinal(int Id) const {return (Id<0 ? -Id-1 : Nin+Id-1);}
+
+  // Caracteristicas da porta P (de 0 a Nports-1)
+  tipoPorta getTipo(unsigned P) const {return tipo[P];}
+  unsigned getNumFanin(unsigned P) const {return fanin_ini[P+1]-fanin_ini[P];}
+  const unsigned* getFanin(unsigned P) const {return &fanin[fanin_ini[P]];}
+  unsigned getNivel(unsigned P) const {return nivel[comp_porta[P]];}
+  unsigned getComponente(unsigned P) const {return comp_porta[P];}
+
+  // As portas alimentadas pelo sinal S
+  unsigned getNumFanout(unsigned S) const {return fanout_ini[S+1]-fanout_ini[S];}
+  const unsigned* getFanout(unsigned S) const {return &fanout[fanout_ini[S]];}
+
+  // O sinal da saida J (de 0 a Nout-1)
+  unsigned getSaida(unsigned J) const {return saida[J];}
+
+  // As componentes fortemente conexas, em ordem topologica (C de 0 a Ncomp-1)
+  unsigned getTamanhoComponente(unsigned C) const {return comp_ini[C+1]-comp_ini[C];}
+  const unsigned* getPortasComponente(unsigned C) const {return &comp[comp_ini[C]];}
+  bool getCiclica(unsigned C) const {return ciclica[C] != 0;}
+  // As portas em componentes ciclicas
+  const std::vector<unsigned>& getRealim() const {return realim;}
+
+  // Marca com Rodada (Marca[s] = Rodada) os sinais do cone de fanin dos sinais
+  // Origens, inclusive eles: os sinais dos quais algum sinal de Origens depende
+  // Marca deve ter getNumSinais() elementos; os sinais jah marcados com Rodada nao
+  // sao percorridos de novo (varias chamadas na mesma rodada acumulam os cones)
+  void marcarCone(const std::vector<unsigned>& Origens, std::vector<uint32_t>& Marca,
+                  uint32_t Rodada) const;
+  // Faz Observavel[s] = 1 para os sinais que alcancam alguma saida do circuito
+  // (o cone de fanin das saidas) e 0 para os demais
+  void marcarObservaveis(std::vector<uint32_t>& Observavel) const;
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Dimensiona o estado para a simulacao escalar e para a simulacao em blocos de
+  // W palavras. Deve ser chamada antes de simular ou simularBloco, e de novo
+  // se a netlist for alterada
+  void prepararEstado(EstadoNetlist& E, unsigned W=1) const;
+
+  // Simulacao escalar
+  // Os valores das entradas do circuito devem estar em E.valor[0] a E.valor[Nin-1]
+  // Calcula os valores de todas as portas (E.valor[Nin] em diante), componente por
+  // componente: as aciclicas com uma unica avaliacao; as ciclicas por iteracao
+  void simular(EstadoNetlist& E) const;
+
+  // Simulacao por eventos (incremental)
+  // Parte do resultado da simulacao anterior (E.consistente deve ser true) e
+  // reavalia somente as portas afetadas pelas entradas que mudaram.
+  // Uso: chamar alterarEntrada para cada entrada que muda e depois propagar.
+
+  // Fixa o valor da entrada I do circuito (de 0 a Nin-1) em E.valor[I]; se o valor
+  // mudou, agenda as portas alimentadas por essa entrada
+  void alterarEntrada(EstadoNetlist& E, unsigned I, bool3S V) const;
+
+  // Reavalia as componentes agendadas, nivel por nivel. Quando a saida de uma porta
+  // muda, agenda as componentes alimentadas por ela; se nao muda, a propagacao
+  // para ali. Uma componente ciclica atingida eh simulada de novo por inteiro
+  // (iteracao a partir de UNDEF, soh dentro da componente)
+  // O resultado eh igual ao de simular com os novos valores das entradas
+  void propagar(EstadoNetlist& E) const;
+
+  // Simulacao sequencial (um ciclo de relogio)
+  // Os lacos de realimentacao funcionam como elementos de memoria: os valores das
+  // portas que estao em E.valor (o resultado do ciclo anterior) sao o estado
+  // inicial do ciclo. Os valores das entradas do circuito devem estar em
+  // E.valor[0] a E.valor[Nin-1]. As componentes aciclicas sao avaliadas uma vez;
+  // as ciclicas pela simulacao ternaria de Eichelberger:
+  // - fase A: as portas cujo valor mudaria passam a UNDEF, ateh estabilizar
+  // - fase B: as portas UNDEF recebem o valor calculado, ateh estabilizar
+  // Um laco cujo valor nao depende do estado (ex.: latch sendo escrito) assume o
+  // novo valor; um laco que apenas guarda o estado (ex.: latch em repouso) o mantem;
+  // uma disputa (ex.: oscilador) resulta em UNDEF.
+  // Com todas as portas UNDEF (estado apos prepararEstado), o resultado eh o mesmo
+  // de simular. Nao faz nenhuma alocacao
+  void simularCiclo(EstadoNetlist& E) const;
+
+  // Simulacao em bloco (64*E.W combinacoes de entrada)
+  // Os planos das entradas do circuito devem estar nas primeiras Nin*E.W palavras
+  // de E.val e E.def. Calcula os planos de todas as portas, usando kernel3S
+  void simularBloco(EstadoNetlist& E) const;
+
+  // Simulacao booleana em bloco (64*E.W combinacoes de entrada, todas definidas)
+  // Somente o plano val eh usado: os planos das entradas devem estar nas primeiras
+  // Nin*E.W palavras de E.val; os de def nao sao lidos nem escritos. Cada porta eh
+  // um laco de operacoes bit a bit (&, |, ^ e ~), sem o plano def dos kernels de 3 estados
+  // Soh vale para netlists sem lacos de realimentacao (getRealim() vazio): um laco
+  // pode ficar UNDEF mesmo com todas as entradas definidas
+  void simularBlocoBooleano(EstadoNetlist& E) const;
+};
+
+#endif // _NETLIST_H_
@@ -0,0 +1,259 @@
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "netlistbin.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// A assinatura do formato e o tamanho do cabecalho
+static const char ASSINATURA[8] = {'N','E','T','L','I','S','T','3'};
+static const size_t TAM_CABECALHO = 32;
+
+// Arredonda um tamanho de secao para o proximo multiplo de 8 bytes
+static inline uint64_t alinhar8(uint64_t N) {return (N+7)/8*8;}
+
+// Retorna true se a maquina eh little-endian (as secoes sao usadas diretamente)
+static inline bool littleEndian()
+{
+  const uint16_t x = 1;
+  return *reinterpret_cast<const uint8_t*>(&x) == 1;
+}
+
+// Leh um inteiro sem sinal de NBytes bytes em little-endian
+static uint64_t lerInteiro(const unsigned char* P, unsigned NBytes)
+{
+  uint64_t X = 0;
+  for (unsigned k=NBytes; k>0; k--) X = (X << 8) | P[k-1];
+  return X;
+}
+
+// Grava um inteiro sem sinal de NBytes bytes em little-endian
+static void gravarInteiro(ostream& O, uint64_t X, unsigned NBytes)
+{
+  for (unsigned k=0; k<NBytes; k++)
+  {
+    O.put(char(X & 0xFF));
+    X >>= 8;
+  }
+}
+
+// Grava um vetor de uint32 em little-endian, seguido dos bytes que completam
+// a secao ateh um multiplo de 8 bytes
+static void gravarSecao(ostream& O, const vector<uint32_t>& V)
+{
+  if (littleEndian()) O.write(reinterpret_cast<const char*>(V.data()), V.size()*4);
+  else for (size_t k=0; k<V.size(); k++) gravarInteiro(O, V[k], 4);
+  for (uint64_t k=V.size()*4; k<alinhar8(V.size()*4); k++) O.put('\0');
+}
+
+///######### CLASSE ARQUIVOMAPEADO #########///
+
+#ifdef _WIN32
+ArquivoMapeado::ArquivoMapeado(): dados(nullptr), tamanho(0),
+  arquivo(INVALID_HANDLE_VALUE), mapeamento(nullptr) {}
+#else
+ArquivoMapeado::ArquivoMapeado(): dados(nullptr), tamanho(0) {}
+#endif
+
+ArquivoMapeado::~ArquivoMapeado()
+{
+  fechar();
+}
+
+#ifdef _WIN32
+
+bool ArquivoMapeado::abrir(const string& arq)
+{
+  fechar();
+  arquivo = CreateFileA(arq.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (arquivo == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER tam;
+  if (!GetFileSizeEx(arquivo, &tam) || tam.QuadPart <= 0)
+  {
+    fechar();
+    return false;
+  }
+  mapeamento = CreateFileMappingA(arquivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapeamento == nullptr)
+  {
+    fechar();
+    return false;
+  }
+  dados = static_cast<const unsigned char*>(MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0));
+  if (dados == nullptr)
+  {
+    fechar();
+    return false;
+  }
+  tamanho = size_t(tam.QuadPart);
+  return true;
+}
+
+void ArquivoMapeado::fechar()
+{
+  if (dados != nullptr) UnmapViewOfFile(dados);
+  if (mapeamento != nullptr) CloseHandle(mapeamento);
+  if (arquivo != INVALID_HANDLE_VALUE) CloseHandle(arquivo);
+  dados = nullptr;
+  tamanho = 0;
+  mapeamento = nullptr;
+  arquivo = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool ArquivoMapeado::abrir(const string& arq)
+{
+  fechar();
+  int fd = open(arq.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // O mapeamento continua valido depois de fechar o descritor
+  close(fd);
+  if (p == MAP_FAILED) return false;
+  dados = static_cast<const unsigned char*>(p);
+  tamanho = size_t(st.st_size);
+  return true;
+}
+
+void ArquivoMapeado::fechar()
+{
+  if (dados != nullptr) munmap(const_cast<unsigned char*>(dados), tamanho);
+  dados = nullptr;
+  tamanho = 0;
+}
+
+#endif
+
+///######### CLASSE NETLISTBINARIA #########///
+
+NetlistBinaria::NetlistBinaria(): arquivo(), Nin(0), Nports(0), Nout(0), Nfanin(0),
+  tipo(nullptr), fanin_ini(nullptr), fanin(nullptr), saida(nullptr) {}
+
+void NetlistBinaria::fechar()
+{
+  arquivo.fechar();
+  Nin = Nports = Nout = 0;
+  Nfanin = 0;
+  tipo = nullptr;
+  fanin_ini = fanin = saida = nullptr;
+}
+
+bool NetlistBinaria::abrir(const string& arq)
+{
+  fechar();
+  try
+  {
+    if (!littleEndian()) throw 1;
+    if (!arquivo.abrir(arq)) throw 2;
+    const unsigned char* D = arquivo.getDados();
+    uint64_t tam = arquivo.getTamanho();
+
+    ///CABECALHO
+    if (tam < TAM_CABECALHO || memcmp(D, ASSINATURA, 8) != 0) throw 3;
+    if (lerInteiro(D+8, 4) != VERSAO_NETLIST_BINARIA) throw 4;
+    Nin = uint32_t(lerInteiro(D+12, 4));
+    Nports = uint32_t(lerInteiro(D+16, 4));
+    Nout = uint32_t(lerInteiro(D+20, 4));
+    Nfanin = lerInteiro(D+24, 8);
+    // Mesmas restricoes do formato texto (Circuito::valid)
+    if (Nin == 0 || Nports == 0 || Nout == 0) throw 5;
+    // Os sinais e as posicoes de fanin devem caber em 32 bits
+    uint64_t NS = uint64_t(Nin) + Nports;
+    if (NS > 0xFFFFFFFFULL || Nfanin > 0xFFFFFFFFULL) throw 5;
+
+    ///SECOES
+    uint64_t pos_tipo = TAM_CABECALHO;
+    uint64_t pos_ini = pos_tipo + alinhar8(Nports);
+    uint64_t pos_fanin = pos_ini + alinhar8(4*(uint64_t(Nports)+1));
+    uint64_t pos_saida = pos_fanin + alinhar8(4*Nfanin);
+    uint64_t fim = pos_saida + alinhar8(4*uint64_t(Nout));
+    if (tam < fim) throw 6;
+    tipo = D + pos_tipo;
+    fanin_ini = reinterpret_cast<const uint32_t*>(D + pos_ini);
+    fanin = reinterpret_cast<const uint32_t*>(D + pos_fanin);
+    saida = reinterpret_cast<const uint32_t*>(D + pos_saida);
+
+    ///CONFERE AS PORTAS
+    if (fanin_ini[0] != 0 || fanin_ini[Nports] != Nfanin) throw 7;
+    for (uint32_t p=0; p<Nports; p++)
+    {
+      if (tipo[p] > uint8_t(tipoPorta::NX)) throw 8;
+      if (fanin_ini[p+1] < fanin_ini[p]) throw 9;
+      uint32_t n = fanin_ini[p+1]-fanin_ini[p];
+      if (tipoPorta(tipo[p]) == tipoPorta::NT ? n != 1 : n < 2) throw 9;
+    }
+    for (uint64_t k=0; k<Nfanin; k++) if (fanin[k] >= NS) throw 10;
+
+    ///CONFERE AS SAIDAS
+    for (uint32_t j=0; j<Nout; j++) if (saida[j] >= NS) throw 11;
+  }
+  catch (int i)
+  {
+    //ERRO DE LEITURA
+    fechar();
+    return false;
+  }
+  return true;
+}
+
+/// ***********************
+/// Funcoes auxiliares
+/// ***********************
+
+bool ehNetlistBinaria(const string& arq)
+{
+  ifstream I(arq.c_str(), ios::in|ios::binary);
+  char assinatura[8];
+  if (!I.read(assinatura, 8)) return false;
+  return memcmp(assinatura, ASSINATURA, 8) == 0;
+}
+
+bool salvarNetlistBinaria(const Netlist& N, ostream& O)
+{
+  unsigned NP = N.getNumPorts();
+
+  // As secoes sao montadas na memoria e gravadas de uma vez
+  vector<uint32_t> ini(NP+1), fanin, saida(N.getNumOutputs());
+  string tipos(alinhar8(NP), '\0');
+  ini[0] = 0;
+  for (unsigned p=0; p<NP; p++)
+  {
+    tipos[p] = char(N.getTipo(p));
+    const unsigned* In = N.getFanin(p);
+    fanin.insert(fanin.end(), In, In+N.getNumFanin(p));
+    ini[p+1] = fanin.size();
+  }
+  for (unsigned j=0; j<N.getNumOutputs(); j++) saida[j] = N.getSaida(j);
+
+  ///CABECALHO
+  O.write(ASSINATURA, 8);
+  gravarInteiro(O, VERSAO_NETLIST_BINARIA, 4);
+  gravarInteiro(O, N.getNumInputs(), 4);
+  gravarInteiro(O, NP, 4);
+  gravarInteiro(O, N.getNumOutputs(), 4);
+  gravarInteiro(O, fanin.size(), 8);
+
+  ///SECOES
+  O.write(tipos.data(), tipos.size());
+  gravarSecao(O, ini);
+  gravarSecao(O, fanin);
+  gravarSecao(O, saida);
+  return O.good();
+}
@@ -0,0 +1,107 @@
+#ifndef _NETLISTBIN_H_
+#define _NETLISTBIN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "netlist.h"
+
+/// ###########################################################################
+/// FORMATO BINARIO DA NETLIST (versao 1)
+/// Alternativa ao formato texto (CIRCUITO/PORTAS/SAIDAS) para circuitos muito
+/// grandes: o arquivo eh mapeado em memoria (mmap) e as secoes sao usadas
+/// diretamente, sem nenhuma conversao de texto.
+///
+/// Todos os inteiros estao em little-endian. Os sinais sao numerados como na
+/// Netlist: 0 a Nin-1 sao as entradas do circuito e Nin+p eh a saida da porta p
+/// (p de 0 a Nports-1).
+///
+///   Cabecalho (32 bytes):
+///     8 bytes: "NETLIST3"
+///     uint32:  versao do formato (VERSAO_NETLIST_BINARIA)
+///     uint32:  Nin, numero de entradas do circuito
+///     uint32:  Nports, numero de portas
+///     uint32:  Nout, numero de saidas do circuito
+///     uint64:  Nfanin, numero total de entradas de portas
+///   Secoes, cada uma comecando em um multiplo de 8 bytes (completadas com 0):
+///     tipo:      Nports x uint8   (tipoPorta: 0=NT 1=AN 2=NA 3=OR 4=NO 5=XO 6=NX)
+///     fanin_ini: (Nports+1) x uint32: as entradas da porta p sao
+///                fanin[fanin_ini[p]] a fanin[fanin_ini[p+1]-1]
+///     fanin:     Nfanin x uint32  (sinais)
+///     saida:     Nout x uint32    (sinais)
+/// ###########################################################################
+
+// A versao atual do formato binario
+const uint32_t VERSAO_NETLIST_BINARIA = 1;
+
+// Um arquivo mapeado em memoria, somente para leitura (POSIX ou Windows)
+// Nao pode ser copiado; o mapeamento eh desfeito no destrutor
+class ArquivoMapeado {
+private:
+  const unsigned char* dados;
+  size_t tamanho;
+#ifdef _WIN32
+  void* arquivo;
+  void* mapeamento;
+#endif
+
+  ArquivoMapeado(const ArquivoMapeado&);
+  void operator=(const ArquivoMapeado&);
+
+public:
+  ArquivoMapeado();
+  ~ArquivoMapeado();
+
+  // Mapeia o arquivo arq (desfazendo um mapeamento anterior)
+  // Retorna false se o arquivo nao puder ser aberto ou mapeado, ou se for vazio
+  bool abrir(const std::string& arq);
+  // Desfaz o mapeamento
+  void fechar();
+
+  const unsigned char* getDados() const {return dados;}
+  size_t getTamanho() const {return tamanho;}
+};
+
+// Uma netlist no formato binario, mapeada em memoria
+// As secoes sao acessadas diretamente no arquivo mapeado (sem copia)
+class NetlistBinaria {
+private:
+  ArquivoMapeado arquivo;
+  uint32_t Nin, Nports, Nout;
+  uint64_t Nfanin;
+  const uint8_t* tipo;
+  const uint32_t* fanin_ini;
+  const uint32_t* fanin;
+  const uint32_t* saida;
+
+public:
+  NetlistBinaria();
+
+  // Mapeia e confere o arquivo arq: cabecalho, versao, tamanho das secoes,
+  // tipos de porta, numero de entradas de cada porta (1 para NT, 2 ou mais para
+  // as demais) e sinais (todos devem existir)
+  // Retorna false se houver algum erro (ou se a maquina nao for little-endian)
+  bool abrir(const std::string& arq);
+  void fechar();
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumPorts() const {return Nports;}
+  unsigned getNumOutputs() const {return Nout;}
+  unsigned long long getNumFanin() const {return Nfanin;}
+
+  // As secoes, como descritas acima
+  const uint8_t* getTipos() const {return tipo;}
+  const uint32_t* getFaninIni() const {return fanin_ini;}
+  const uint32_t* getFanin() const {return fanin;}
+  const uint32_t* getSaidas() const {return saida;}
+};
+
+// Retorna true se o arquivo arq comeca com a assinatura do formato binario
+bool ehNetlistBinaria(const std::string& arq);
+
+// Grava a netlist N no formato binario
+// Retorna false se houver erro de gravacao
+bool salvarNetlistBinaria(const Netlist& N, std::ostream& O);
+
+#endif // _NETLISTBIN_H_
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include "otimizacao.h"
+
+using namespace std;
+
+/// ***********************
+/// Relatorio
+/// ***********************
+
+void RelatorioOtimizacao::clear()
+{
+  NportsAntes = NportsDepois = 0;
+  mortas = simplificadas = fundidas = 0;
+  alteradas = entradasRemovidas = 0;
+  removidas.clear();
+  novaId.clear();
+}
+
+std::ostream& RelatorioOtimizacao::imprimir(std::ostream& O, bool Lista) const
+{
+  O << "Portas: " << NportsAntes << " -> " << NportsDepois << '\n';
+  O << "Removidas: " << removidas.size() << " (mortas: " << mortas
+    << ", simplificadas: " << simplificadas << ", fundidas: " << fundidas << ")\n";
+  O << "Alteradas: " << alteradas << " (entradas eliminadas: " << entradasRemovidas << ")\n";
+  for (unsigned k=0; Lista && k<removidas.size(); k++)
+  {
+    const PortaRemovida& P = removidas[k];
+    O << "Porta " << P.IdPort << ": ";
+    switch (P.Motivo)
+    {
+    case motivoRemocao::MORTA: O << "morta"; break;
+    case motivoRemocao::SIMPLIFICADA: O << "simplificada -> " << P.IdOrig; break;
+    case motivoRemocao::FUNDIDA: O << "fundida -> " << P.IdOrig; break;
+    }
+    O << '\n';
+  }
+  return O;
+}
+
+/// ***********************
+/// Otimizacao
+/// ***********************
+
+// Estado de uma porta durante a otimizacao
+// MANTIDA: continua no circuito (se estiver viva no final); as demais sao os
+// motivos de remocao
+static const int8_t MANTIDA = -1;
+
+void otimizarNetlist(const Netlist& N, std::vector<uint8_t>& Tipos,
+                     std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                     std::vector<uint32_t>& Saidas, RelatorioOtimizacao& R)
+{
+  const unsigned NI = N.getNumInputs(), NP = N.getNumPorts(), NS = N.getNumSinais();
+  R.clear();
+  R.NportsAntes = NP;
+  R.novaId.assign(NP, 0);
+
+  ///1) PORTAS VIVAS NO CIRCUITO ORIGINAL (alcancam alguma saida)
+  vector<uint32_t> viva;
+  N.marcarObservaveis(viva);
+  vector<uint32_t> pilha;
+
+  ///2) e 3) SIMPLIFICACOES E HASH ESTRUTURAL, EM ORDEM TOPOLOGICA
+  // rep[s]: o sinal (do circuito original) que substitui o sinal s
+  // Aponta sempre para uma entrada ou para uma porta mantida
+  vector<uint32_t> rep(NS);
+  for (unsigned s=0; s<NS; s++) rep[s] = s;
+  vector<int8_t> estado(NP, int8_t(motivoRemocao::MORTA));
+  // A porta mantida p tem o tipo tipo[p] e as entradas (sinais do circuito
+  // original) entradas[ini[p]] a entradas[ini[p]+num[p]-1]
+  vector<uint8_t> tipo(NP);
+  vector<uint32_t> ini(NP, 0), num(NP, 0), entradas;
+  entradas.reserve(N.getNumPorts()*2);
+  // simplificavel[p] != 0 se a porta mantida p estah fora de lacos
+  vector<uint8_t> simplificavel(NP, 0);
+  // Tabela de espalhamento (enderecamento aberto) das portas mantidas fora de
+  // lacos: guarda p+1 (0: posicao livre)
+  size_t tamTabela = 16;
+  while (tamTabela < 2*size_t(NP)) tamTabela *= 2;
+  vector<uint32_t> tabela(tamTabela, 0);
+  vector<uint32_t> in;
+
+  for (unsigned c=0; c<N.getNumComponentes(); c++)
+  {
+    const bool ciclica = N.getCiclica(c);
+    const unsigned* portas = N.getPortasComponente(c);
+    for (unsigned k=0; k<N.getTamanhoComponente(c); k++)
+    {
+      unsigned p = portas[k];
+      if (!viva[NI+p]) continue;
+
+      // As entradas, jah substituidas
+      in.clear();
+      const unsigned* orig = N.getFanin(p);
+      for (unsigned j=0; j<N.getNumFanin(p); j++) in.push_back(rep[orig[j]]);
+      tipoPorta T = N.getTipo(p);
+      bool alterada = false;
+      unsigned eliminadas = 0;
+
+      if (!ciclica)
+      {
+        // Todas as portas sao comutativas: a ordem das entradas nao importa
+        sort(in.begin(), in.end());
+        if (T==tipoPorta::AN || T==tipoPorta::NA || T==tipoPorta::OR || T==tipoPorta::NO)
+        {
+          // x.x = x e x+x = x, inclusive para x=UNDEF
+          eliminadas = in.size();
+          in.erase(unique(in.begin(), in.end()), in.end());
+          eliminadas -= in.size();
+          alterada = (eliminadas > 0);
+          if (in.size() == 1)
+          {
+            if (T==tipoPorta::AN || T==tipoPorta::OR)
+            {
+              rep[NI+p] = in[0];
+              estado[p] = int8_t(motivoRemocao::SIMPLIFICADA);
+              continue;
+            }
+            T = tipoPorta::NT;
+          }
+        }
+        // Dupla negacao: NT(NT(x)) = x, inclusive para x=UNDEF
+        if (T==tipoPorta::NT && in[0]>=NI)
+        {
+          unsigned q = in[0]-NI;
+          if (simplificavel[q] && tipoPorta(tipo[q])==tipoPorta::NT)
+          {
+            rep[NI+p] = entradas[ini[q]];
+            estado[p] = int8_t(motivoRemocao::SIMPLIFICADA);
+            continue;
+          }
+        }
+        // Hash estrutural: procura uma porta mantida com o mesmo tipo e entradas
+        size_t pos = espalharSinais(in.data(), in.size(), uint8_t(T)) & (tamTabela-1);
+        bool achou = false;
+        while (tabela[pos] != 0)
+        {
+          unsigned q = tabela[pos]-1;
+          if (tipo[q]==uint8_t(T) && num[q]==in.size() &&
+              equal(in.begin(), in.end(), entradas.begin()+ini[q]))
+          {
+            rep[NI+p] = NI+q;
+            estado[p] = int8_t(motivoRemocao::FUNDIDA);
+            achou = true;
+            break;
+          }
+          pos = (pos+1) & (tamTabela-1);
+        }
+        if (achou) continue;
+        tabela[pos] = p+1;
+        simplificavel[p] = 1;
+      }
+
+      // A porta eh mantida
+      estado[p] = MANTIDA;
+      tipo[p] = uint8_t(T);
+      ini[p] = entradas.size();
+      num[p] = in.size();
+      entradas.insert(entradas.end(), in.begin(), in.end());
+      if (alterada)
+      {
+        R.alteradas++;
+        R.entradasRemovidas += eliminadas;
+      }
+    }
+  }
+
+  ///1) DE NOVO: PORTAS MANTIDAS QUE CONTINUAM VIVAS
+  // Algumas portas mantidas podem ter perdido todos os seus usos (ex.: a NT
+  // interna de uma dupla negacao)
+  viva.assign(NS, 0);
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    unsigned s = rep[N.getSaida(j)];
+    if (!viva[s]) {viva[s] = 1; pilha.push_back(s);}
+  }
+  while (!pilha.empty())
+  {
+    unsigned s = pilha.back();
+    pilha.pop_back();
+    if (s < NI) continue;
+    unsigned p = s-NI;
+    for (unsigned j=0; j<num[p]; j++)
+    {
+      unsigned e = entradas[ini[p]+j];
+      if (!viva[e]) {viva[e] = 1; pilha.push_back(e);}
+    }
+  }
+
+  ///NUMERACAO FINAL E RELATORIO
+  unsigned Nmantidas = 0;
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (estado[p]==MANTIDA && viva[NI+p]) R.novaId[p] = ++Nmantidas;
+  }
+  // Converte um sinal do circuito original para o do circuito otimizado
+  auto novoSinal = [&](uint32_t s) {return s<NI ? s : NI+R.novaId[s-NI]-1;};
+  // Converte um sinal do circuito original para uma id (convencao de Circuito)
+  auto idOrig = [&](uint32_t s) {return s<NI ? -int(s)-1 : int(s-NI)+1;};
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (R.novaId[p] != 0) continue;
+    PortaRemovida P;
+    P.IdPort = p+1;
+    P.Motivo = motivoRemocao::MORTA;
+    P.IdOrig = 0;
+    // Uma porta substituida por um sinal que nao ficou no circuito nao tinha
+    // mais nenhum uso: conta como morta
+    unsigned s = rep[NI+p];
+    if (estado[p]!=MANTIDA && estado[p]!=int8_t(motivoRemocao::MORTA) &&
+        (s<NI || R.novaId[s-NI]!=0))
+    {
+      P.Motivo = motivoRemocao(estado[p]);
+      P.IdOrig = idOrig(s);
+    }
+    switch (P.Motivo)
+    {
+    case motivoRemocao::MORTA: R.mortas++; break;
+    case motivoRemocao::SIMPLIFICADA: R.simplificadas++; break;
+    case motivoRemocao::FUNDIDA: R.fundidas++; break;
+    }
+    R.removidas.push_back(P);
+  }
+
+  ///NETLIST OTIMIZADA
+  Tipos.clear();
+  FaninIni.assign(1, 0);
+  Fanin.clear();
+  Saidas.clear();
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (R.novaId[p] == 0) continue;
+    Tipos.push_back(tipo[p]);
+    for (unsigned j=0; j<num[p]; j++) Fanin.push_back(novoSinal(entradas[ini[p]+j]));
+    FaninIni.push_back(Fanin.size());
+  }
+  for (unsigned j=0; j<N.getNumOutputs(); j++) Saidas.push_back(novoSinal(rep[N.getSaida(j)]));
+  // O circuito precisa de ao menos uma porta
+  Netlist::garantirPorta(NI, Tipos, FaninIni, Fanin, Saidas);
+  R.NportsDepois = Tipos.size();
+}
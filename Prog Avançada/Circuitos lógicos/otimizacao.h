@@ -0,0 +1,86 @@
+#ifndef _OTIMIZACAO_H_
+#define _OTIMIZACAO_H_
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "netlist.h"
+
+/// ###########################################################################
+/// OTIMIZACAO DA NETLIST
+/// Produz uma netlist equivalente (mesmas saidas para qualquer combinacao de
+/// entradas, inclusive UNDEF, e mesmo comportamento sequencial) com menos portas:
+///
+/// 1) Portas mortas: as portas que nao alcancam nenhuma saida do circuito sao
+///    removidas (inclusive as que ficam sem uso depois dos passos 2 e 3)
+/// 2) Simplificacoes locais, validas na logica de 3 estados:
+///    - entradas repetidas de AN, NA, OR e NO sao eliminadas (x.x = x, x+x = x,
+///      inclusive para x=UNDEF); se sobrar uma soh entrada, AN(x) e OR(x) sao
+///      substituidas por x e NA(x) e NO(x) viram NT(x)
+///    - dupla negacao: NT(NT(x)) eh substituida por x
+///    - as entradas de todas as portas sao ordenadas (todas as portas sao
+///      comutativas)
+///    XO(x,x) e AN(x,NT(x)) NAO sao constantes quando x=UNDEF: ficam como estao.
+///    O formato do circuito nao tem sinais constantes, de modo que nao ha
+///    constantes a propagar
+/// 3) Hash estrutural: portas com o mesmo tipo e as mesmas entradas (jah
+///    simplificadas) sao fundidas em uma soh
+///
+/// Os passos 2 e 3 sao feitos em uma unica passada, em ordem topologica: as
+/// entradas de cada porta jah estao simplificadas quando ela eh examinada, de modo
+/// que as fusoes se propagam das entradas para as saidas. As portas em lacos de
+/// realimentacao (componentes ciclicas) nao sao simplificadas nem fundidas, pois
+/// guardam estado; apenas as suas entradas que vem de fora do laco sao renomeadas.
+/// ###########################################################################
+
+// O motivo da remocao de uma porta
+enum class motivoRemocao : uint8_t {
+  MORTA=0,         // nao alcanca nenhuma saida do circuito
+  SIMPLIFICADA=1,  // substituida por um sinal equivalente (ex.: NT(NT(x)) -> x)
+  FUNDIDA=2        // identica (mesmo tipo e entradas) a outra porta
+};
+
+// Uma porta removida pela otimizacao
+struct PortaRemovida {
+  // A id da porta no circuito original
+  int IdPort;
+  motivoRemocao Motivo;
+  // A id (no circuito original) do sinal que substitui a porta, ou 0 se a porta
+  // estava morta
+  int IdOrig;
+};
+
+// O relatorio de uma otimizacao
+struct RelatorioOtimizacao {
+  // Numero de portas antes e depois da otimizacao
+  unsigned NportsAntes, NportsDepois;
+  // Numero de portas removidas por motivo
+  unsigned mortas, simplificadas, fundidas;
+  // Numero de portas mantidas que foram alteradas (entradas repetidas
+  // eliminadas ou NA/NO transformada em NT) e total de entradas eliminadas
+  unsigned alteradas, entradasRemovidas;
+  // As portas removidas, em ordem crescente de id
+  std::vector<PortaRemovida> removidas;
+  // novaId[IdPort-1]: a id da porta no circuito otimizado, ou 0 se foi removida
+  std::vector<int> novaId;
+
+  RelatorioOtimizacao() {clear();}
+  void clear();
+
+  // Imprime o resumo e, se Lista for true, a lista das portas removidas
+  std::ostream& imprimir(std::ostream& O=std::cout, bool Lista=true) const;
+};
+
+// Otimiza a netlist N (que deve estar montada)
+// O resultado eh uma netlist plana (como no formato binario, ver netlistbin.h),
+// com o mesmo numero de entradas e de saidas de N: NP portas com os tipos Tipos,
+// as entradas em formato CSR (FaninIni e Fanin) e os sinais das saidas (Saidas)
+// As portas mantidas conservam a sua ordem relativa
+// Se todas as portas forem removidas (todas as saidas vem de entradas), eh criada
+// uma porta AN(x,x), que passa a ser a origem da primeira saida (o circuito deve
+// ter ao menos uma porta)
+void otimizarNetlist(const Netlist& N, std::vector<uint8_t>& Tipos,
+                     std::vector<uint32_t>& FaninIni, std::vector<uint32_t>& Fanin,
+                     std::vector<uint32_t>& Saidas, RelatorioOtimizacao& R);
+
+#endif // _OTIMIZACAO_H_
@@ -1,3 +1,4 @@
+#include <charconv>
 #include <fstream>
 #include "port.h"
 
@@ -191,6 +192,59 @@ bool Port::ler(std::istream& ArqI)
   return true;
 }
 
+// Funcao auxiliar que avanca P sobre espacos e tabulacoes (sem passar de Fim)
+static inline void pularEspacos(const char*& P, const char* Fim)
+{
+  while (P<Fim && (*P==' ' || *P=='\t' || *P=='\r')) P++;
+}
+
+// Leh uma porta de um buffer de texto (ver port.h)
+bool Port::ler(const char*& P, const char* Fim, const char*& Erro)
+{
+  unsigned Nin;
+
+  pularEspacos(P, Fim);
+  std::from_chars_result r = std::from_chars(P, Fim, Nin);
+  if (r.ec != std::errc())
+  {
+    Erro = "numero de entradas da porta esperado";
+    return false;
+  }
+  if (!validNumInputs(Nin))
+  {
+    Erro = "numero de entradas invalido para o tipo de porta";
+    return false;
+  }
+  P = r.ptr;
+  pularEspacos(P, Fim);
+  if (P==Fim || *P != ':')
+  {
+    Erro = "':' esperado";
+    return false;
+  }
+  P++;
+  id_in.resize(Nin);
+  for (unsigned i=0; i<Nin; i++)
+  {
+    pularEspacos(P, Fim);
+    r = std::from_chars(P, Fim, id_in[i]);
+    if (r.ec != std::errc())
+    {
+      Erro = "id de entrada da porta esperada";
+      id_in.clear();
+      return false;
+    }
+    if (id_in[i] == 0)
+    {
+      Erro = "id de entrada da porta invalida (0)";
+      id_in.clear();
+      return false;
+    }
+    P = r.ptr;
+  }
+  return true;
+}
+
 // Imprime a porta na ostrem ArqO (cout ou uma stream de arquivo, tanto faz)
 // Imprime:
 // - a string com o nome da porta + ESPACO
@@ -401,8 +455,8 @@ std::string Port_NXOR::getName()const{
 void Port_NXOR::simular(const std::vector<bool3S>& in_port){
 
     out_port = in_port.at(0);
-    for(unsigned i=1; i<getNumInputs()-1; i++){
-        out_port = out_port ^ in_port.at(i); //enxugar escrita &=
+    for(unsigned i=1; i<getNumInputs(); i++){
+        out_port ^= in_port.at(i);
     }
     out_port = ~out_port;
 }
@@ -140,6 +140,16 @@ public:
   // apropriado para o tipo de porta.
   bool ler(std::istream& ArqI);
 
+  // Leh uma porta de um buffer de texto, no mesmo formato de ler(istream):
+  // o numero de entradas, ':' e as ids das entradas, comecando em P e sem passar
+  // de Fim (em geral, o fim da linha). Usado pela leitura rapida de circuitos
+  // (leitorcircuito.h), que percorre o arquivo mapeado em memoria, sem streams
+  // Faz os mesmos testes (validNumInputs e ids != 0)
+  // Retorna true se tudo OK, com P apontando para o caractere seguinte aa ultima id
+  // Se houve erro, retorna false, com P apontando para o caractere em que o erro
+  // foi detectado e Erro apontando para uma mensagem que descreve o erro
+  bool ler(const char*& P, const char* Fim, const char*& Erro);
+
   // Imprime a porta na ostrem ArqO (cout ou uma stream de arquivo, tanto faz)
   // Imprime:
   // - a string com o nome da porta + ESPACO
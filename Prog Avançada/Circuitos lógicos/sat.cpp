@@ -0,0 +1,494 @@
+#include <algorithm>
+#include "sat.h"
+
+using namespace std;
+
+// Marca, no campo de LBD, uma clausula aprendida que vai ser descartada
+static const uint32_t DESCARTADA = 0xFFFFFFFF;
+// Numero de conflitos da unidade da sequencia de reinicios
+static const unsigned long long UNIDADE_REINICIO = 100;
+// Numero inicial de clausulas aprendidas antes da primeira reducao
+static const size_t MIN_APRENDIDAS = 2000;
+// Fator de decaimento da atividade das variaveis
+static const double DECAIMENTO = 0.95;
+
+// O I-esimo termo (I a partir de 0) da sequencia de Luby: 1 1 2 1 1 2 4 1 1 2 ...
+static unsigned long long luby(unsigned long long I)
+{
+  unsigned long long tam = 1, exp = 0;
+  while (tam < I+1)
+  {
+    tam = 2*tam+1;
+    exp++;
+  }
+  while (tam-1 != I)
+  {
+    tam = (tam-1)/2;
+    exp--;
+    I = I % tam;
+  }
+  return 1ull << exp;
+}
+
+SolverSat::SolverSat(): mem(), aprendidas(), vigias(), valor(), nivel(), razao(), fase(),
+  trilha(), inicioNivel(), propagados(0), atividade(), incremento(1.0), heap(), posHeap(),
+  marcada(), aprendida(), marcadas(), ok(true), conflitos(0), decisoes(0), propagacoes(0)
+{
+}
+
+void SolverSat::clear()
+{
+  mem.clear();
+  aprendidas.clear();
+  vigias.clear();
+  valor.clear();
+  nivel.clear();
+  razao.clear();
+  fase.clear();
+  trilha.clear();
+  inicioNivel.clear();
+  propagados = 0;
+  atividade.clear();
+  incremento = 1.0;
+  heap.clear();
+  posHeap.clear();
+  marcada.clear();
+  ok = true;
+  conflitos = decisoes = propagacoes = 0;
+}
+
+/// ***********************
+/// Construcao da formula
+/// ***********************
+
+unsigned SolverSat::novaVariavel()
+{
+  unsigned V = valor.size();
+  valor.push_back(2);
+  nivel.push_back(0);
+  razao.push_back(NENHUMA);
+  fase.push_back(0);
+  atividade.push_back(0.0);
+  posHeap.push_back(-1);
+  marcada.push_back(0);
+  vigias.resize(2*valor.size());
+  inserirHeap(V);
+  return V;
+}
+
+bool SolverSat::adicionarClausula(std::vector<uint32_t> C)
+{
+  if (!ok) return false;
+  retroceder(0);
+
+  // Literais repetidos, literais jah falsos no nivel 0 e clausulas jah satisfeitas
+  sort(C.begin(), C.end());
+  C.erase(unique(C.begin(), C.end()), C.end());
+  unsigned n = 0;
+  for (unsigned k=0; k<C.size(); k++)
+  {
+    // x+~x: sempre satisfeita
+    if (k+1<C.size() && C[k+1]==negar(C[k])) return true;
+    uint8_t v = valorLiteral(C[k]);
+    if (v == 1) return true;
+    if (v == 2) C[n++] = C[k];
+  }
+  C.resize(n);
+
+  if (C.empty())
+  {
+    ok = false;
+    return false;
+  }
+  if (C.size() == 1)
+  {
+    atribuir(C[0], NENHUMA);
+    if (propagar() != NENHUMA) ok = false;
+    return ok;
+  }
+  guardarClausula(C, 0);
+  return true;
+}
+
+uint32_t SolverSat::guardarClausula(const std::vector<uint32_t>& C, uint32_t Lbd)
+{
+  uint32_t pos = mem.size();
+  mem.push_back(C.size());
+  mem.push_back(Lbd);
+  mem.insert(mem.end(), C.begin(), C.end());
+  // A clausula eh visitada quando um dos dois primeiros literais fica falso
+  Vigia v0 = {pos, C[1]}, v1 = {pos, C[0]};
+  vigias[negar(C[0])].push_back(v0);
+  vigias[negar(C[1])].push_back(v1);
+  return pos;
+}
+
+size_t SolverSat::getNumClausulas() const
+{
+  size_t n = 0;
+  for (size_t C=0; C<mem.size(); C += 2+mem[C]) n++;
+  return n;
+}
+
+/// ***********************
+/// Propagacao
+/// ***********************
+
+void SolverSat::atribuir(uint32_t L, uint32_t R)
+{
+  unsigned V = L>>1;
+  valor[V] = (L&1) ? 0 : 1;
+  nivel[V] = nivelAtual();
+  razao[V] = R;
+  trilha.push_back(L);
+}
+
+uint32_t SolverSat::propagar()
+{
+  uint32_t conflito = NENHUMA;
+  while (propagados < trilha.size())
+  {
+    // L ficou verdadeiro: as clausulas que vigiam ~L precisam de outro literal
+    uint32_t L = trilha[propagados++];
+    uint32_t falso = negar(L);
+    propagacoes++;
+    vector<Vigia>& W = vigias[L];
+    size_t i = 0, j = 0;
+    while (i < W.size())
+    {
+      Vigia w = W[i++];
+      if (valorLiteral(w.bloqueador) == 1)
+      {
+        W[j++] = w;
+        continue;
+      }
+      uint32_t n = mem[w.clausula];
+      uint32_t* c = &mem[w.clausula+2];
+      // O literal falso fica na segunda posicao
+      if (c[0] == falso) swap(c[0], c[1]);
+      Vigia nova = {w.clausula, c[0]};
+      if (c[0]!=w.bloqueador && valorLiteral(c[0])==1)
+      {
+        W[j++] = nova;
+        continue;
+      }
+      // Procura outro literal nao falso para vigiar
+      bool achou = false;
+      for (uint32_t k=2; k<n; k++)
+      {
+        if (valorLiteral(c[k]) != 0)
+        {
+          c[1] = c[k];
+          c[k] = falso;
+          vigias[negar(c[1])].push_back(nova);
+          achou = true;
+          break;
+        }
+      }
+      if (achou) continue;
+
+      // A clausula eh unitaria (c[0] eh forcado) ou estah em conflito
+      W[j++] = nova;
+      if (valorLiteral(c[0]) == 0)
+      {
+        conflito = w.clausula;
+        propagados = trilha.size();
+        while (i < W.size()) W[j++] = W[i++];
+      }
+      else atribuir(c[0], w.clausula);
+    }
+    W.resize(j);
+  }
+  return conflito;
+}
+
+/// ***********************
+/// Analise de conflitos
+/// ***********************
+
+unsigned SolverSat::analisar(uint32_t C)
+{
+  aprendida.assign(1, 0);
+  unsigned pendentes = 0;
+  uint32_t L = NENHUMA;
+  size_t pos = trilha.size();
+
+  // Resolve a clausula em conflito com as razoes dos literais do nivel atual,
+  // na ordem inversa da trilha, ateh sobrar um soh literal desse nivel (o 1UIP)
+  do
+  {
+    uint32_t n = mem[C];
+    const uint32_t* c = &mem[C+2];
+    // Na razao de L, c[0] eh o proprio L
+    for (uint32_t k=(L==NENHUMA ? 0 : 1); k<n; k++)
+    {
+      unsigned V = c[k]>>1;
+      if (marcada[V] || nivel[V]==0) continue;
+      marcada[V] = 1;
+      marcadas.push_back(V);
+      aumentarAtividade(V);
+      if (nivel[V] == nivelAtual()) pendentes++;
+      else aprendida.push_back(c[k]);
+    }
+    while (!marcada[trilha[--pos]>>1]);
+    L = trilha[pos];
+    C = razao[L>>1];
+    // Os literais do nivel atual nao ficam na clausula aprendida
+    marcada[L>>1] = 0;
+    pendentes--;
+  }
+  while (pendentes > 0);
+  aprendida[0] = negar(L);
+
+  // Minimizacao: retira os literais cuja razao soh tem literais da clausula
+  size_t j = 1;
+  for (size_t i=1; i<aprendida.size(); i++)
+  {
+    if (!redundante(aprendida[i])) aprendida[j++] = aprendida[i];
+  }
+  aprendida.resize(j);
+  for (unsigned V : marcadas) marcada[V] = 0;
+  marcadas.clear();
+
+  // O nivel de retrocesso eh o maior nivel dos demais literais, cujo literal
+  // fica na segunda posicao (para ser vigiado)
+  unsigned retrocesso = 0;
+  for (size_t i=1; i<aprendida.size(); i++)
+  {
+    if (nivel[aprendida[i]>>1] > retrocesso)
+    {
+      retrocesso = nivel[aprendida[i]>>1];
+      swap(aprendida[1], aprendida[i]);
+    }
+  }
+  return retrocesso;
+}
+
+bool SolverSat::redundante(uint32_t L) const
+{
+  uint32_t R = razao[L>>1];
+  if (R == NENHUMA) return false;
+  const uint32_t* c = &mem[R+2];
+  for (uint32_t k=1; k<mem[R]; k++)
+  {
+    unsigned V = c[k]>>1;
+    if (!marcada[V] && nivel[V]>0) return false;
+  }
+  return true;
+}
+
+void SolverSat::retroceder(unsigned Nivel)
+{
+  if (nivelAtual() <= Nivel) return;
+  for (size_t k=trilha.size(); k>inicioNivel[Nivel]; k--)
+  {
+    unsigned V = trilha[k-1]>>1;
+    fase[V] = valor[V];
+    valor[V] = 2;
+    razao[V] = NENHUMA;
+    inserirHeap(V);
+  }
+  trilha.resize(inicioNivel[Nivel]);
+  inicioNivel.resize(Nivel);
+  propagados = trilha.size();
+}
+
+void SolverSat::reduzirAprendidas()
+{
+  // No nivel 0 nenhuma razao eh necessaria (as variaveis do nivel 0 nunca sao
+  // analisadas), de modo que qualquer clausula pode ser descartada
+  for (uint32_t L : trilha) razao[L>>1] = NENHUMA;
+
+  // Mantem as de LBD <= 2 e a melhor metade das demais
+  vector<uint32_t> candidatas;
+  for (uint32_t C : aprendidas)
+  {
+    if (mem[C+1] > 2) candidatas.push_back(C);
+  }
+  sort(candidatas.begin(), candidatas.end(), [&](uint32_t A, uint32_t B)
+       {return mem[A+1]<mem[B+1] || (mem[A+1]==mem[B+1] && mem[A]<mem[B]);});
+  for (size_t k=candidatas.size()/2; k<candidatas.size(); k++) mem[candidatas[k]+1] = DESCARTADA;
+
+  // Compacta mem e refaz as listas de vigias, com os mesmos literais vigiados
+  vector<uint32_t> novo;
+  novo.reserve(mem.size());
+  aprendidas.clear();
+  for (auto& W : vigias) W.clear();
+  for (size_t C=0; C<mem.size(); C += 2+mem[C])
+  {
+    uint32_t n = mem[C], lbd = mem[C+1];
+    const uint32_t* c = &mem[C+2];
+    if (lbd == DESCARTADA) continue;
+    bool satisfeita = false;
+    for (uint32_t k=0; k<n && !satisfeita; k++) satisfeita = (valorLiteral(c[k]) == 1);
+    if (satisfeita) continue;
+    uint32_t pos = novo.size();
+    novo.insert(novo.end(), mem.begin()+C, mem.begin()+C+2+n);
+    if (lbd > 0) aprendidas.push_back(pos);
+    Vigia v0 = {pos, c[1]}, v1 = {pos, c[0]};
+    vigias[negar(c[0])].push_back(v0);
+    vigias[negar(c[1])].push_back(v1);
+  }
+  mem.swap(novo);
+}
+
+/// ***********************
+/// Heap de atividade
+/// ***********************
+
+void SolverSat::subirHeap(unsigned I)
+{
+  uint32_t V = heap[I];
+  while (I > 0)
+  {
+    unsigned pai = (I-1)/2;
+    if (atividade[heap[pai]] >= atividade[V]) break;
+    heap[I] = heap[pai];
+    posHeap[heap[I]] = I;
+    I = pai;
+  }
+  heap[I] = V;
+  posHeap[V] = I;
+}
+
+void SolverSat::descerHeap(unsigned I)
+{
+  uint32_t V = heap[I];
+  const unsigned n = heap.size();
+  for (;;)
+  {
+    unsigned filho = 2*I+1;
+    if (filho >= n) break;
+    if (filho+1<n && atividade[heap[filho+1]]>atividade[heap[filho]]) filho++;
+    if (atividade[heap[filho]] <= atividade[V]) break;
+    heap[I] = heap[filho];
+    posHeap[heap[I]] = I;
+    I = filho;
+  }
+  heap[I] = V;
+  posHeap[V] = I;
+}
+
+void SolverSat::inserirHeap(uint32_t V)
+{
+  if (posHeap[V] >= 0) return;
+  heap.push_back(V);
+  subirHeap(heap.size()-1);
+}
+
+uint32_t SolverSat::retirarHeap()
+{
+  uint32_t V = heap[0];
+  uint32_t ultimo = heap.back();
+  heap.pop_back();
+  posHeap[V] = -1;
+  if (!heap.empty())
+  {
+    heap[0] = ultimo;
+    posHeap[ultimo] = 0;
+    descerHeap(0);
+  }
+  return V;
+}
+
+void SolverSat::aumentarAtividade(uint32_t V)
+{
+  atividade[V] += incremento;
+  if (atividade[V] > 1e100)
+  {
+    // Reescala todas as atividades (a ordem nao muda)
+    for (double& A : atividade) A *= 1e-100;
+    incremento *= 1e-100;
+  }
+  if (posHeap[V] >= 0) subirHeap(posHeap[V]);
+}
+
+/// ***********************
+/// Resolucao
+/// ***********************
+
+resultadoSat SolverSat::resolver(unsigned long long MaxConflitos)
+{
+  if (!ok) return resultadoSat::INSATISFAZIVEL;
+  retroceder(0);
+  if (propagar() != NENHUMA)
+  {
+    ok = false;
+    return resultadoSat::INSATISFAZIVEL;
+  }
+
+  const unsigned long long inicio = conflitos;
+  unsigned long long reinicios = 0, conflitosReinicio = 0;
+  unsigned long long limiteReinicio = UNIDADE_REINICIO*luby(0);
+  size_t limiteAprendidas = max(MIN_APRENDIDAS, getNumClausulas()/3);
+  vector<unsigned> niveis;
+
+  for (;;)
+  {
+    uint32_t C = propagar();
+    if (C != NENHUMA)
+    {
+      ///CONFLITO
+      conflitos++;
+      conflitosReinicio++;
+      if (nivelAtual() == 0)
+      {
+        ok = false;
+        return resultadoSat::INSATISFAZIVEL;
+      }
+      unsigned retrocesso = analisar(C);
+      retroceder(retrocesso);
+      if (aprendida.size() == 1) atribuir(aprendida[0], NENHUMA);
+      else
+      {
+        // LBD: numero de niveis distintos na clausula
+        niveis.clear();
+        for (uint32_t L : aprendida) niveis.push_back(nivel[L>>1]);
+        sort(niveis.begin(), niveis.end());
+        uint32_t lbd = unique(niveis.begin(), niveis.end()) - niveis.begin();
+        uint32_t R = guardarClausula(aprendida, lbd);
+        aprendidas.push_back(R);
+        atribuir(aprendida[0], R);
+      }
+      incremento /= DECAIMENTO;
+      continue;
+    }
+
+    if (MaxConflitos>0 && conflitos-inicio>=MaxConflitos)
+    {
+      retroceder(0);
+      return resultadoSat::INDEFINIDO;
+    }
+
+    ///REINICIO
+    if (conflitosReinicio >= limiteReinicio)
+    {
+      retroceder(0);
+      reinicios++;
+      conflitosReinicio = 0;
+      limiteReinicio = UNIDADE_REINICIO*luby(reinicios);
+      if (aprendidas.size() >= limiteAprendidas)
+      {
+        reduzirAprendidas();
+        limiteAprendidas += limiteAprendidas/10;
+      }
+    }
+
+    ///DECISAO
+    uint32_t V = NENHUMA;
+    while (!heap.empty())
+    {
+      uint32_t X = retirarHeap();
+      if (valor[X] == 2)
+      {
+        V = X;
+        break;
+      }
+    }
+    // Todas as variaveis tem valor: a atribuicao satisfaz todas as clausulas
+    if (V == NENHUMA) return resultadoSat::SATISFAZIVEL;
+    decisoes++;
+    inicioNivel.push_back(trilha.size());
+    atribuir(literal(V, fase[V]==0), NENHUMA);
+  }
+}
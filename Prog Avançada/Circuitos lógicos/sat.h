@@ -0,0 +1,163 @@
+#ifndef _SAT_H_
+#define _SAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// ###########################################################################
+/// RESOLVEDOR SAT (CDCL)
+/// Decide se uma formula na forma normal conjuntiva (um E de clausulas, cada
+/// clausula um OU de literais) pode ser satisfeita, e fornece uma atribuicao que
+/// a satisfaz. Eh um resolvedor pequeno, do tipo "conflict-driven clause
+/// learning":
+/// - propagacao unitaria com dois literais vigiados por clausula
+/// - em cada conflito, aprende a clausula do primeiro ponto de implicacao unica
+///   (1UIP), minimizada, e retrocede ateh o nivel em que ela se torna unitaria
+/// - escolhe a variavel de decisao pela atividade (VSIDS), com a polaridade da
+///   ultima atribuicao de cada variavel
+/// - reinicia a busca segundo a sequencia de Luby e descarta periodicamente
+///   metade das clausulas aprendidas (as de maior LBD)
+///
+/// As variaveis sao numeradas de 0 a getNumVariaveis()-1; um literal eh 2*V+C,
+/// em que C=1 indica a variavel negada (como as arestas do Aig).
+/// ###########################################################################
+
+// O resultado de SolverSat::resolver
+enum class resultadoSat : uint8_t {
+  SATISFAZIVEL=0,
+  INSATISFAZIVEL=1,
+  INDEFINIDO=2      // o limite de conflitos foi atingido
+};
+
+class SolverSat {
+private:
+  // Indica "nenhuma clausula" (variavel de decisao ou sem atribuicao)
+  static constexpr uint32_t NENHUMA = 0xFFFFFFFF;
+
+  // Uma clausula vigiada pelo literal L: a clausula e um literal dela (se o
+  // literal jah for verdadeiro, a clausula nem precisa ser visitada)
+  struct Vigia {
+    uint32_t clausula, bloqueador;
+  };
+
+  // As clausulas, em sequencia: para a clausula que comeca na posicao C, mem[C]
+  // eh o numero de literais, mem[C+1] o LBD (0 se nao eh aprendida) e os literais
+  // estao a partir de mem[C+2]; os dois primeiros sao os vigiados
+  std::vector<uint32_t> mem;
+  // As posicoes das clausulas aprendidas em mem
+  std::vector<uint32_t> aprendidas;
+  // As clausulas vigiadas por cada literal
+  std::vector< std::vector<Vigia> > vigias;
+
+  // Atribuicao: 0 (falso), 1 (verdadeiro) ou 2 (livre) para cada variavel
+  std::vector<uint8_t> valor;
+  // O nivel de decisao e a clausula que forcou a atribuicao de cada variavel
+  std::vector<uint32_t> nivel, razao;
+  // A ultima polaridade atribuida a cada variavel
+  std::vector<uint8_t> fase;
+  // Os literais atribuidos, em ordem, e o inicio de cada nivel de decisao
+  std::vector<uint32_t> trilha, inicioNivel;
+  // Proximo literal da trilha a propagar
+  size_t propagados;
+
+  // Atividade das variaveis e a fila de prioridade (heap) das variaveis livres
+  std::vector<double> atividade;
+  double incremento;
+  std::vector<uint32_t> heap;
+  std::vector<int32_t> posHeap;  // -1 se a variavel nao estah no heap
+
+  // Auxiliares da analise de conflitos
+  std::vector<uint8_t> marcada;
+  std::vector<uint32_t> aprendida, marcadas;
+
+  // false se jah se sabe que a formula eh insatisfazivel
+  bool ok;
+  // Estatisticas
+  unsigned long long conflitos, decisoes, propagacoes;
+
+  // O valor do literal L: 0 (falso), 1 (verdadeiro) ou 2 (livre)
+  uint8_t valorLiteral(uint32_t L) const
+  {
+    uint8_t v = valor[L>>1];
+    return v==2 ? 2 : v^uint8_t(L&1);
+  }
+  unsigned nivelAtual() const {return inicioNivel.size();}
+
+  // Atribui verdadeiro ao literal L, forcado pela clausula R (NENHUMA: decisao)
+  void atribuir(uint32_t L, uint32_t R);
+  // Propaga as atribuicoes pendentes; retorna a clausula em conflito (ou NENHUMA)
+  uint32_t propagar();
+  // Analisa o conflito na clausula C: monta a clausula aprendida (em aprendida,
+  // com o literal do 1UIP na primeira posicao) e retorna o nivel de retrocesso
+  unsigned analisar(uint32_t C);
+  // true se o literal L da clausula aprendida eh implicado pelos demais
+  // (pode ser retirado da clausula)
+  bool redundante(uint32_t L) const;
+  // Desfaz as atribuicoes dos niveis maiores que Nivel
+  void retroceder(unsigned Nivel);
+  // Guarda uma clausula em mem e passa a vigia-la; retorna a sua posicao
+  uint32_t guardarClausula(const std::vector<uint32_t>& C, uint32_t Lbd);
+  // Descarta metade das clausulas aprendidas (as de maior LBD) e as clausulas
+  // jah satisfeitas no nivel 0, e compacta mem (somente no nivel 0)
+  void reduzirAprendidas();
+
+  // Operacoes do heap de atividade
+  void subirHeap(unsigned I);
+  void descerHeap(unsigned I);
+  void inserirHeap(uint32_t V);
+  uint32_t retirarHeap();
+  void aumentarAtividade(uint32_t V);
+
+public:
+  SolverSat();
+  // Descarta todas as variaveis e clausulas
+  void clear();
+
+  /// ***********************
+  /// Literais
+  /// ***********************
+
+  static uint32_t literal(unsigned V, bool Negado) {return 2*V + (Negado ? 1 : 0);}
+  static unsigned variavel(uint32_t L) {return L>>1;}
+  static uint32_t negar(uint32_t L) {return L^1;}
+
+  /// ***********************
+  /// Construcao da formula
+  /// ***********************
+
+  // Cria uma nova variavel e retorna o seu numero
+  unsigned novaVariavel();
+  // Acrescenta uma clausula (os literais devem ser de variaveis jah criadas)
+  // Retorna false se a formula passou a ser trivialmente insatisfazivel
+  bool adicionarClausula(std::vector<uint32_t> C);
+  bool adicionarClausula(uint32_t A) {return adicionarClausula(std::vector<uint32_t>{A});}
+  bool adicionarClausula(uint32_t A, uint32_t B) {return adicionarClausula(std::vector<uint32_t>{A,B});}
+  bool adicionarClausula(uint32_t A, uint32_t B, uint32_t C) {return adicionarClausula(std::vector<uint32_t>{A,B,C});}
+
+  /// ***********************
+  /// Resolucao
+  /// ***********************
+
+  // Procura uma atribuicao que satisfaca todas as clausulas
+  // Se MaxConflitos > 0, desiste (INDEFINIDO) depois desse numero de conflitos
+  // Pode ser chamada de novo depois de acrescentar clausulas
+  resultadoSat resolver(unsigned long long MaxConflitos=0);
+
+  // O valor da variavel V na atribuicao encontrada (depois de SATISFAZIVEL)
+  bool getValor(unsigned V) const {return valor[V]==1;}
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumVariaveis() const {return valor.size();}
+  // Numero de clausulas originais e aprendidas (exceto as unitarias, que viram
+  // atribuicoes no nivel 0)
+  size_t getNumClausulas() const;
+  unsigned long long getNumConflitos() const {return conflitos;}
+  unsigned long long getNumDecisoes() const {return decisoes;}
+  unsigned long long getNumPropagacoes() const {return propagacoes;}
+};
+
+#endif // _SAT_H_
@@ -0,0 +1,60 @@
+#include "sequencial.h"
+
+using namespace std;
+
+/// ***********************
+/// FonteEstimulosTexto
+/// ***********************
+
+bool FonteEstimulosTexto::proximo(vector<bool3S>& In)
+{
+  while (getline(I, linha))
+  {
+    num_linha++;
+    unsigned n = 0;
+    bool vazia = true;
+    for (unsigned k=0; k<linha.size(); k++)
+    {
+      char c = linha[k];
+      if (c==' ' || c=='\t' || c==',' || c=='\r') continue;
+      if (vazia && c=='#') break;
+      vazia = false;
+      bool3S B;
+      if (c=='T' || c=='t') B = bool3S::TRUE;
+      else if (c=='F' || c=='f') B = bool3S::FALSE;
+      else if (c=='?') B = bool3S::UNDEF;
+      else
+      {
+        erro = true;
+        return false;
+      }
+      if (n >= In.size())
+      {
+        erro = true;
+        return false;
+      }
+      In[n++] = B;
+    }
+    if (vazia) continue;
+    if (n != In.size())
+    {
+      erro = true;
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+/// ***********************
+/// DestinoSaidasTexto
+/// ***********************
+
+bool DestinoSaidasTexto::receber(unsigned long long, const vector<bool3S>& Out)
+{
+  linha.clear();
+  for (unsigned j=0; j<Out.size(); j++) linha += toChar(Out[j]);
+  linha += '\n';
+  O.write(linha.data(), linha.size());
+  return O.good();
+}
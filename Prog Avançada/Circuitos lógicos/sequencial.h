@@ -0,0 +1,71 @@
+#ifndef _SEQUENCIAL_H_
+#define _SEQUENCIAL_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bool3S.h"
+
+/// ###########################################################################
+/// FONTES DE ESTIMULOS E DESTINOS DE SAIDAS DA SIMULACAO SEQUENCIAL
+/// Usadas por Circuito::simularSequencia: a cada ciclo de relogio, a fonte
+/// fornece os valores das entradas do circuito e o destino recebe os valores
+/// das saidas. Os vetores sao alocados uma unica vez pelo simulador e reusados
+/// em todos os ciclos; as implementacoes nao devem guardar referencias a eles.
+/// ###########################################################################
+
+// Fonte dos valores das entradas, um vetor por ciclo
+class FonteEstimulos {
+public:
+  virtual ~FonteEstimulos() {}
+  // Preenche In (jah dimensionado com o numero de entradas do circuito) com os
+  // valores das entradas do proximo ciclo
+  // Retorna false se nao houver mais ciclos (ou se houver erro)
+  virtual bool proximo(std::vector<bool3S>& In) = 0;
+};
+
+// Destino dos valores das saidas, um vetor por ciclo
+class DestinoSaidas {
+public:
+  virtual ~DestinoSaidas() {}
+  // Recebe os valores das saidas do circuito no ciclo Ciclo (0, 1, 2, ...)
+  // Retorna false para interromper a simulacao
+  virtual bool receber(unsigned long long Ciclo, const std::vector<bool3S>& Out) = 0;
+};
+
+// Fonte que leh os estimulos de uma stream de texto: uma linha por ciclo, com
+// um caractere por entrada do circuito (? F T, maiusculas ou minusculas)
+// Espacos, tabulacoes e virgulas entre os caracteres sao ignorados, bem como as
+// linhas vazias e as que comecam com #
+class FonteEstimulosTexto: public FonteEstimulos {
+private:
+  std::istream& I;
+  // A linha atual (reusada: nao ha alocacao depois das primeiras linhas)
+  std::string linha;
+  // Numero da ultima linha lida e se houve erro de formato
+  unsigned long long num_linha;
+  bool erro;
+public:
+  explicit FonteEstimulosTexto(std::istream& Is): I(Is), linha(), num_linha(0), erro(false) {}
+  // Retorna false no fim da stream ou se a linha tiver um caractere invalido ou
+  // um numero de valores diferente do numero de entradas (nesse caso, getErro()==true)
+  bool proximo(std::vector<bool3S>& In) override;
+
+  bool getErro() const {return erro;}
+  unsigned long long getNumLinha() const {return num_linha;}
+};
+
+// Destino que escreve as saidas em uma stream de texto: uma linha por ciclo,
+// com um caractere (? F T) por saida do circuito
+class DestinoSaidasTexto: public DestinoSaidas {
+private:
+  std::ostream& O;
+  // A linha atual (reusada: nao ha alocacao depois da primeira linha)
+  std::string linha;
+public:
+  explicit DestinoSaidasTexto(std::ostream& Os): O(Os), linha() {}
+  // Retorna false se houver erro de gravacao
+  bool receber(unsigned long long Ciclo, const std::vector<bool3S>& Out) override;
+};
+
+#endif // _SEQUENCIAL_H_